@@ -166,8 +166,13 @@ protected:
     //------------------------------------------------------------------------------------
     virtual void onSwapChainAboutToBeDestroyed() override
     {
-        for (auto framebuffer : swapChainFramebuffers)
-            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        // The frames in flight might still use those objects: destroy them later
+        destroyWhenRetired(
+            [this, framebuffers = swapChainFramebuffers]() {
+                for (auto framebuffer : framebuffers)
+                    vkDestroyFramebuffer(device, framebuffer, nullptr);
+            }
+        );
     }
 
 
@@ -507,7 +512,7 @@ protected:
     //------------------------------------------------------------------------------------
     void createCommandBuffers()
     {
-        commandBuffers.resize(MAX_NB_FRAMES_IN_FLIGHT);
+        commandBuffers.resize(config.nbFramesInFlight);
 
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
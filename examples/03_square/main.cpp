@@ -195,8 +195,13 @@ protected:
     //------------------------------------------------------------------------------------
     virtual void onSwapChainAboutToBeDestroyed() override
     {
-        for (auto framebuffer : swapChainFramebuffers)
-            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        // The frames in flight might still use those objects: destroy them later
+        destroyWhenRetired(
+            [this, framebuffers = swapChainFramebuffers]() {
+                for (auto framebuffer : framebuffers)
+                    vkDestroyFramebuffer(device, framebuffer, nullptr);
+            }
+        );
     }
 
 
@@ -618,11 +623,11 @@ protected:
     {
         VkDeviceSize bufferSize = sizeof(UniformBufferObject);
 
-        uniformBuffers.resize(MAX_NB_FRAMES_IN_FLIGHT);
-        uniformBuffersMemory.resize(MAX_NB_FRAMES_IN_FLIGHT);
-        uniformBuffersMapped.resize(MAX_NB_FRAMES_IN_FLIGHT);
+        uniformBuffers.resize(config.nbFramesInFlight);
+        uniformBuffersMemory.resize(config.nbFramesInFlight);
+        uniformBuffersMapped.resize(config.nbFramesInFlight);
 
-        for (size_t i = 0; i < MAX_NB_FRAMES_IN_FLIGHT; ++i)
+        for (size_t i = 0; i < config.nbFramesInFlight; ++i)
         {
             createBuffer(
                 bufferSize,
@@ -645,13 +650,13 @@ protected:
     {
         VkDescriptorPoolSize poolSize{};
         poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        poolSize.descriptorCount = static_cast<uint32_t>(MAX_NB_FRAMES_IN_FLIGHT);
+        poolSize.descriptorCount = static_cast<uint32_t>(config.nbFramesInFlight);
 
         VkDescriptorPoolCreateInfo poolInfo{};
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolInfo.poolSizeCount = 1;
         poolInfo.pPoolSizes = &poolSize;
-        poolInfo.maxSets = static_cast<uint32_t>(MAX_NB_FRAMES_IN_FLIGHT);
+        poolInfo.maxSets = static_cast<uint32_t>(config.nbFramesInFlight);
 
         if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
             throw std::runtime_error("Failed to create descriptor pool!");
@@ -664,19 +669,19 @@ protected:
     //------------------------------------------------------------------------------------
     void createDescriptorSets()
     {
-        std::vector<VkDescriptorSetLayout> layouts(MAX_NB_FRAMES_IN_FLIGHT, descriptorSetLayout);
+        std::vector<VkDescriptorSetLayout> layouts(config.nbFramesInFlight, descriptorSetLayout);
 
         VkDescriptorSetAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         allocInfo.descriptorPool = descriptorPool;
-        allocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_NB_FRAMES_IN_FLIGHT);
+        allocInfo.descriptorSetCount = static_cast<uint32_t>(config.nbFramesInFlight);
         allocInfo.pSetLayouts = layouts.data();
 
-        descriptorSets.resize(MAX_NB_FRAMES_IN_FLIGHT);
+        descriptorSets.resize(config.nbFramesInFlight);
         if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS)
             throw std::runtime_error("Failed to allocate descriptor sets!");
 
-        for (size_t i = 0; i < MAX_NB_FRAMES_IN_FLIGHT; ++i)
+        for (size_t i = 0; i < config.nbFramesInFlight; ++i)
         {
             VkDescriptorBufferInfo bufferInfo{};
             bufferInfo.buffer = uniformBuffers[i];
@@ -704,7 +709,7 @@ protected:
     //------------------------------------------------------------------------------------
     void createCommandBuffers()
     {
-        commandBuffers.resize(MAX_NB_FRAMES_IN_FLIGHT);
+        commandBuffers.resize(config.nbFramesInFlight);
 
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -217,12 +217,18 @@ protected:
     //------------------------------------------------------------------------------------
     virtual void onSwapChainAboutToBeDestroyed() override
     {
-        for (auto framebuffer : swapChainFramebuffers)
-            vkDestroyFramebuffer(device, framebuffer, nullptr);
-
-        vkDestroyImageView(device, depthImageView, nullptr);
-        vkDestroyImage(device, depthImage, nullptr);
-        vkFreeMemory(device, depthImageMemory, nullptr);
+        // The frames in flight might still use those objects: destroy them later
+        destroyWhenRetired(
+            [this, framebuffers = swapChainFramebuffers, depthImageView = depthImageView,
+             depthImage = depthImage, depthImageMemory = depthImageMemory]() {
+                for (auto framebuffer : framebuffers)
+                    vkDestroyFramebuffer(device, framebuffer, nullptr);
+
+                vkDestroyImageView(device, depthImageView, nullptr);
+                vkDestroyImage(device, depthImage, nullptr);
+                vkFreeMemory(device, depthImageMemory, nullptr);
+            }
+        );
     }
 
 
@@ -898,11 +904,11 @@ protected:
     {
         VkDeviceSize bufferSize = sizeof(UniformBufferObject);
 
-        uniformBuffers.resize(MAX_NB_FRAMES_IN_FLIGHT);
-        uniformBuffersMemory.resize(MAX_NB_FRAMES_IN_FLIGHT);
-        uniformBuffersMapped.resize(MAX_NB_FRAMES_IN_FLIGHT);
+        uniformBuffers.resize(config.nbFramesInFlight);
+        uniformBuffersMemory.resize(config.nbFramesInFlight);
+        uniformBuffersMapped.resize(config.nbFramesInFlight);
 
-        for (size_t i = 0; i < MAX_NB_FRAMES_IN_FLIGHT; ++i)
+        for (size_t i = 0; i < config.nbFramesInFlight; ++i)
         {
             createBuffer(
                 bufferSize,
@@ -925,15 +931,15 @@ protected:
     {
         std::array<VkDescriptorPoolSize, 2> poolSizes{};
         poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        poolSizes[0].descriptorCount = static_cast<uint32_t>(MAX_NB_FRAMES_IN_FLIGHT);
+        poolSizes[0].descriptorCount = static_cast<uint32_t>(config.nbFramesInFlight);
         poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        poolSizes[1].descriptorCount = static_cast<uint32_t>(MAX_NB_FRAMES_IN_FLIGHT);
+        poolSizes[1].descriptorCount = static_cast<uint32_t>(config.nbFramesInFlight);
 
         VkDescriptorPoolCreateInfo poolInfo{};
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
         poolInfo.pPoolSizes = poolSizes.data();
-        poolInfo.maxSets = static_cast<uint32_t>(MAX_NB_FRAMES_IN_FLIGHT);
+        poolInfo.maxSets = static_cast<uint32_t>(config.nbFramesInFlight);
 
         if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
             throw std::runtime_error("Failed to create descriptor pool!");
@@ -946,19 +952,19 @@ protected:
     //------------------------------------------------------------------------------------
     void createDescriptorSets()
     {
-        std::vector<VkDescriptorSetLayout> layouts(MAX_NB_FRAMES_IN_FLIGHT, descriptorSetLayout);
+        std::vector<VkDescriptorSetLayout> layouts(config.nbFramesInFlight, descriptorSetLayout);
 
         VkDescriptorSetAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         allocInfo.descriptorPool = descriptorPool;
-        allocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_NB_FRAMES_IN_FLIGHT);
+        allocInfo.descriptorSetCount = static_cast<uint32_t>(config.nbFramesInFlight);
         allocInfo.pSetLayouts = layouts.data();
 
-        descriptorSets.resize(MAX_NB_FRAMES_IN_FLIGHT);
+        descriptorSets.resize(config.nbFramesInFlight);
         if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS)
             throw std::runtime_error("Failed to allocate descriptor sets!");
 
-        for (size_t i = 0; i < MAX_NB_FRAMES_IN_FLIGHT; ++i)
+        for (size_t i = 0; i < config.nbFramesInFlight; ++i)
         {
             VkDescriptorBufferInfo bufferInfo{};
             bufferInfo.buffer = uniformBuffers[i];
@@ -1004,7 +1010,7 @@ protected:
     //------------------------------------------------------------------------------------
     void createCommandBuffers()
     {
-        commandBuffers.resize(MAX_NB_FRAMES_IN_FLIGHT);
+        commandBuffers.resize(config.nbFramesInFlight);
 
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
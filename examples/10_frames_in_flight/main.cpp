@@ -0,0 +1,501 @@
+/*
+SPDX-FileCopyrightText: 2023 Philip Abbet
+
+SPDX-FileContributor: Philip Abbet <philip.abbet@gmail.com>
+
+SPDX-License-Identifier: MIT
+*/
+
+/** Frames in flight benchmark
+
+This example measures how much the CPU and the GPU work overlap for each supported
+number of frames in flight (see config_t::nbFramesInFlight).
+
+For each setting, the application renders a fixed number of frames where:
+    - the CPU spends a fixed amount of time "simulating" the frame
+    - the GPU clears the swap chain image a fixed number of times
+
+The GPU time of each frame is measured using timestamp queries, and the time spent by
+the CPU waiting for a frame context to be available is retrieved from the frame
+statistics of the application.
+
+The command buffers are allocated from the command pool of each frame context, which is
+reset by the application each time the frame context is reused.
+
+Note that the present mode IMMEDIATE is used if available, so the frame rate isn't
+limited by the refresh rate of the screen.
+*/
+
+
+#define KNM_VULKAN_TOOLS_IMPLEMENTATION
+#include <knm_vulkan_tools.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <array>
+
+using namespace knm::vk;
+
+
+// Number of frames rendered before starting the measurements
+const uint64_t NB_WARMUP_FRAMES = 30;
+
+// Number of frames measured for each setting
+const uint64_t NB_MEASURED_FRAMES = 300;
+
+// Time spent by the CPU on each frame (in seconds)
+const float CPU_WORK_DURATION = 0.004f;
+
+// Number of full-screen clears done by the GPU on each frame
+const uint32_t NB_GPU_CLEARS = 200;
+
+
+//----------------------------------------------------------------------------------------
+// Results of the benchmark for one setting
+//----------------------------------------------------------------------------------------
+struct results_t
+{
+    uint32_t nbFramesInFlight = 0;
+    double frameTime = 0.0;     // Average duration of a frame (in seconds)
+    double cpuTime = 0.0;       // Average time spent by the CPU not waiting (in seconds)
+    double gpuTime = 0.0;       // Average time spent by the GPU executing a frame (in seconds)
+    bool gpuTimeAvailable = false;
+};
+
+
+//----------------------------------------------------------------------------------------
+// The user must inherit from the knm::vk::Application class, and implement a few methods
+// to create its own Vulkan objects (render passes, graphics pipelines, framebuffers,
+// vertex & index buffers, command buffers, ...) and do the actual rendering.
+//----------------------------------------------------------------------------------------
+class BenchmarkApplication: public knm::vk::Application
+{
+public:
+    BenchmarkApplication(uint32_t nbFramesInFlight)
+    {
+        config.nbFramesInFlight = nbFramesInFlight;
+        config.windowTitle = "Frames in flight benchmark (" +
+                             std::to_string(nbFramesInFlight) + ")";
+
+        results.nbFramesInFlight = nbFramesInFlight;
+    }
+
+    const results_t& getResults() const
+    {
+        return results;
+    }
+
+
+protected:
+    //------------------------------------------------------------------------------------
+    // Method called after everything was initialised (window, instance, logical device,
+    // swap chain), right before entering the main loop.
+    //
+    // Use it to create your own Vulkan objects (render passes, graphics pipelines,
+    // vertex & index buffers, command buffers, ...).
+    //------------------------------------------------------------------------------------
+    virtual void createVulkanObjects() override
+    {
+        createRenderPass();
+        createCommandBuffers();
+        createQueryPool();
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called after the swap chain was created (will happen each time the window
+    // is resized and at application startup).
+    //------------------------------------------------------------------------------------
+    virtual void onSwapChainReady() override
+    {
+        createFramebuffers();
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called to retrieve the number of command buffers that need to be executed
+    // to render the current frame.
+    //------------------------------------------------------------------------------------
+    virtual uint32_t getNbCommandBuffers() const override
+    {
+        return 1;
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called to retrieve the command buffers to execute to render the current
+    // frame.
+    //------------------------------------------------------------------------------------
+    virtual void getCommandBuffers(
+        float elapsed, uint32_t imageIndex, std::vector<VkCommandBuffer>& outCommandBuffers
+    ) override
+    {
+        // The fence of the frame context was waited for, so the timestamps written the
+        // last time it was used are available
+        const frameStatistics_t& stats = getFrameStatistics();
+        bool measuring = (stats.nbFrames >= NB_WARMUP_FRAMES) &&
+                         (stats.nbFrames < NB_WARMUP_FRAMES + NB_MEASURED_FRAMES);
+
+        if (measuring)
+        {
+            results.frameTime += stats.frameTime;
+            results.cpuTime += stats.frameTime - stats.waitTime;
+
+            if (queriesWritten[currentFrame])
+                results.gpuTime += readGpuTime(currentFrame);
+        }
+
+        if (stats.nbFrames >= NB_WARMUP_FRAMES + NB_MEASURED_FRAMES)
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+
+        // Simulate some CPU work
+        auto start = std::chrono::high_resolution_clock::now();
+        while (std::chrono::duration<float, std::chrono::seconds::period>(
+                    std::chrono::high_resolution_clock::now() - start
+               ).count() < CPU_WORK_DURATION)
+        {
+        }
+
+        // Record the command buffer (no need to reset it, the command pool of the frame
+        // context was already reset)
+        recordCommandBuffer(commandBuffers[currentFrame], imageIndex);
+        queriesWritten[currentFrame] = timestampsSupported && measuring;
+
+        outCommandBuffers = { commandBuffers[currentFrame] };
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called right before the swap chain destruction (will happen each time the
+    // window is resized and at application shutdown).
+    //------------------------------------------------------------------------------------
+    virtual void onSwapChainAboutToBeDestroyed() override
+    {
+        // The frames in flight might still use those objects: destroy them later
+        destroyWhenRetired(
+            [this, framebuffers = swapChainFramebuffers]() {
+                for (auto framebuffer : framebuffers)
+                    vkDestroyFramebuffer(device, framebuffer, nullptr);
+            }
+        );
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called after exiting the main loop.
+    //------------------------------------------------------------------------------------
+    virtual void destroyVulkanObjects() override
+    {
+        // Retrieve the timestamps of the last frames
+        for (uint32_t i = 0; i < config.nbFramesInFlight; ++i)
+        {
+            if (queriesWritten[i])
+                results.gpuTime += readGpuTime(i);
+        }
+
+        results.frameTime /= NB_MEASURED_FRAMES;
+        results.cpuTime /= NB_MEASURED_FRAMES;
+        results.gpuTime /= NB_MEASURED_FRAMES;
+        results.gpuTimeAvailable = timestampsSupported;
+
+        if (queryPool != VK_NULL_HANDLE)
+            vkDestroyQueryPool(device, queryPool, nullptr);
+
+        vkDestroyRenderPass(device, renderPass, nullptr);
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Prefer VK_PRESENT_MODE_IMMEDIATE_KHR, so the frame rate isn't limited by the
+    // refresh rate of the screen
+    //------------------------------------------------------------------------------------
+    virtual VkPresentModeKHR chooseSwapPresentationMode(
+        const std::vector<VkPresentModeKHR>& availablePresentModes
+    ) const override
+    {
+        for (const auto& availablePresentMode : availablePresentModes)
+        {
+            if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
+                return availablePresentMode;
+        }
+
+        return Application::chooseSwapPresentationMode(availablePresentModes);
+    }
+
+
+protected:
+    //------------------------------------------------------------------------------------
+    // Creates a render pass with a single color attachment, cleared at the beginning
+    //------------------------------------------------------------------------------------
+    void createRenderPass()
+    {
+        VkAttachmentDescription colorAttachment{};
+        colorAttachment.format = surfaceImageFormat;
+        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        VkAttachmentReference colorAttachmentRef{};
+        colorAttachmentRef.attachment = 0;
+        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachmentRef;
+
+        VkSubpassDependency dependency{};
+        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependency.dstSubpass = 0;
+        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependency.srcAccessMask = 0;
+        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = 1;
+        renderPassInfo.pAttachments = &colorAttachment;
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+        renderPassInfo.dependencyCount = 1;
+        renderPassInfo.pDependencies = &dependency;
+
+        if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create render pass!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates one framebuffer for each image in the swap chain
+    //------------------------------------------------------------------------------------
+    void createFramebuffers()
+    {
+        swapChainFramebuffers.resize(swapChainImageViews.size());
+
+        for (size_t i = 0; i < swapChainImageViews.size(); ++i)
+        {
+            VkFramebufferCreateInfo framebufferInfo{};
+            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebufferInfo.renderPass = renderPass;
+            framebufferInfo.attachmentCount = 1;
+            framebufferInfo.pAttachments = &swapChainImageViews[i];
+            framebufferInfo.width = swapChainExtent.width;
+            framebufferInfo.height = swapChainExtent.height;
+            framebufferInfo.layers = 1;
+
+            if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &swapChainFramebuffers[i]) != VK_SUCCESS)
+                throw std::runtime_error("Failed to create framebuffer!");
+        }
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Allocates one command buffer from the command pool of each frame context
+    //------------------------------------------------------------------------------------
+    void createCommandBuffers()
+    {
+        commandBuffers.resize(config.nbFramesInFlight);
+
+        for (uint32_t i = 0; i < config.nbFramesInFlight; ++i)
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = frames[i].commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+
+            if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffers[i]) != VK_SUCCESS)
+                throw std::runtime_error("Failed to allocate command buffers!");
+        }
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates a query pool containing two timestamps for each frame-in-flight (if
+    // supported by the graphics queue)
+    //------------------------------------------------------------------------------------
+    void createQueryPool()
+    {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        timestampPeriod = properties.limits.timestampPeriod;
+        timestampsSupported = properties.limits.timestampComputeAndGraphics;
+
+        if (!timestampsSupported)
+            return;
+
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = 2 * config.nbFramesInFlight;
+
+        if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &queryPool) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create query pool!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Returns the GPU time (in seconds) measured by the timestamps of a frame-in-flight
+    //------------------------------------------------------------------------------------
+    double readGpuTime(uint32_t frame)
+    {
+        std::array<uint64_t, 2> timestamps;
+
+        vkGetQueryPoolResults(
+            device, queryPool, 2 * frame, 2, sizeof(timestamps), timestamps.data(),
+            sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT
+        );
+
+        queriesWritten[frame] = false;
+
+        return double(timestamps[1] - timestamps[0]) * timestampPeriod * 1e-9;
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Record the command buffer clearing the swap chain image at the given index several
+    // times
+    //------------------------------------------------------------------------------------
+    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+    {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+            throw std::runtime_error("Failed to begin recording command buffer!");
+
+        if (timestampsSupported)
+        {
+            vkCmdResetQueryPool(commandBuffer, queryPool, 2 * currentFrame, 2);
+            vkCmdWriteTimestamp(
+                commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool,
+                2 * currentFrame
+            );
+        }
+
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = swapChainFramebuffers[imageIndex];
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = swapChainExtent;
+
+        VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
+        renderPassInfo.clearValueCount = 1;
+        renderPassInfo.pClearValues = &clearColor;
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        // Generate some GPU load
+        VkClearRect clearRect{};
+        clearRect.rect.offset = {0, 0};
+        clearRect.rect.extent = swapChainExtent;
+        clearRect.baseArrayLayer = 0;
+        clearRect.layerCount = 1;
+
+        for (uint32_t i = 0; i < NB_GPU_CLEARS; ++i)
+        {
+            float value = float(i) / NB_GPU_CLEARS;
+
+            VkClearAttachment clearAttachment{};
+            clearAttachment.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            clearAttachment.colorAttachment = 0;
+            clearAttachment.clearValue = {{{value, 0.0f, 1.0f - value, 1.0f}}};
+
+            vkCmdClearAttachments(commandBuffer, 1, &clearAttachment, 1, &clearRect);
+        }
+
+        vkCmdEndRenderPass(commandBuffer);
+
+        if (timestampsSupported)
+        {
+            vkCmdWriteTimestamp(
+                commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool,
+                2 * currentFrame + 1
+            );
+        }
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record command buffer!");
+    }
+
+
+protected:
+    // Framebuffers (one per image in the swap chain)
+    std::vector<VkFramebuffer> swapChainFramebuffers;
+
+    // Render pass
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+
+    // Commands (one per frame-in-flight, allocated from the frame contexts)
+    std::vector<VkCommandBuffer> commandBuffers;
+
+    // Timestamps
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    bool timestampsSupported = false;
+    float timestampPeriod = 1.0f;
+    std::array<bool, MAX_NB_FRAMES_IN_FLIGHT> queriesWritten{};
+
+    // Results
+    results_t results;
+};
+
+
+
+int main(int argc, char** argv)
+{
+    std::vector<results_t> allResults;
+
+    try
+    {
+        for (uint32_t nbFramesInFlight = 1; nbFramesInFlight <= MAX_NB_FRAMES_IN_FLIGHT; ++nbFramesInFlight)
+        {
+            BenchmarkApplication app(nbFramesInFlight);
+            app.run();
+            allResults.push_back(app.getResults());
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The overlap is the fraction of the shortest of the CPU and GPU work that was done
+    // concurrently with the other one (0%: fully serialized, 100%: fully parallel)
+    std::cout << "frames in flight | frame (ms) |   FPS | CPU (ms) | GPU (ms) | overlap" << std::endl;
+
+    for (const auto& results : allResults)
+    {
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(16) << results.nbFramesInFlight << " | "
+                  << std::setw(10) << results.frameTime * 1000.0 << " | "
+                  << std::setw(5) << std::setprecision(0) << 1.0 / results.frameTime << " | "
+                  << std::setprecision(2)
+                  << std::setw(8) << results.cpuTime * 1000.0 << " | ";
+
+        if (results.gpuTimeAvailable)
+        {
+            double overlap = (results.cpuTime + results.gpuTime - results.frameTime) /
+                             std::min(results.cpuTime, results.gpuTime);
+
+            std::cout << std::setw(8) << results.gpuTime * 1000.0 << " | "
+                      << std::setw(6) << std::setprecision(0)
+                      << std::clamp(overlap, 0.0, 1.0) * 100.0 << "%" << std::endl;
+        }
+        else
+        {
+            std::cout << "     n/a |     n/a" << std::endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1075 @@
+/*
+SPDX-FileCopyrightText: 2023 Philip Abbet
+
+SPDX-FileContributor: Philip Abbet <philip.abbet@gmail.com>
+
+SPDX-License-Identifier: MIT
+*/
+
+/** Multiview example
+
+This example demonstrate stereo rendering with multiview (see config_t::nbViews): both
+eyes are rendered by a single set of draw calls.
+
+It is based on the "depth" example (without the texture), with the following changes:
+    - the color and depth targets are layered images, with one layer per eye
+    - the render pass is created with the multiview masks provided by the application
+    - the uniform buffer contains one view and one projection matrix per eye, selected
+      in the vertex shader with gl_ViewIndex
+    - after the render pass, the two layers are copied side by side into the swap chain
+      image (which is thus created with the VK_IMAGE_USAGE_TRANSFER_DST_BIT usage)
+*/
+
+
+#define KNM_VULKAN_TOOLS_IMPLEMENTATION
+#include <knm_vulkan_tools.hpp>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <cstdlib>
+#include <filesystem>
+#include <array>
+
+using namespace knm::vk;
+
+
+static std::filesystem::path EXECUTABLE_DIR;
+
+
+//----------------------------------------------------------------------------------------
+// Number of views (one per eye)
+//----------------------------------------------------------------------------------------
+const uint32_t NB_VIEWS = 2;
+
+
+//----------------------------------------------------------------------------------------
+// Distance between the eyes
+//----------------------------------------------------------------------------------------
+const float EYE_SEPARATION = 0.065f;
+
+
+//----------------------------------------------------------------------------------------
+// Contains all the informations about a vertex. The vertex shader must declare a structure
+// with the same fields of equivalent types.
+//----------------------------------------------------------------------------------------
+struct Vertex
+{
+    alignas(16) glm::vec3 pos;
+    alignas(16) glm::vec3 color;
+
+    // Describes at which rate to load data from memory throughout the vertices
+    static VkVertexInputBindingDescription getBindingDescription()
+    {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(Vertex);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescription;
+    }
+
+    // Describes how to extract vertex attributes from a chunk of vertex data
+    static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions()
+    {
+        std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[0].offset = offsetof(Vertex, pos);
+
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[1].offset = offsetof(Vertex, color);
+
+        return attributeDescriptions;
+    }
+};
+
+
+//----------------------------------------------------------------------------------------
+// Vertices of the squares to render
+//----------------------------------------------------------------------------------------
+const std::vector<Vertex> vertices = {
+    {{-0.5f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}},
+    {{0.5f, -0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+    {{0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+    {{-0.5f, 0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}},
+
+    {{-0.5f, -0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}},
+    {{0.5f, -0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}},
+    {{0.5f, 0.5f, -0.5f}, {0.0f, 0.0f, 1.0f}},
+    {{-0.5f, 0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}}
+};
+
+
+//----------------------------------------------------------------------------------------
+// Indices of the vertices to use to render the squares
+//----------------------------------------------------------------------------------------
+const std::vector<uint16_t> indices = {
+    0, 1, 2, 2, 3, 0,
+    4, 5, 6, 6, 7, 4
+};
+
+
+//----------------------------------------------------------------------------------------
+// Contains all the uniforms to send to the vertex shader, which must declare a structure
+// with the same fields of equivalent types.
+//
+// The model matrix is shared by both eyes, but each one has its own view and projection
+// matrices.
+//----------------------------------------------------------------------------------------
+struct UniformBufferObject {
+    alignas(16) glm::mat4 model;
+    alignas(16) glm::mat4 view[NB_VIEWS];
+    alignas(16) glm::mat4 proj[NB_VIEWS];
+};
+
+
+
+//----------------------------------------------------------------------------------------
+// The user must inherit from the knm::vk::Application class, and implement a few methods
+// to create its own Vulkan objects (render passes, graphics pipelines, framebuffers,
+// vertex & index buffers, command buffers, ...) and do the actual rendering.
+//----------------------------------------------------------------------------------------
+class ExampleApplication: public knm::vk::Application
+{
+public:
+    ExampleApplication()
+    {
+        config.windowTitle = "Multiview";
+        config.nbViews = NB_VIEWS;
+
+        // The rendered layers are copied into the swap chain images
+        config.swapChainImageUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+
+
+protected:
+    //------------------------------------------------------------------------------------
+    // Method called after everything was initialised (window, instance, logical device,
+    // swap chain), right before entering the main loop.
+    //
+    // Use it to create your own Vulkan objects (render passes, graphics pipelines,
+    // vertex & index buffers, command buffers, ...).
+    //------------------------------------------------------------------------------------
+    virtual void createVulkanObjects() override
+    {
+        createRenderPass();
+        createDescriptorSetLayout();
+        createGraphicsPipeline();
+
+        createCommandPool();
+
+        createVertexBuffer();
+        createIndexBuffer();
+        createUniformBuffers();
+
+        createDescriptorPool();
+        createDescriptorSets();
+        createCommandBuffers();
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called after the swap chain was created (will happen each time the window
+    // is resized and at application startup).
+    //
+    // Use it to create your own Vulkan objects (like the framebuffers) that depends on
+    // the swap chain (ie. the dimensions and number of its images).
+    //------------------------------------------------------------------------------------
+    virtual void onSwapChainReady() override
+    {
+        // Each eye is displayed on one half of the window
+        eyeExtent = { std::max(swapChainExtent.width / NB_VIEWS, 1u), swapChainExtent.height };
+
+        createColorResources();
+        createDepthResources();
+        createFramebuffers();
+    }
+
+
+    //--------------------------------------------------------------------------------
+    // Method called to retrieve the number of command buffers that need to be executed
+    // to render the current frame.
+    //--------------------------------------------------------------------------------
+    virtual uint32_t getNbCommandBuffers() const override
+    {
+        return 1;
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called to retrieve the command buffers to execute to render the current
+    // frame.
+    //------------------------------------------------------------------------------------
+    virtual void getCommandBuffers(
+        float elapsed, uint32_t imageIndex, std::vector<VkCommandBuffer>& outCommandBuffers
+    ) override
+    {
+        // Update the UBO
+        updateUniformBuffer(currentFrame);
+
+        // Record the command buffer
+        vkResetCommandBuffer(commandBuffers[currentFrame], 0);
+        recordCommandBuffer(commandBuffers[currentFrame], imageIndex);
+
+        outCommandBuffers = { commandBuffers[currentFrame] };
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called right before the swap chain destruction (will happen each time the
+    // window is resized and at application shutdown).
+    //
+    // Use it to destroy your own Vulkan objects (like the framebuffers) that depends on
+    // the swap chain (ie. the dimensions and number of its images).
+    //------------------------------------------------------------------------------------
+    virtual void onSwapChainAboutToBeDestroyed() override
+    {
+        // The frames in flight might still use those objects: destroy them later
+        destroyWhenRetired(
+            [this, framebuffers = framebuffers, colorImages = colorImages,
+             colorImageViews = colorImageViews, colorImageMemories = colorImageMemories,
+             depthImageView = depthImageView, depthImage = depthImage,
+             depthImageMemory = depthImageMemory]() {
+                for (auto framebuffer : framebuffers)
+                    vkDestroyFramebuffer(device, framebuffer, nullptr);
+
+                for (size_t i = 0; i < colorImages.size(); ++i)
+                {
+                    vkDestroyImageView(device, colorImageViews[i], nullptr);
+                    vkDestroyImage(device, colorImages[i], nullptr);
+                    vkFreeMemory(device, colorImageMemories[i], nullptr);
+                }
+
+                vkDestroyImageView(device, depthImageView, nullptr);
+                vkDestroyImage(device, depthImage, nullptr);
+                vkFreeMemory(device, depthImageMemory, nullptr);
+            }
+        );
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called after exiting the main loop.
+    //
+    // Use it to destroy your own Vulkan objects (render passes, graphics pipelines,
+    // framebuffers, vertex & index buffers, command buffers, ...).
+    //------------------------------------------------------------------------------------
+    virtual void destroyVulkanObjects() override
+    {
+        vkDestroyBuffer(device, indexBuffer, nullptr);
+        vkFreeMemory(device, indexBufferMemory, nullptr);
+
+        vkDestroyBuffer(device, vertexBuffer, nullptr);
+        vkFreeMemory(device, vertexBufferMemory, nullptr);
+
+        for (size_t i = 0; i < uniformBuffers.size(); ++i)
+        {
+            vkDestroyBuffer(device, uniformBuffers[i], nullptr);
+            vkFreeMemory(device, uniformBuffersMemory[i], nullptr);
+        }
+
+        vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+
+        vkDestroyCommandPool(device, commandPool, nullptr);
+
+        vkDestroyPipeline(device, graphicsPipeline, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        vkDestroyRenderPass(device, renderPass, nullptr);
+    }
+
+
+protected:
+    //------------------------------------------------------------------------------------
+    // Creates the render pass, rendering both eyes at once in the layers of its
+    // attachments.
+    //
+    // The color attachment isn't a swap chain image: it is left in the
+    // VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL layout, to be copied into one.
+    //------------------------------------------------------------------------------------
+    void createRenderPass()
+    {
+        // The color buffer attachment (one layer per eye)
+        VkAttachmentDescription colorAttachment{};
+        colorAttachment.format = surfaceImageFormat;
+        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+        // The depth buffer attachment (one layer per eye)
+        VkAttachmentDescription depthAttachment{};
+        depthAttachment.format = findDepthFormat();
+        depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference colorAttachmentRef{};
+        colorAttachmentRef.attachment = 0;
+        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference depthAttachmentRef{};
+        depthAttachmentRef.attachment = 1;
+        depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachmentRef;
+        subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+        // The first dependency waits for the previous use of the attachments, the second
+        // one makes the color attachment available to the copy into the swap chain image
+        std::array<VkSubpassDependency, 2> dependencies{};
+
+        dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[0].dstSubpass = 0;
+        dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                       VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependencies[0].srcAccessMask = 0;
+        dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                       VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        dependencies[1].srcSubpass = 0;
+        dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        // The single subpass renders all the views
+        VkRenderPassMultiviewCreateInfo multiviewInfo = getMultiviewCreateInfo();
+
+        // Create the render pass, using all the above informations
+        std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.pNext = &multiviewInfo;
+        renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        renderPassInfo.pAttachments = attachments.data();
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+        renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+        renderPassInfo.pDependencies = dependencies.data();
+
+        if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create render pass!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates the layout of the descriptor set used to send the uniform buffer object
+    // (UBO) to the shaders
+    //------------------------------------------------------------------------------------
+    void createDescriptorSetLayout()
+    {
+        VkDescriptorSetLayoutBinding uboLayoutBinding{};
+        uboLayoutBinding.binding = 0;
+        uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        uboLayoutBinding.descriptorCount = 1;
+        uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        uboLayoutBinding.pImmutableSamplers = nullptr; // Optional
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &uboLayoutBinding;
+
+        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+            throw std::runtime_error("failed to create descriptor set layout!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates the graphics pipeline
+    //
+    // Nothing is specific to multiview here: the render pass decides how many views are
+    // rendered.
+    //------------------------------------------------------------------------------------
+    void createGraphicsPipeline()
+    {
+        // Load the shaders
+        auto vertShaderCode = readFile(EXECUTABLE_DIR / "shaders" / "shader.vert.spv");
+        auto fragShaderCode = readFile(EXECUTABLE_DIR / "shaders" / "shader.frag.spv");
+
+        VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
+        VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+
+        // Shader stages specification
+        VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+        vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+        vertShaderStageInfo.module = vertShaderModule;
+        vertShaderStageInfo.pName = "main";
+
+        VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
+        fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        fragShaderStageInfo.module = fragShaderModule;
+        fragShaderStageInfo.pName = "main";
+
+        VkPipelineShaderStageCreateInfo shaderStages[] = {
+            vertShaderStageInfo,
+            fragShaderStageInfo
+        };
+
+        // Dynamic state specification
+        std::vector<VkDynamicState> dynamicStates = {
+            VK_DYNAMIC_STATE_VIEWPORT,
+            VK_DYNAMIC_STATE_SCISSOR
+        };
+
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicState.pDynamicStates = dynamicStates.data();
+
+        // Vertex input
+        auto bindingDescription = Vertex::getBindingDescription();
+        auto attributeDescriptions = Vertex::getAttributeDescriptions();
+
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+        // Input assembly
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        // Viewport and scissor (dynamic, will be set in the command buffer)
+        VkPipelineViewportStateCreateInfo viewportState{};
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        // Rasterizer
+        VkPipelineRasterizationStateCreateInfo rasterizer{};
+        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizer.depthClampEnable = VK_FALSE;
+        rasterizer.rasterizerDiscardEnable = VK_FALSE;
+        rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizer.lineWidth = 1.0f;
+        rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+        rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        rasterizer.depthBiasEnable = VK_FALSE;
+
+        // Multisampling
+        VkPipelineMultisampleStateCreateInfo multisampling{};
+        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampling.sampleShadingEnable = VK_FALSE;
+        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        // Color blending
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachment.blendEnable = VK_FALSE;
+
+        VkPipelineColorBlendStateCreateInfo colorBlending{};
+        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlending.logicOpEnable = VK_FALSE;
+        colorBlending.attachmentCount = 1;
+        colorBlending.pAttachments = &colorBlendAttachment;
+
+        // Depth & stencil
+        VkPipelineDepthStencilStateCreateInfo depthStencil{};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = VK_TRUE;
+        depthStencil.depthWriteEnable = VK_TRUE;
+        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+        depthStencil.depthBoundsTestEnable = VK_FALSE;
+        depthStencil.stencilTestEnable = VK_FALSE;
+
+        // Pipeline layout
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+
+        if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create pipeline layout!");
+
+        // Pipeline
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.stageCount = 2;
+        pipelineInfo.pStages = shaderStages;
+        pipelineInfo.pVertexInputState = &vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterizer;
+        pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pDepthStencilState = &depthStencil;
+        pipelineInfo.pColorBlendState = &colorBlending;
+        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.layout = pipelineLayout;
+        pipelineInfo.renderPass = renderPass;
+        pipelineInfo.subpass = 0;
+
+        if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create graphics pipeline!");
+
+        // Destroy the shaders
+        vkDestroyShaderModule(device, fragShaderModule, nullptr);
+        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates one framebuffer for each frame-in-flight (each one using its own color
+    // image, since it is still read by the copy while the next frame is rendered)
+    //------------------------------------------------------------------------------------
+    void createFramebuffers()
+    {
+        framebuffers.resize(config.nbFramesInFlight);
+
+        for (size_t i = 0; i < config.nbFramesInFlight; ++i)
+        {
+            std::array<VkImageView, 2> attachments = {
+                colorImageViews[i],
+                depthImageView
+            };
+
+            // With multiview, the framebuffer has only one layer: the views are rendered
+            // in the layers of the attachments
+            VkFramebufferCreateInfo framebufferInfo{};
+            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebufferInfo.renderPass = renderPass;
+            framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+            framebufferInfo.pAttachments = attachments.data();
+            framebufferInfo.width = eyeExtent.width;
+            framebufferInfo.height = eyeExtent.height;
+            framebufferInfo.layers = 1;
+
+            if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffers[i]) != VK_SUCCESS)
+                throw std::runtime_error("Failed to create framebuffer!");
+        }
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates a command pool.
+    //------------------------------------------------------------------------------------
+    void createCommandPool()
+    {
+        queueFamilyIndices_t queueFamilyIndices = findQueueFamilies(physicalDevice);
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = queueFamilyIndices.families[knm::vk::GRAPHICS_QUEUE_FAMILY];
+
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create command pool!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates the layered color images (one per frame-in-flight), rendered by the render
+    // pass and copied into the swap chain images
+    //------------------------------------------------------------------------------------
+    void createColorResources()
+    {
+        colorImages.resize(config.nbFramesInFlight);
+        colorImageMemories.resize(config.nbFramesInFlight);
+        colorImageViews.resize(config.nbFramesInFlight);
+
+        for (size_t i = 0; i < config.nbFramesInFlight; ++i)
+        {
+            createImage(
+                eyeExtent.width, eyeExtent.height, 1, VK_SAMPLE_COUNT_1_BIT,
+                surfaceImageFormat, VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                colorImages[i], colorImageMemories[i], NB_VIEWS
+            );
+
+            colorImageViews[i] = createImageView(
+                colorImages[i], surfaceImageFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1, NB_VIEWS
+            );
+        }
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates the resources needed by the layered depth buffer (image, memory and image
+    // view)
+    //------------------------------------------------------------------------------------
+    void createDepthResources()
+    {
+        VkFormat depthFormat = findDepthFormat();
+
+        createImage(
+            eyeExtent.width, eyeExtent.height, 1, VK_SAMPLE_COUNT_1_BIT,
+            depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            depthImage, depthImageMemory, NB_VIEWS
+        );
+
+        depthImageView = createImageView(
+            depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1, NB_VIEWS
+        );
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates a vertex buffer containing the vertices of the mesh to render
+    //------------------------------------------------------------------------------------
+    void createVertexBuffer()
+    {
+        VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
+
+        // Create a staging buffer (usable on the CPU side)
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        createBuffer(
+            bufferSize,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            stagingBuffer,
+            stagingBufferMemory
+        );
+
+        // Copy the vertex data to the staging buffer
+        void* data;
+        vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data);
+        memcpy(data, vertices.data(), (size_t) bufferSize);
+        vkUnmapMemory(device, stagingBufferMemory);
+
+        // Create the buffer (on the GPU)
+        createBuffer(
+            bufferSize,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            vertexBuffer,
+            vertexBufferMemory
+        );
+
+        // Copy the data from CPU to GPU
+        copyBuffer(commandPool, stagingBuffer, vertexBuffer, bufferSize);
+
+        // Cleanup of the staging buffer
+        vkDestroyBuffer(device, stagingBuffer, nullptr);
+        vkFreeMemory(device, stagingBufferMemory, nullptr);
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates an index buffer containing the indices of the mesh to render
+    //------------------------------------------------------------------------------------
+    void createIndexBuffer()
+    {
+        VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
+
+        // Create a staging buffer (usable on the CPU side)
+        VkBuffer stagingBuffer;
+        VkDeviceMemory stagingBufferMemory;
+        createBuffer(
+            bufferSize,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            stagingBuffer,
+            stagingBufferMemory
+        );
+
+        // Copy the indices to the staging buffer
+        void* data;
+        vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data);
+        memcpy(data, indices.data(), (size_t) bufferSize);
+        vkUnmapMemory(device, stagingBufferMemory);
+
+        // Create the buffer (on the GPU)
+        createBuffer(
+            bufferSize,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            indexBuffer,
+            indexBufferMemory
+        );
+
+        // Copy the data from CPU to GPU
+        copyBuffer(commandPool, stagingBuffer, indexBuffer, bufferSize);
+
+        // Cleanup of the staging buffer
+        vkDestroyBuffer(device, stagingBuffer, nullptr);
+        vkFreeMemory(device, stagingBufferMemory, nullptr);
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates a buffer that will contain the UBO (one each frame-in-flight). Its content
+    // will need to be updated each frame.
+    //------------------------------------------------------------------------------------
+    void createUniformBuffers()
+    {
+        VkDeviceSize bufferSize = sizeof(UniformBufferObject);
+
+        uniformBuffers.resize(config.nbFramesInFlight);
+        uniformBuffersMemory.resize(config.nbFramesInFlight);
+        uniformBuffersMapped.resize(config.nbFramesInFlight);
+
+        for (size_t i = 0; i < config.nbFramesInFlight; ++i)
+        {
+            createBuffer(
+                bufferSize,
+                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                uniformBuffers[i],
+                uniformBuffersMemory[i]
+            );
+
+            vkMapMemory(device, uniformBuffersMemory[i], 0, bufferSize, 0, &uniformBuffersMapped[i]);
+        }
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Descriptor sets can't be created directly, they must be allocated from a pool like
+    // command buffers
+    //------------------------------------------------------------------------------------
+    void createDescriptorPool()
+    {
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        poolSize.descriptorCount = static_cast<uint32_t>(config.nbFramesInFlight);
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        poolInfo.maxSets = static_cast<uint32_t>(config.nbFramesInFlight);
+
+        if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create descriptor pool!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates the descriptor set used to send the uniform buffer object (UBO) to the
+    // shaders (one for each frame-in-flight)
+    //------------------------------------------------------------------------------------
+    void createDescriptorSets()
+    {
+        std::vector<VkDescriptorSetLayout> layouts(config.nbFramesInFlight, descriptorSetLayout);
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = descriptorPool;
+        allocInfo.descriptorSetCount = static_cast<uint32_t>(config.nbFramesInFlight);
+        allocInfo.pSetLayouts = layouts.data();
+
+        descriptorSets.resize(config.nbFramesInFlight);
+        if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate descriptor sets!");
+
+        for (size_t i = 0; i < config.nbFramesInFlight; ++i)
+        {
+            VkDescriptorBufferInfo bufferInfo{};
+            bufferInfo.buffer = uniformBuffers[i];
+            bufferInfo.offset = 0;
+            bufferInfo.range = sizeof(UniformBufferObject);
+
+            VkWriteDescriptorSet descriptorWrite{};
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstSet = descriptorSets[i];
+            descriptorWrite.dstBinding = 0;
+            descriptorWrite.dstArrayElement = 0;
+            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.pBufferInfo = &bufferInfo;
+
+            vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+        }
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates one command buffer for each frame-in-flight
+    //------------------------------------------------------------------------------------
+    void createCommandBuffers()
+    {
+        commandBuffers.resize(config.nbFramesInFlight);
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = (uint32_t) commandBuffers.size();
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate command buffers!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Record the command buffer rendering both eyes, then copying them side by side into
+    // the swap chain image at the given index
+    //------------------------------------------------------------------------------------
+    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+    {
+        // Start the recording of the command buffer
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+            throw std::runtime_error("Failed to begin recording command buffer!");
+
+        // Begin the render pass (the clear values apply to all the views)
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = framebuffers[currentFrame];
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = eyeExtent;
+
+        std::array<VkClearValue, 2> clearValues{};
+        clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clearValues[1].depthStencil = {1.0f, 0};
+
+        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+        renderPassInfo.pClearValues = clearValues.data();
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+
+        // Viewport and scissor (shared by all the views)
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(eyeExtent.width);
+        viewport.height = static_cast<float>(eyeExtent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        VkRect2D scissor{};
+        scissor.offset = {0, 0};
+        scissor.extent = eyeExtent;
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        VkBuffer vertexBuffers[] = {vertexBuffer};
+        VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipelineLayout,
+            0,
+            1,
+            &descriptorSets[currentFrame],
+            0,
+            nullptr
+        );
+
+        // A single draw call renders both eyes
+        vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+
+        vkCmdEndRenderPass(commandBuffer);
+
+        // Prepare the swap chain image to receive the copy (its previous content is
+        // discarded, and the stage matches the one waiting for its availability)
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = swapChainImages[imageIndex];
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier
+        );
+
+        // Copy each eye into its half of the swap chain image
+        std::array<VkImageCopy, NB_VIEWS> regions{};
+        for (uint32_t i = 0; i < NB_VIEWS; ++i)
+        {
+            regions[i].srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            regions[i].srcSubresource.mipLevel = 0;
+            regions[i].srcSubresource.baseArrayLayer = i;
+            regions[i].srcSubresource.layerCount = 1;
+            regions[i].srcOffset = {0, 0, 0};
+            regions[i].dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            regions[i].dstSubresource.mipLevel = 0;
+            regions[i].dstSubresource.baseArrayLayer = 0;
+            regions[i].dstSubresource.layerCount = 1;
+            regions[i].dstOffset = {static_cast<int32_t>(i * eyeExtent.width), 0, 0};
+            regions[i].extent = {eyeExtent.width, eyeExtent.height, 1};
+        }
+
+        vkCmdCopyImage(
+            commandBuffer,
+            colorImages[currentFrame], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            swapChainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint32_t>(regions.size()), regions.data()
+        );
+
+        // The swap chain image can then be presented
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier
+        );
+
+        // Finish the recording of the command buffer
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record command buffer!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Update the content of the uniform buffer
+    //
+    // Here the model rotate on itself, and the eyes are on each side of the camera.
+    //------------------------------------------------------------------------------------
+    void updateUniformBuffer(uint32_t currentImage)
+    {
+        static auto startTime = std::chrono::high_resolution_clock::now();
+
+        auto currentTime = std::chrono::high_resolution_clock::now();
+        float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+
+        const glm::vec3 eye(1.0f, 1.0f, 1.0f);
+        const glm::vec3 target(0.0f, 0.0f, 0.0f);
+        const glm::vec3 up(0.0f, 0.0f, 1.0f);
+
+        glm::vec3 right = glm::normalize(glm::cross(target - eye, up));
+
+        UniformBufferObject ubo{};
+        ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(30.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+
+        for (uint32_t i = 0; i < NB_VIEWS; ++i)
+        {
+            // Left eye first
+            glm::vec3 offset = right * (EYE_SEPARATION * (i == 0 ? -0.5f : 0.5f));
+
+            ubo.view[i] = glm::lookAt(eye + offset, target + offset, up);
+            ubo.proj[i] = glm::perspective(glm::radians(45.0f), eyeExtent.width / (float) eyeExtent.height, 0.1f, 10.0f);
+            ubo.proj[i][1][1] *= -1;
+        }
+
+        memcpy(uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Find a suitable depth image format
+    //------------------------------------------------------------------------------------
+    inline VkFormat findDepthFormat() const
+    {
+        return findSupportedFormat(
+            {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT},
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT
+        );
+    }
+
+
+protected:
+    // Extent of the images of each eye
+    VkExtent2D eyeExtent = { 0, 0 };
+
+    // Framebuffers (one per frame-in-flight)
+    std::vector<VkFramebuffer> framebuffers;
+
+    // Pipeline
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline graphicsPipeline = VK_NULL_HANDLE;
+
+    // Layered color buffers (one per frame-in-flight)
+    std::vector<VkImage> colorImages;
+    std::vector<VkDeviceMemory> colorImageMemories;
+    std::vector<VkImageView> colorImageViews;
+
+    // Layered depth buffer
+    VkImage depthImage;
+    VkDeviceMemory depthImageMemory;
+    VkImageView depthImageView;
+
+    // Commands
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> commandBuffers;
+
+    // Descriptor sets
+    VkDescriptorSetLayout descriptorSetLayout;
+    VkDescriptorPool descriptorPool;
+    std::vector<VkDescriptorSet> descriptorSets;
+
+    // Vertex and index buffers
+    VkBuffer vertexBuffer;
+    VkDeviceMemory vertexBufferMemory;
+    VkBuffer indexBuffer;
+    VkDeviceMemory indexBufferMemory;
+
+    // Uniforms buffers (one per in-flight frame)
+    std::vector<VkBuffer> uniformBuffers;
+    std::vector<VkDeviceMemory> uniformBuffersMemory;
+    std::vector<void*> uniformBuffersMapped;
+};
+
+
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path path(argv[0]);
+    EXECUTABLE_DIR = path.parent_path();
+
+    ExampleApplication app;
+
+    try
+    {
+        app.run();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
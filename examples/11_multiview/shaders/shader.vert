@@ -0,0 +1,25 @@
+#version 450
+#extension GL_EXT_multiview : enable
+
+// Uniforms (one view and projection matrix per eye)
+layout(binding = 0) uniform UniformBufferObject
+{
+    mat4 model;
+    mat4 view[2];
+    mat4 proj[2];
+} ubo;
+
+// Inputs
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+
+// Outputs
+layout(location = 0) out vec3 fragColor;
+
+
+void main()
+{
+    // gl_ViewIndex is the index of the view (so of the layer) being rendered
+    gl_Position = ubo.proj[gl_ViewIndex] * ubo.view[gl_ViewIndex] * ubo.model * vec4(inPosition, 1.0);
+    fragColor = inColor;
+}
@@ -0,0 +1,291 @@
+/*
+SPDX-FileCopyrightText: 2023 Philip Abbet
+
+SPDX-FileContributor: Philip Abbet <philip.abbet@gmail.com>
+
+SPDX-License-Identifier: MIT
+*/
+
+/** Presentation modes benchmark
+
+This example renders some frames with each combination of presentation mode and number
+of swap chain images supported by the device (see config_t::benchmarkPresentationModes),
+and reports the frame time and the latencies measured for each of them.
+
+The input-to-submit latency is the time spent by the CPU between the sampling of the
+input state and the submission of the frame. The submit-to-present latency is only
+available if the device supports waiting for the presentation of the frames
+(VK_KHR_present_id and VK_KHR_present_wait).
+*/
+
+
+#define KNM_VULKAN_TOOLS_IMPLEMENTATION
+#include <knm_vulkan_tools.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+using namespace knm::vk;
+
+
+//----------------------------------------------------------------------------------------
+// The user must inherit from the knm::vk::Application class, and implement a few methods
+// to create its own Vulkan objects (render passes, graphics pipelines, framebuffers,
+// vertex & index buffers, command buffers, ...) and do the actual rendering.
+//----------------------------------------------------------------------------------------
+class BenchmarkApplication: public knm::vk::Application
+{
+public:
+    BenchmarkApplication()
+    {
+        config.windowTitle = "Presentation modes benchmark";
+        config.benchmarkPresentationModes = true;
+        config.usePresentWait = true;
+    }
+
+
+protected:
+    //------------------------------------------------------------------------------------
+    // Method called after everything was initialised (window, instance, logical device,
+    // swap chain), right before entering the main loop.
+    //
+    // Use it to create your own Vulkan objects (render passes, graphics pipelines,
+    // vertex & index buffers, command buffers, ...).
+    //------------------------------------------------------------------------------------
+    virtual void createVulkanObjects() override
+    {
+        createRenderPass();
+        createCommandBuffers();
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called after the swap chain was created (will happen each time the window
+    // is resized and at application startup).
+    //------------------------------------------------------------------------------------
+    virtual void onSwapChainReady() override
+    {
+        createFramebuffers();
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called to retrieve the number of command buffers that need to be executed
+    // to render the current frame.
+    //------------------------------------------------------------------------------------
+    virtual uint32_t getNbCommandBuffers() const override
+    {
+        return 1;
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called to retrieve the command buffers to execute to render the current
+    // frame.
+    //------------------------------------------------------------------------------------
+    virtual void getCommandBuffers(
+        float elapsed, uint32_t imageIndex, std::vector<VkCommandBuffer>& outCommandBuffers
+    ) override
+    {
+        // Record the command buffer (no need to reset it, the command pool of the frame
+        // context was already reset)
+        recordCommandBuffer(commandBuffers[currentFrame], imageIndex);
+
+        outCommandBuffers = { commandBuffers[currentFrame] };
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called right before the swap chain destruction (will happen each time the
+    // window is resized and at application shutdown).
+    //------------------------------------------------------------------------------------
+    virtual void onSwapChainAboutToBeDestroyed() override
+    {
+        // The frames in flight might still use those objects: destroy them later
+        destroyWhenRetired(
+            [this, framebuffers = swapChainFramebuffers]() {
+                for (auto framebuffer : framebuffers)
+                    vkDestroyFramebuffer(device, framebuffer, nullptr);
+            }
+        );
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called after exiting the main loop.
+    //------------------------------------------------------------------------------------
+    virtual void destroyVulkanObjects() override
+    {
+        vkDestroyRenderPass(device, renderPass, nullptr);
+    }
+
+
+protected:
+    //------------------------------------------------------------------------------------
+    // Creates a render pass with a single color attachment, cleared at the beginning
+    //------------------------------------------------------------------------------------
+    void createRenderPass()
+    {
+        VkAttachmentDescription colorAttachment{};
+        colorAttachment.format = surfaceImageFormat;
+        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        VkAttachmentReference colorAttachmentRef{};
+        colorAttachmentRef.attachment = 0;
+        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachmentRef;
+
+        VkSubpassDependency dependency{};
+        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependency.dstSubpass = 0;
+        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependency.srcAccessMask = 0;
+        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = 1;
+        renderPassInfo.pAttachments = &colorAttachment;
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+        renderPassInfo.dependencyCount = 1;
+        renderPassInfo.pDependencies = &dependency;
+
+        if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create render pass!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates one framebuffer for each image in the swap chain
+    //------------------------------------------------------------------------------------
+    void createFramebuffers()
+    {
+        swapChainFramebuffers.resize(swapChainImageViews.size());
+
+        for (size_t i = 0; i < swapChainImageViews.size(); ++i)
+        {
+            VkFramebufferCreateInfo framebufferInfo{};
+            framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+            framebufferInfo.renderPass = renderPass;
+            framebufferInfo.attachmentCount = 1;
+            framebufferInfo.pAttachments = &swapChainImageViews[i];
+            framebufferInfo.width = swapChainExtent.width;
+            framebufferInfo.height = swapChainExtent.height;
+            framebufferInfo.layers = 1;
+
+            if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &swapChainFramebuffers[i]) != VK_SUCCESS)
+                throw std::runtime_error("Failed to create framebuffer!");
+        }
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Allocates one command buffer from the command pool of each frame context
+    //------------------------------------------------------------------------------------
+    void createCommandBuffers()
+    {
+        commandBuffers.resize(config.nbFramesInFlight);
+
+        for (uint32_t i = 0; i < config.nbFramesInFlight; ++i)
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = frames[i].commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+
+            if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffers[i]) != VK_SUCCESS)
+                throw std::runtime_error("Failed to allocate command buffers!");
+        }
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Record the command buffer clearing the swap chain image at the given index
+    //------------------------------------------------------------------------------------
+    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+    {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+            throw std::runtime_error("Failed to begin recording command buffer!");
+
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = swapChainFramebuffers[imageIndex];
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = swapChainExtent;
+
+        VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
+        renderPassInfo.clearValueCount = 1;
+        renderPassInfo.pClearValues = &clearColor;
+
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdEndRenderPass(commandBuffer);
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record command buffer!");
+    }
+
+
+protected:
+    // Framebuffers (one per image in the swap chain)
+    std::vector<VkFramebuffer> swapChainFramebuffers;
+
+    // Render pass
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+
+    // Commands (one per frame-in-flight, allocated from the frame contexts)
+    std::vector<VkCommandBuffer> commandBuffers;
+};
+
+
+
+int main(int argc, char** argv)
+{
+    BenchmarkApplication app;
+
+    try
+    {
+        app.run();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "presentation mode | images | frame (ms) | input-to-submit, CPU (ms) | submit-to-present (ms)" << std::endl;
+
+    for (const auto& result : app.getPresentationBenchmarkResults())
+    {
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(17) << getPresentationModeName(result.presentationMode) << " | "
+                  << std::setw(6) << result.imageCount << " | "
+                  << std::setw(10) << result.frameTime * 1000.0f << " | "
+                  << std::setw(25) << result.inputToSubmitLatency * 1000.0f << " | ";
+
+        if (result.submitToPresentMeasured)
+            std::cout << std::setw(22) << result.submitToPresentLatency * 1000.0f << std::endl;
+        else
+            std::cout << std::setw(22) << "n/a" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
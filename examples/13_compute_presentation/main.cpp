@@ -0,0 +1,370 @@
+/*
+SPDX-FileCopyrightText: 2023 Philip Abbet
+
+SPDX-FileContributor: Philip Abbet <philip.abbet@gmail.com>
+
+SPDX-License-Identifier: MIT
+*/
+
+/** Compute presentation
+
+This example writes the swap chain images directly from a compute shader (see
+config_t::useComputePresentation), without any render pass nor framebuffer, and
+captures one frame every second (see config_t::captureInterval).
+
+The images are in the VK_IMAGE_LAYOUT_GENERAL layout during the execution of the command
+buffers of the frame: the application takes care of the transitions, and of ordering
+the writes of the compute shader before the copy of the captured frames.
+
+The captured frames are saved as PNG files in the current directory.
+*/
+
+
+#define KNM_VULKAN_TOOLS_IMPLEMENTATION
+#include <knm_vulkan_tools.hpp>
+
+#include <iostream>
+#include <cstdlib>
+#include <filesystem>
+
+using namespace knm::vk;
+
+
+static std::filesystem::path EXECUTABLE_DIR;
+
+
+//----------------------------------------------------------------------------------------
+// Size of the workgroups of the compute shader (must match the shader)
+//----------------------------------------------------------------------------------------
+const uint32_t WORKGROUP_SIZE = 8;
+
+
+//----------------------------------------------------------------------------------------
+// The user must inherit from the knm::vk::Application class, and implement a few methods
+// to create its own Vulkan objects (render passes, graphics pipelines, framebuffers,
+// vertex & index buffers, command buffers, ...) and do the actual rendering.
+//----------------------------------------------------------------------------------------
+class ComputeApplication: public knm::vk::Application
+{
+public:
+    ComputeApplication()
+    {
+        config.windowTitle = "Compute presentation";
+        config.useComputePresentation = true;
+        config.captureInterval = 60;
+        config.capturePrefix = "compute_presentation";
+    }
+
+
+protected:
+    //------------------------------------------------------------------------------------
+    // Method called after everything was initialised (window, instance, logical device,
+    // swap chain), right before entering the main loop.
+    //
+    // Use it to create your own Vulkan objects (render passes, graphics pipelines,
+    // vertex & index buffers, command buffers, ...).
+    //------------------------------------------------------------------------------------
+    virtual void createVulkanObjects() override
+    {
+        createDescriptorSetLayout();
+        createComputePipeline();
+        createCommandBuffers();
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called after the swap chain was created (will happen each time the window
+    // is resized and at application startup).
+    //------------------------------------------------------------------------------------
+    virtual void onSwapChainReady() override
+    {
+        createDescriptorPool();
+        createDescriptorSets();
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called to retrieve the number of command buffers that need to be executed
+    // to render the current frame.
+    //------------------------------------------------------------------------------------
+    virtual uint32_t getNbCommandBuffers() const override
+    {
+        return 1;
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called to retrieve the command buffers to execute to render the current
+    // frame.
+    //------------------------------------------------------------------------------------
+    virtual void getCommandBuffers(
+        float elapsed, uint32_t imageIndex, std::vector<VkCommandBuffer>& outCommandBuffers
+    ) override
+    {
+        time += elapsed;
+
+        // Record the command buffer (no need to reset it, the command pool of the frame
+        // context was already reset)
+        recordCommandBuffer(commandBuffers[currentFrame], imageIndex);
+
+        outCommandBuffers = { commandBuffers[currentFrame] };
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called right before the swap chain destruction (will happen each time the
+    // window is resized and at application shutdown).
+    //------------------------------------------------------------------------------------
+    virtual void onSwapChainAboutToBeDestroyed() override
+    {
+        // The frames in flight might still use those objects: destroy them later
+        destroyWhenRetired(
+            [this, descriptorPool = descriptorPool]() {
+                vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+            }
+        );
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Method called after exiting the main loop.
+    //------------------------------------------------------------------------------------
+    virtual void destroyVulkanObjects() override
+    {
+        vkDestroyPipeline(device, computePipeline, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+    }
+
+
+protected:
+    //------------------------------------------------------------------------------------
+    // Creates the layout of the descriptor sets, containing the storage image written by
+    // the compute shader
+    //------------------------------------------------------------------------------------
+    void createDescriptorSetLayout()
+    {
+        VkDescriptorSetLayoutBinding imageLayoutBinding{};
+        imageLayoutBinding.binding = 0;
+        imageLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        imageLayoutBinding.descriptorCount = 1;
+        imageLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        imageLayoutBinding.pImmutableSamplers = nullptr;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &imageLayoutBinding;
+
+        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create descriptor set layout!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates the compute pipeline (the time is sent to the shader as a push constant)
+    //------------------------------------------------------------------------------------
+    void createComputePipeline()
+    {
+        auto shaderCode = readFile(EXECUTABLE_DIR / "shaders" / "shader.comp.spv");
+
+        VkShaderModule shaderModule = createShaderModule(shaderCode);
+
+        VkPipelineShaderStageCreateInfo shaderStageInfo{};
+        shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        shaderStageInfo.module = shaderModule;
+        shaderStageInfo.pName = "main";
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(float);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create pipeline layout!");
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage = shaderStageInfo;
+        pipelineInfo.layout = pipelineLayout;
+
+        if (vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &computePipeline) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create compute pipeline!");
+
+        // Destroy the shader
+        vkDestroyShaderModule(device, shaderModule, nullptr);
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates the descriptor pool (one storage image per image in the swap chain)
+    //------------------------------------------------------------------------------------
+    void createDescriptorPool()
+    {
+        uint32_t nbImages = static_cast<uint32_t>(getRenderImageViews().size());
+
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        poolSize.descriptorCount = nbImages;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        poolInfo.maxSets = nbImages;
+
+        if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create descriptor pool!");
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Creates one descriptor set for each image in the swap chain, referencing it as a
+    // storage image
+    //------------------------------------------------------------------------------------
+    void createDescriptorSets()
+    {
+        const std::vector<VkImageView>& imageViews = getRenderImageViews();
+
+        std::vector<VkDescriptorSetLayout> layouts(imageViews.size(), descriptorSetLayout);
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = descriptorPool;
+        allocInfo.descriptorSetCount = static_cast<uint32_t>(imageViews.size());
+        allocInfo.pSetLayouts = layouts.data();
+
+        descriptorSets.resize(imageViews.size());
+        if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate descriptor sets!");
+
+        for (size_t i = 0; i < imageViews.size(); ++i)
+        {
+            // The images are in the GENERAL layout while the command buffers are executed
+            VkDescriptorImageInfo imageInfo{};
+            imageInfo.imageView = imageViews[i];
+            imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+            VkWriteDescriptorSet descriptorWrite{};
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstSet = descriptorSets[i];
+            descriptorWrite.dstBinding = 0;
+            descriptorWrite.dstArrayElement = 0;
+            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.pImageInfo = &imageInfo;
+
+            vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+        }
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Allocates one command buffer from the command pool of each frame context
+    //------------------------------------------------------------------------------------
+    void createCommandBuffers()
+    {
+        commandBuffers.resize(config.nbFramesInFlight);
+
+        for (uint32_t i = 0; i < config.nbFramesInFlight; ++i)
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = frames[i].commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+
+            if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffers[i]) != VK_SUCCESS)
+                throw std::runtime_error("Failed to allocate command buffers!");
+        }
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Record the command buffer writing the swap chain image at the given index with the
+    // compute shader
+    //------------------------------------------------------------------------------------
+    void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+    {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+            throw std::runtime_error("Failed to begin recording command buffer!");
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+
+        vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1,
+            &descriptorSets[imageIndex], 0, nullptr
+        );
+
+        vkCmdPushConstants(
+            commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(float),
+            &time
+        );
+
+        vkCmdDispatch(
+            commandBuffer,
+            (swapChainExtent.width + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE,
+            (swapChainExtent.height + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE,
+            1
+        );
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record command buffer!");
+    }
+
+
+protected:
+    // Descriptors (one set per image in the swap chain)
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> descriptorSets;
+
+    // Compute pipeline
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline computePipeline = VK_NULL_HANDLE;
+
+    // Commands (one per frame-in-flight, allocated from the frame contexts)
+    std::vector<VkCommandBuffer> commandBuffers;
+
+    // Time elapsed since the start of the application (in seconds)
+    float time = 0.0f;
+};
+
+
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path path(argv[0]);
+    EXECUTABLE_DIR = path.parent_path();
+
+    ComputeApplication app;
+
+    try
+    {
+        app.run();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const frameStatistics_t& statistics = app.getFrameStatistics();
+
+    std::cout << "Captured frames: " << statistics.nbCapturedFrames
+              << " (dropped: " << statistics.nbDroppedCaptures << ")" << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -154,6 +154,18 @@ LICENSE
 #include <map>
 #include <string>
 #include <stdexcept>
+#include <chrono>
+#include <atomic>
+#include <array>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
 
 
 #ifdef KNM_VULKAN_TOOLS_IMPLEMENTATION
@@ -163,7 +175,10 @@ LICENSE
     #include <cstdint>   // Necessary for uint32_t
     #include <limits>    // Necessary for std::numeric_limits
     #include <algorithm> // Necessary for std::clamp()
-    #include <fstream>
+    #include <cmath>     // Necessary for std::abs()
+    #include <cstdio>    // Necessary for snprintf()
+    #include <cctype>    // Necessary for tolower()
+    #include <cstdlib>   // Necessary for getenv()
 #endif
 
 
@@ -175,6 +190,73 @@ LICENSE
 namespace knm {
 namespace vk {
 
+    /// Maximum number of frames that can be processed concurrently (see
+    /// config_t::nbFramesInFlight)
+    const uint32_t MAX_NB_FRAMES_IN_FLIGHT = 4;
+
+    /// Maximum number of command buffers that can be submitted per frame by an
+    /// ApplicationT
+    const uint32_t MAX_NB_COMMAND_BUFFERS = 16;
+
+    /// Maximum number of windows (including the main one) of an application (see
+    /// config_t::additionalWindows)
+    const uint32_t MAX_NB_WINDOWS = 8;
+
+    /// Maximum number of damage rectangles passed to the presentation engine per frame
+    /// (see config_t::useDamageTracking). Beyond that, their bounding box is used.
+    const uint32_t MAX_NB_DAMAGE_RECTS = 16;
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Policies used to choose the presentation mode and the number of images of
+    ///         the swap chain (see config_t::presentationPolicy)
+    //------------------------------------------------------------------------------------
+    enum presentationPolicy_t
+    {
+        /// MAILBOX if available, FIFO otherwise, with one image more than the minimum
+        PRESENTATION_POLICY_DEFAULT,
+
+        /// Minimise the latency between the rendering and the presentation: MAILBOX,
+        /// IMMEDIATE, FIFO_RELAXED or FIFO (in that order of preference), with as few
+        /// images as possible
+        PRESENTATION_POLICY_LOW_LATENCY,
+
+        /// Never render more frames than the display can show: FIFO, with the minimum
+        /// number of images
+        PRESENTATION_POLICY_POWER_SAVING,
+
+        /// Render as many frames as possible: IMMEDIATE, MAILBOX, FIFO_RELAXED or FIFO (in
+        /// that order of preference), with one image more than the minimum
+        PRESENTATION_POLICY_MAX_THROUGHPUT,
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  File formats of the captured frames (see config_t::captureFormat)
+    //------------------------------------------------------------------------------------
+    enum captureFormat_t
+    {
+        CAPTURE_FORMAT_PNG,     ///< One (uncompressed) PNG file per captured frame
+        CAPTURE_FORMAT_PPM,     ///< One binary PPM file per captured frame
+        CAPTURE_FORMAT_Y4M,     ///< All the captured frames in one raw YUV4MPEG2 file (4:4:4)
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Settings of an additional window (see config_t::additionalWindows)
+    //------------------------------------------------------------------------------------
+    struct windowDescription_t
+    {
+        uint32_t width = 800;               ///< Window width
+        uint32_t height = 600;              ///< Window height
+        std::string title = "Vulkan demo";  ///< Window title
+
+        /// Index of the monitor on which the window is displayed in fullscreen (see
+        /// glfwGetMonitors()), -1 for a normal window
+        int monitor = -1;
+    };
+
+
     //------------------------------------------------------------------------------------
     /// @brief  Contain all the settings that can affect the behavior of the Application
     ///         class without requiring the user to override any of its methods.
@@ -189,6 +271,228 @@ namespace vk {
         uint32_t windowHeight = 600;                ///< Window height
         std::string windowTitle = "Vulkan demo";    ///< Window title
 
+        /// Additional windows (up to MAX_NB_WINDOWS - 1), each one with its own surface
+        /// and swap chain. Their images are rendered by the command buffers of the main
+        /// window (see Application::windowTargets), submitted together, and presented by
+        /// a single call to vkQueuePresentKHR(). Closing any window stops the
+        /// application. Not supported in headless mode and with the pipelined stages.
+        std::vector<windowDescription_t> additionalWindows;
+
+        // Frames in flight settings
+
+        /// Number of frames that can be processed concurrently by the CPU and the GPU
+        /// (between 1 and MAX_NB_FRAMES_IN_FLIGHT). Lower values reduce the latency,
+        /// higher values improve the throughput.
+        uint32_t nbFramesInFlight = 2;
+
+        /// Size (in bytes) of the scratch area allocated in each frame context
+        size_t frameScratchSize = 0;
+
+        /// Track the completion of the frames with one timeline semaphore instead of one
+        /// fence per frame-in-flight, if supported by the device (Vulkan 1.2+). When
+        /// used, the 'timelineSemaphore' feature of 'features12' is enabled.
+        bool useTimelineSemaphore = true;
+
+        /// Render the frames on a dedicated thread (acquisition of the swap chain images,
+        /// recording and submission of the command buffers, presentation), while the
+        /// main thread only processes the window events. The events are forwarded to the
+        /// rendering thread (see Application::onWindowEvent()).
+        bool useRenderThread = false;
+
+        /// Present the frames from a dedicated worker thread, so the rendering thread
+        /// doesn't block in vkQueuePresentKHR() (which can take a full vertical blank
+        /// with the FIFO presentation mode) and can start recording the next frame
+        bool usePresentThread = false;
+
+        /// Split the processing of the frames in three stages, each one running on its
+        /// own thread (while the main thread only processes the window events):
+        /// simulation (see Application::simulate()), recording of the command buffers
+        /// (see Application::getCommandBuffers()), and submission/presentation. The
+        /// stages are linked by queues sized to the number of frames in flight, so the
+        /// CPU work of consecutive frames can overlap. When used, 'usePresentThread' is
+        /// ignored, and the presentation of the frames isn't waited for by the frame
+        /// pacing.
+        bool usePipelinedStages = false;
+
+        // Swap chain settings
+
+        /// Policy used to choose the presentation mode and the number of images of the
+        /// swap chain
+        presentationPolicy_t presentationPolicy = PRESENTATION_POLICY_DEFAULT;
+
+        /// Number of images in the swap chain (0 to let the policy choose it). Clamped
+        /// to the limits of the surface.
+        uint32_t swapChainImageCount = 0;
+
+        /// Additional usages of the swap chain images (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+        /// is always set), for instance VK_IMAGE_USAGE_TRANSFER_DST_BIT to copy rendered
+        /// images into them. They must be supported by the surface.
+        VkImageUsageFlags swapChainImageUsage = 0;
+
+        /// Instead of running normally, render some frames with each combination of
+        /// presentation mode and number of swap chain images supported by the device, and
+        /// measure the frame time and the latency of each of them (see
+        /// Application::getPresentationBenchmarkResults(), to call once run() returns).
+        /// Enable 'usePresentWait' to also measure the presentation latency.
+        bool benchmarkPresentationModes = false;
+
+        /// Number of frames to render with each combination in benchmark mode
+        uint32_t benchmarkNbFrames = 300;
+
+        // Frame pacing settings
+
+        /// Maximum number of frames rendered per second (0 for no limit). The frame
+        /// limiter sleeps during most of the frame interval, and only spins during its
+        /// last part to be precise.
+        float targetFrameRate = 0.0f;
+
+        /// When a frame rate limit is set (see 'targetFrameRate') or while benchmarking
+        /// the presentation modes, wait for the previous frame to be displayed before
+        /// starting a new one, if supported by the device (VK_KHR_present_id and
+        /// VK_KHR_present_wait). When used, both extensions and their features are
+        /// enabled.
+        bool usePresentWait = false;
+
+        /// Call Application::lateLatch() after the command buffers of a frame are
+        /// recorded, right before their submission, so the latest input state can be
+        /// written into some mapped memory used by the frame
+        bool useLateLatch = false;
+
+        /// Track the regions of the frames that changed (see Application::addDamageRect()),
+        /// so only them need to be re-rendered (see Application::getDamageRect()). They
+        /// are passed to the presentation engine if supported by the device
+        /// (VK_KHR_incremental_present, enabled when used). Only the main window is
+        /// concerned, and the dynamic resolution disables it (see useDynamicResolution).
+        bool useDamageTracking = false;
+
+        // On-demand rendering settings
+
+        /// Only render a new frame when requested (see Application::requestRedraw()),
+        /// and block until then instead of continuously rendering. The resizing and the
+        /// exposure of the window automatically request a new frame.
+        bool renderOnDemand = false;
+
+        /// In on-demand mode, maximum time between two frames (in seconds): a new frame
+        /// is rendered after that delay even if none was requested (0 to only render on
+        /// request)
+        float onDemandMaxFrameInterval = 0.0f;
+
+        // Frame capture settings
+
+        /// Save every Nth rendered frame to disk (0 to disable). The presented image is
+        /// copied into a host-visible readback buffer by a command buffer submitted with
+        /// the frame, and saved by a worker thread once the frame is retired (see
+        /// Application::saveCapture()): the rendering never waits for it. When no
+        /// readback buffer is available, the capture is dropped (see
+        /// frameStatistics_t::nbDroppedCaptures).
+        uint32_t captureInterval = 0;
+
+        /// File format of the captured frames
+        captureFormat_t captureFormat = CAPTURE_FORMAT_PNG;
+
+        /// Prefix of the paths of the files containing the captured frames, followed by
+        /// the number of the frame and the extension (or only by the extension with
+        /// CAPTURE_FORMAT_Y4M)
+        std::string capturePrefix = "capture";
+
+        /// Number of readback buffers (the maximum number of captures being processed at
+        /// the same time)
+        uint32_t captureNbBuffers = 3;
+
+        /// Layout of the presented images at the end of the command buffers of the frames
+        /// (in which they are put back after the copy)
+        VkImageLayout captureImageLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        /// Frame rate written in the header of the Y4M file
+        uint32_t captureFrameRate = 60;
+
+        // Headless settings
+
+        /// Don't create any window nor surface: the frames are rendered into a ring of
+        /// offscreen color images (see 'headlessImageCount') standing in for the swap
+        /// chain, and paced by the fences only. The images have the size of the window
+        /// and can be used as color attachments or as the source of transfers. The
+        /// VK_KHR_swapchain device extension is only enabled if available, in which case
+        /// the render passes can still use VK_IMAGE_LAYOUT_PRESENT_SRC_KHR.
+        bool headless = false;
+
+        /// In headless mode, number of offscreen images (at least the number of frames
+        /// in flight)
+        uint32_t headlessImageCount = 3;
+
+        /// In headless mode, format of the offscreen images
+        VkFormat headlessImageFormat = VK_FORMAT_B8G8R8A8_SRGB;
+
+        /// In headless mode, number of frames to render before stopping the main loop
+        /// (0 to run until Application::close() is called)
+        uint64_t headlessNbFrames = 0;
+
+        // Dynamic resolution settings
+
+        /// Render the frames into internal images (see Application::getRenderImageViews()),
+        /// whose resolution adapts every few frames to keep the GPU time of the frames
+        /// under a budget, and scale them into the swap chain images with a blit. The
+        /// images must be left in the VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL layout by
+        /// the command buffers of the frame; the swap chain images are then put in
+        /// 'captureImageLayout'. Requires timestamp queries support, otherwise the
+        /// resolution stays at the maximum scale. Not supported by the render jobs.
+        bool useDynamicResolution = false;
+
+        /// GPU time budget of the frames (in seconds)
+        float dynamicResolutionBudget = 1.0f / 60.0f;
+
+        /// Minimum scale of the render resolution (relative to the presentation one)
+        float dynamicResolutionMinScale = 0.5f;
+
+        /// Maximum scale of the render resolution (relative to the presentation one)
+        float dynamicResolutionMaxScale = 1.0f;
+
+        /// Number of frames between two adjustments of the render resolution
+        uint32_t dynamicResolutionInterval = 8;
+
+        // Compute presentation settings
+
+        /// Write the swap chain images directly from compute shaders, as storage images
+        /// (through the views returned by Application::getRenderImageViews()), instead of
+        /// rendering into them with a render pass. The images are created with the
+        /// VK_IMAGE_USAGE_STORAGE_BIT usage (the surface must support it), a format
+        /// supporting it is preferred (see Application::chooseSwapSurfaceFormat()), and
+        /// the graphics queue must support compute. The images are in the
+        /// VK_IMAGE_LAYOUT_GENERAL layout during the execution of the command buffers of
+        /// the frame, then put in 'captureImageLayout'. Only the main window is concerned,
+        /// and can't be used with the dynamic resolution.
+        bool useComputePresentation = false;
+
+        // Multiview settings
+
+        /// Number of views rendered at once by the render passes using multiview
+        /// (VK_KHR_multiview, core in Vulkan 1.1), for instance 2 for stereo rendering (1
+        /// to not use multiview). When higher, the 'multiview' feature of 'features11' is
+        /// enabled and the device must support that many views. The color and depth
+        /// targets must then be layered images with one layer per view (see
+        /// Application::createImage() and Application::createImageView()), and the
+        /// render passes must be created with the masks returned by
+        /// Application::getMultiviewCreateInfo(). The shaders select the per-view data
+        /// (like the matrices) with gl_ViewIndex (GL_EXT_multiview).
+        uint32_t nbViews = 1;
+
+        // Physical device settings
+
+        /// Folder in which the capabilities of the physical devices are saved (one file
+        /// per device and driver version), so the next runs don't have to enumerate
+        /// their extensions, features and formats again (see
+        /// Application::getDeviceCapabilities()). The folder must exist. Empty to not
+        /// save them.
+        std::string capabilitiesCacheDir;
+
+        /// Physical device to use instead of the suitable one with the highest score
+        /// (see Application::rateDevice()): either its index in the list of devices,
+        /// its UUID (32 hexadecimal digits, dashes ignored) or a part of its name (case
+        /// insensitive). Overridden by the KNM_VK_DEVICE environment variable if set,
+        /// to force a device without rebuilding (for benchmarking for instance). The
+        /// device must be suitable. Empty to let the application choose.
+        std::string physicalDevice;
+
         /// Device extensions required by the application
         std::vector<const char*> deviceExtensions = {
             VK_KHR_SWAPCHAIN_EXTENSION_NAME,
@@ -284,6 +588,380 @@ namespace vk {
     };
 
 
+    //------------------------------------------------------------------------------------
+    /// @brief  Snapshot of the capabilities of a physical device (graphics card), gathered
+    ///         once (see Application::getDeviceCapabilities())
+    ///
+    /// The extensions, features, queue families, memory properties and format properties
+    /// can be saved to disk and reloaded by later runs (see
+    /// config_t::capabilitiesCacheDir). Immutable once created.
+    //------------------------------------------------------------------------------------
+    struct deviceCapabilities_t
+    {
+        /// Properties of the device
+        VkPhysicalDeviceProperties properties{};
+
+        /// UUID of the device (the pipeline cache UUID before Vulkan 1.1), used with the
+        /// driver version to identify the saved capabilities
+        uint8_t deviceUUID[VK_UUID_SIZE] = { 0 };
+
+        /// Maximum number of views in a multiview render pass (0 if multiview isn't
+        /// supported)
+        uint32_t maxMultiviewViewCount = 0;
+
+        /// Memory properties of the device
+        VkPhysicalDeviceMemoryProperties memoryProperties{};
+
+        /// Vulkan API 1.0 supported features
+        VkPhysicalDeviceFeatures features10{};
+
+#ifdef VK_API_VERSION_1_1
+        /// Vulkan API 1.1 supported features (pNext is always null)
+        VkPhysicalDeviceVulkan11Features features11{};
+#endif
+
+#ifdef VK_API_VERSION_1_2
+        /// Vulkan API 1.2 supported features (pNext is always null)
+        VkPhysicalDeviceVulkan12Features features12{};
+#endif
+
+#ifdef VK_API_VERSION_1_3
+        /// Vulkan API 1.3 supported features (pNext is always null)
+        VkPhysicalDeviceVulkan13Features features13{};
+#endif
+
+        /// Indicates if the 'presentId' feature (VK_KHR_present_id) is supported
+        bool presentIdSupported = false;
+
+        /// Indicates if the 'presentWait' feature (VK_KHR_present_wait) is supported
+        bool presentWaitSupported = false;
+
+        /// The supported device extensions
+        std::vector<VkExtensionProperties> extensions;
+
+        /// The queue families
+        std::vector<VkQueueFamilyProperties> queueFamilies;
+
+        /// Properties of the core Vulkan 1.0 formats, indexed by format (see
+        /// Application::getFormatProperties() for the other ones)
+        std::vector<VkFormatProperties> formats;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Indicates if a device extension is supported
+        //--------------------------------------------------------------------------------
+        bool hasExtension(const char* name) const;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Possible results of Application::tryBeginFrame()
+    //------------------------------------------------------------------------------------
+    enum frameStatus_t
+    {
+        /// The frame context and a swap chain image are available, the frame can be
+        /// rendered (see Application::endFrame())
+        FRAME_STATUS_READY,
+
+        /// The frame context or the swap chain image isn't available yet, try again later
+        FRAME_STATUS_NOT_READY,
+
+        /// The swap chain was out-of-date and was recreated, try again
+        FRAME_STATUS_SWAP_CHAIN_RECREATED,
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Contain the results of the benchmark of one combination of presentation
+    ///         mode and number of swap chain images (see
+    ///         config_t::benchmarkPresentationModes)
+    //------------------------------------------------------------------------------------
+    struct presentationBenchmarkResult_t
+    {
+        /// The presentation mode
+        VkPresentModeKHR presentationMode;
+
+        /// The number of images in the swap chain
+        uint32_t imageCount = 0;
+
+        /// Average duration of the frames (in seconds)
+        float frameTime = 0.0f;
+
+        /// Average time spent by the CPU between the sampling of the input state and the
+        /// submission of the frames (in seconds). Doesn't include the presentation.
+        float inputToSubmitLatency = 0.0f;
+
+        /// Average time between the submission of the frames and their presentation (in
+        /// seconds), only measured if 'submitToPresentMeasured' is set
+        float submitToPresentLatency = 0.0f;
+
+        /// Indicates if the presentation of the frames was waited for (see
+        /// config_t::usePresentWait), so 'submitToPresentLatency' is available
+        bool submitToPresentMeasured = false;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Contain all the objects used to process one frame-in-flight
+    ///
+    /// The Application class owns one of those for each frame-in-flight (see
+    /// config_t::nbFramesInFlight), the one used by the current frame being at index
+    /// 'currentFrame'. Its fence is waited for before the frame is rendered, so all the
+    /// objects it contains can safely be reused by the frame.
+    //------------------------------------------------------------------------------------
+    struct frameContext_t
+    {
+        /// Signaled when the swap chain image is available for rendering
+        VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;
+
+        /// Signaled when the rendering of the frame is done
+        VkSemaphore renderFinishedSemaphore = VK_NULL_HANDLE;
+
+        /// Signaled when the GPU has finished executing the command buffers of the frame
+        /// (not used when the completion of the frames is tracked with a timeline
+        /// semaphore)
+        VkFence inFlightFence = VK_NULL_HANDLE;
+
+        /// Number of the last frame submitted using this context (0 if none). When a
+        /// timeline semaphore is used, it is also the value signaled by the frame.
+        uint64_t frameNumber = 0;
+
+        /// Command pool (on the graphics queue family) dedicated to the frame, reset
+        /// each time the frame context is reused
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+
+        /// Resolution at which the frame is rendered (see config_t::useDynamicResolution)
+        VkExtent2D renderExtent = { 0, 0 };
+
+        /// Number of the last frame using this context whose GPU time was taken into
+        /// account (see config_t::useDynamicResolution)
+        uint64_t sampledFrameNumber = 0;
+
+        /// Regions of the frame that changed (see config_t::useDamageTracking)
+        std::vector<VkRect2D> damageRects;
+
+        /// Scratch area, that the user can freely use to store transient per-frame data
+        /// (see config_t::frameScratchSize)
+        std::vector<uint8_t> scratch;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Contain some statistics about the rendering of the frames
+    //------------------------------------------------------------------------------------
+    struct frameStatistics_t
+    {
+        /// Number of frames rendered since the start of the application
+        uint64_t nbFrames = 0;
+
+        /// Duration of the last frame (in seconds)
+        float frameTime = 0.0f;
+
+        /// Time spent by the CPU waiting for the frame context to be available during
+        /// the last frame (in seconds)
+        float waitTime = 0.0f;
+
+        /// Time spent in the simulation stage for the last frame (see
+        /// Application::simulate()), in seconds
+        float simulateTime = 0.0f;
+
+        /// Time spent in the recording stage for the last frame (see
+        /// Application::getCommandBuffers()), in seconds
+        float recordTime = 0.0f;
+
+        /// Time spent in the submission stage for the last frame (submission of the
+        /// command buffers and presentation), in seconds
+        float submitTime = 0.0f;
+
+        /// Time spent by the frame limiter and in the wait for the presentation of the
+        /// previous frame during the last frame (in seconds)
+        float pacingTime = 0.0f;
+
+        /// Moving average of the duration of the frames (in seconds)
+        float averageFrameTime = 0.0f;
+
+        /// Moving average of the absolute difference between the duration of the frames
+        /// and the target one (1 / config_t::targetFrameRate, or the average frame time
+        /// if there is no target), in seconds
+        float pacingJitter = 0.0f;
+
+        /// Time between the sampling of the input state and the submission of the last
+        /// frame (in seconds). The input state is considered sampled at the start of the
+        /// frame, or when Application::lateLatch() is called if config_t::useLateLatch
+        /// is set.
+        float inputToSubmitLatency = 0.0f;
+
+        /// Time between the submission of the previous frame and its presentation on
+        /// screen (in seconds). Only measured when the presentation of the frames is
+        /// waited for (see config_t::usePresentWait), 0 otherwise.
+        float submitToPresentLatency = 0.0f;
+
+        /// Number of frames captured and saved (see config_t::captureInterval)
+        uint64_t nbCapturedFrames = 0;
+
+        /// Number of captures dropped, because no readback buffer was available or the
+        /// frame couldn't be saved
+        uint64_t nbDroppedCaptures = 0;
+
+        /// Number of cursor and scroll events dropped because the rendering thread was
+        /// too late to process them (see config_t::useRenderThread). The other events are
+        /// never dropped.
+        uint64_t nbDroppedWindowEvents = 0;
+
+        /// GPU time of the last retired frame (in seconds, from the availability of its
+        /// swap chain image), only measured when the dynamic resolution is used (see
+        /// config_t::useDynamicResolution)
+        float gpuTime = 0.0f;
+
+        /// Current scale of the render resolution, relative to the presentation one
+        float resolutionScale = 1.0f;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Types of window events forwarded to the rendering thread
+    //------------------------------------------------------------------------------------
+    enum windowEventType_t
+    {
+        WINDOW_EVENT_FRAMEBUFFER_RESIZED,   ///< The framebuffer was resized ('width', 'height')
+        WINDOW_EVENT_KEY,                   ///< A key was pressed, repeated or released ('key', 'scancode', 'action', 'mods')
+        WINDOW_EVENT_MOUSE_BUTTON,          ///< A mouse button was pressed or released ('button', 'action', 'mods')
+        WINDOW_EVENT_CURSOR_POSITION,       ///< The cursor was moved ('x', 'y')
+        WINDOW_EVENT_SCROLL,                ///< The mouse wheel was used ('x', 'y')
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Contain the details about a window event (see
+    ///         config_t::useRenderThread)
+    ///
+    /// The meaning of the fields depends on the type of the event, and match the
+    /// parameters of the corresponding GLFW callback.
+    //------------------------------------------------------------------------------------
+    struct windowEvent_t
+    {
+        windowEventType_t type = WINDOW_EVENT_FRAMEBUFFER_RESIZED;  ///< Type of the event
+
+        int width = 0;      ///< Width of the framebuffer (in pixels)
+        int height = 0;     ///< Height of the framebuffer (in pixels)
+
+        int key = 0;        ///< Keyboard key
+        int scancode = 0;   ///< Platform-specific scancode of the key
+        int button = 0;     ///< Mouse button
+        int action = 0;     ///< GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+        int mods = 0;       ///< Modifier keys
+
+        double x = 0.0;     ///< Cursor position or scroll offset along the X axis
+        double y = 0.0;     ///< Cursor position or scroll offset along the Y axis
+
+        double time = 0.0;  ///< Time at which the event was received (see glfwGetTime())
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Contain a captured frame (see config_t::captureInterval)
+    //------------------------------------------------------------------------------------
+    struct frameCapture_t
+    {
+        /// Number of the frame
+        uint64_t frameNumber = 0;
+
+        /// Width of the image (in pixels)
+        uint32_t width = 0;
+
+        /// Height of the image (in pixels)
+        uint32_t height = 0;
+
+        /// Format of the image (4 bytes per pixel)
+        VkFormat format = VK_FORMAT_UNDEFINED;
+
+        /// The pixels (rows are tightly packed)
+        const uint8_t* data = nullptr;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Describe a render job: an image to render offscreen and save in a file
+    ///         (see Application::submitJob())
+    //------------------------------------------------------------------------------------
+    struct renderJob_t
+    {
+        /// Identifier of the job (assigned by Application::submitJob())
+        uint64_t id = 0;
+
+        /// Resolution of the image
+        VkExtent2D extent = { 256, 256 };
+
+        /// Format of the image (4 bytes per pixel, see frameCapture_t)
+        VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+
+        /// Path of the file to write, its format being deduced from the extension
+        /// ('.png' or '.ppm')
+        std::string outputPath;
+
+        /// Scene, camera, ... to render: defined by the user code (see
+        /// Application::recordJob())
+        std::shared_ptr<void> userData;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Offscreen image into which a render job is rendered
+    ///
+    /// The render targets are reused by the jobs with the same resolution and format, once
+    /// the frame that last used them is retired.
+    //------------------------------------------------------------------------------------
+    struct renderTarget_t
+    {
+        /// The image (usable as a color attachment and a transfer source)
+        VkImage image = VK_NULL_HANDLE;
+
+        /// Memory associated with the image
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+
+        /// View of the image
+        VkImageView imageView = VK_NULL_HANDLE;
+
+        /// Resolution of the image
+        VkExtent2D extent = { 0, 0 };
+
+        /// Format of the image
+        VkFormat format = VK_FORMAT_UNDEFINED;
+
+        /// Framebuffer created by the user code for the target (optional, see
+        /// Application::onRenderTargetCreated())
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+
+        /// Number of the last frame that used the target
+        uint64_t frameNumber = 0;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Contain some statistics about the execution of the render jobs (see
+    ///         Application::runJobs())
+    //------------------------------------------------------------------------------------
+    struct jobStatistics_t
+    {
+        /// Number of jobs submitted
+        uint64_t nbSubmittedJobs = 0;
+
+        /// Number of jobs rendered and saved
+        uint64_t nbCompletedJobs = 0;
+
+        /// Number of jobs rendered but which image couldn't be saved
+        uint64_t nbFailedJobs = 0;
+
+        /// Number of render targets created
+        uint32_t nbRenderTargets = 0;
+
+        /// Time elapsed since the start of the execution (in seconds)
+        float elapsedTime = 0.0f;
+
+        /// Number of jobs completed per second
+        float jobsPerSecond = 0.0f;
+    };
+
+
     // Indicates if the calidation layers must be used (only in debug builds)
 #ifdef NDEBUG
     const bool enableValidationLayers = false;
@@ -314,1927 +992,8859 @@ namespace vk {
     extern void onFramebufferWindowResized(GLFWwindow* window, int width, int height);
 
 
-    /******************************** APPLICATION CLASS *********************************/
+    //------------------------------------------------------------------------------------
+    /// @brief  Returns the name of a presentation mode
+    ///
+    /// @param  presentationMode    The presentation mode
+    ///
+    /// @returns                    The name
+    //------------------------------------------------------------------------------------
+    extern const char* getPresentationModeName(VkPresentModeKHR presentationMode);
+
 
     //------------------------------------------------------------------------------------
-    /// @brief  Handles all the setup of the window and Vulkan
+    /// @brief  Write a captured frame in a binary PPM file
     ///
-    /// The user must inherit from this class, and implement a few methods to create its own
-    /// Vulkan objects (render passes, graphics pipelines, framebuffers, vertex & index
-    /// buffers, command buffers, ...) and do the actual rendering.
+    /// @param  filename    Path to the file
+    /// @param  capture     The captured frame
+    ///
+    /// @returns            'false' if the file couldn't be written
     //------------------------------------------------------------------------------------
-    class Application
-    {
-    public:
-    /// @name Public methods
-    /// @{
-        //--------------------------------------------------------------------------------
-        /// @brief  Constructor
-        ///
-        /// Should you want to change any setting in the 'config' attribute, do it in the
-        /// constructor of your derived application class, before calling the run()
-        /// method.
-        //--------------------------------------------------------------------------------
-        Application();
+    extern bool writePPM(const std::string& filename, const frameCapture_t& capture);
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Run the application. Doesn't return until the window is closed.
-        //--------------------------------------------------------------------------------
-        void run();
-    /// @}
 
+    //------------------------------------------------------------------------------------
+    /// @brief  Write a captured frame in an (uncompressed) PNG file
+    ///
+    /// @param  filename    Path to the file
+    /// @param  capture     The captured frame
+    ///
+    /// @returns            'false' if the file couldn't be written
+    //------------------------------------------------------------------------------------
+    extern bool writePNG(const std::string& filename, const frameCapture_t& capture);
 
-        //_____ Methods to implement __________
-    protected:
-    /// @name Methods to implement
-    /// @{
-        //--------------------------------------------------------------------------------
-        /// @brief  Method called after everything was initialised (window, instance,
-        ///         logical device, swap chain), right before entering the main loop.
-        ///
-        /// Use it to create your own Vulkan objects (render passes, graphics pipelines,
-        /// vertex & index buffers, command buffers, ...).
-        ///
-        /// Application-specific, must be implemented by the user
-        //--------------------------------------------------------------------------------
-        virtual void createVulkanObjects() = 0;
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Method called after the swap chain was created (will happen each time
-        ///         the window is resized and at application startup).
-        ///
-        /// Use it to create your own Vulkan objects (like the framebuffers) that depends
-        /// on the swap chain (ie. the dimensions and number of its images).
-        ///
-        /// Application-specific, must be implemented by the user
-        //--------------------------------------------------------------------------------
-        virtual void onSwapChainReady() = 0;
+    //------------------------------------------------------------------------------------
+    /// @brief  Append a captured frame to a YUV4MPEG2 stream (4:4:4), whose header was
+    ///         already written
+    ///
+    /// @param  file        The stream
+    /// @param  capture     The captured frame
+    ///
+    /// @returns            'false' if the frame couldn't be written
+    //------------------------------------------------------------------------------------
+    extern bool writeY4MFrame(std::ofstream& file, const frameCapture_t& capture);
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Method called to retrieve the number of command buffers that need to be
-        ///         executed to render the current frame.
-        ///
-        /// Application-specific, must be implemented by the user
-        ///
-        /// @returns    The number of command buffers
-        //--------------------------------------------------------------------------------
-        virtual uint32_t getNbCommandBuffers() const = 0;
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Method called to retrieve the command buffers to execute to render the
-        ///         current frame.
-        ///
-        /// The number of those command buffers must correspond to the value returned by
-        /// getNbCommandBuffers().
-        ///
-        /// Application-specific, must be implemented by the user
-        ///
-        /// @param  elapsed     The time elapsed since the last call (in seconds)
-        /// @param  imageIndex  Index of the swap chain image to render to
-        ///
-        /// @param[out]  commandBuffers     The command buffers to execute to render the
-        ///                                 current frame.
-        //--------------------------------------------------------------------------------
-        virtual void getCommandBuffers(
-            float elapsed, uint32_t imageIndex, std::vector<VkCommandBuffer>& commandBuffers
-        ) = 0;
+    //------------------------------------------------------------------------------------
+    /// @brief  Contain all the informations needed by the present thread to present a
+    ///         frame (see config_t::usePresentThread)
+    //------------------------------------------------------------------------------------
+    struct presentRequest_t
+    {
+        /// The swap chain
+        VkSwapchainKHR swapChain = VK_NULL_HANDLE;
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Method called right before the swap chain destruction (will happen each
-        ///         time the window is resized and at application shutdown).
-        ///
-        /// Use it to destroy your own Vulkan objects (like the framebuffers) that depends
-        /// on the swap chain (ie. the dimensions and number of its images).
-        ///
-        /// Application-specific, must be implemented by the user
-        //--------------------------------------------------------------------------------
-        virtual void onSwapChainAboutToBeDestroyed() = 0;
+        /// Index of the swap chain image to present
+        uint32_t imageIndex = 0;
+
+        /// Semaphore to wait for before presenting the image
+        VkSemaphore waitSemaphore = VK_NULL_HANDLE;
+
+        /// Number of the frame
+        uint64_t frameNumber = 0;
+
+        /// ID of the presentation (0 if VK_KHR_present_id isn't used)
+        uint64_t presentId = 0;
+
+        /// Number of swap chains of additional windows to present with the main one
+        uint32_t nbAdditionalSwapChains = 0;
+
+        /// The swap chains of the additional windows
+        std::array<VkSwapchainKHR, MAX_NB_WINDOWS - 1> additionalSwapChains{};
+
+        /// Index of the image to present in each swap chain of the additional windows
+        std::array<uint32_t, MAX_NB_WINDOWS - 1> additionalImageIndices{};
+
+        /// Index of the additional window of each swap chain
+        std::array<uint32_t, MAX_NB_WINDOWS - 1> additionalWindowIndices{};
+
+        /// Number of regions of the image that changed (0 if the whole image changed, see
+        /// config_t::useDamageTracking)
+        uint32_t nbDamageRects = 0;
+
+        /// Regions of the image that changed
+        std::array<VkRect2D, MAX_NB_DAMAGE_RECTS> damageRects{};
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Contain all the informations about a frame going through the stages of the
+    ///         pipeline (see config_t::usePipelinedStages)
+    //------------------------------------------------------------------------------------
+    struct pipelinedFrame_t
+    {
+        /// Number of the frame
+        uint64_t frameNumber = 0;
+
+        /// Index of the frame context used by the frame
+        uint32_t frameIndex = 0;
+
+        /// Index of the swap chain image (set by the recording stage)
+        uint32_t imageIndex = 0;
+
+        /// The time elapsed since the last frame (in seconds)
+        float elapsed = 0.0f;
+
+        /// Time at which the input state was sampled (start of the simulation)
+        std::chrono::high_resolution_clock::time_point inputTime;
+
+        /// The command buffers to submit (set by the recording stage)
+        std::vector<VkCommandBuffer> commandBuffers;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Function called with the data copied from the GPU by
+    ///         Application::readbackBuffer() or Application::readbackImage()
+    ///
+    /// @param  data    The data (only valid during the call)
+    /// @param  size    Size of the data (in bytes)
+    //------------------------------------------------------------------------------------
+    typedef std::function<void(const void* data, VkDeviceSize size)> readbackCallback_t;
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Host-visible buffer into which the GPU copies some data to be read by the
+    ///         CPU (see Application::readbackBuffer())
+    //------------------------------------------------------------------------------------
+    struct readbackBuffer_t
+    {
+        /// The buffer
+        VkBuffer buffer = VK_NULL_HANDLE;
+
+        /// Memory associated with the buffer
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+
+        /// Size of the buffer
+        VkDeviceSize size = 0;
+
+        /// Mapped memory of the buffer
+        void* data = nullptr;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Readback buffer used to capture a frame (see config_t::captureInterval)
+    //------------------------------------------------------------------------------------
+    struct captureSlot_t
+    {
+        /// The buffer
+        VkBuffer buffer = VK_NULL_HANDLE;
+
+        /// Memory associated with the buffer
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+
+        /// Size of the buffer
+        VkDeviceSize size = 0;
+
+        /// Mapped memory of the buffer
+        void* data = nullptr;
+
+        /// Indicates if the buffer is used by a capture (from the copy of the image to
+        /// the saving of the frame)
+        bool used = false;
+
+        /// The captured frame
+        frameCapture_t capture;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Contain the window, surface and swap chain of an additional window (see
+    ///         config_t::additionalWindows)
+    ///
+    /// The images of the swap chain are created with the same usage as the main one, and
+    /// must be transitioned to the VK_IMAGE_LAYOUT_PRESENT_SRC_KHR layout by the command
+    /// buffers of the frame.
+    //------------------------------------------------------------------------------------
+    struct windowTarget_t
+    {
+        /// The window
+        GLFWwindow* window = nullptr;
+
+        /// Surface of the window
+        VkSurfaceKHR surface = VK_NULL_HANDLE;
 
+        /// The swap chain
+        VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+
+        /// Format of the images of the swap chain
+        VkFormat imageFormat = VK_FORMAT_UNDEFINED;
+
+        /// Extent of the images of the swap chain
+        VkExtent2D extent = { 0, 0 };
+
+        /// The images of the swap chain
+        std::vector<VkImage> images;
+
+        /// Views of the images of the swap chain
+        std::vector<VkImageView> imageViews;
+
+        /// Signaled when the image acquired by each frame-in-flight is available
+        std::array<VkSemaphore, MAX_NB_FRAMES_IN_FLIGHT> imageAvailableSemaphores{};
+
+        /// Index of the image acquired for the frame being rendered, UINT32_MAX if
+        /// nothing must be rendered in the window during this frame (because it is
+        /// minimized, or its swap chain is being recreated)
+        uint32_t imageIndex = UINT32_MAX;
+
+        /// Size of the framebuffer of the window
+        std::atomic<int> framebufferWidth = 0;
+        std::atomic<int> framebufferHeight = 0;
+
+        /// Indicates that the swap chain must be recreated
+        std::atomic<bool> outOfDate = false;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Swap chain replaced by a new one, kept alive with the objects depending on
+    ///         it until the frames in flight don't use them anymore
+    //------------------------------------------------------------------------------------
+    struct retiredSwapChain_t
+    {
+        /// The swap chain (VK_NULL_HANDLE in headless mode)
+        VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+
+        /// Number of the first frame rendered with the replacement, that must be
+        /// presented and retired before destroying anything
+        uint64_t frameNumber = 0;
+
+        /// Destroy the objects depending on the swap chain (see
+        /// Application::destroyWhenRetired())
+        std::vector<std::function<void()>> destructors;
+    };
+
+
+    /********************************* UTILITY CLASSES **********************************/
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Fixed-size lock-free queue, usable by one producer thread and one consumer
+    ///         thread
+    ///
+    /// @tparam T           Type of the items
+    /// @tparam CAPACITY    Maximum number of items in the queue
+    //------------------------------------------------------------------------------------
+    template<typename T, size_t CAPACITY>
+    class LockFreeQueue
+    {
+    public:
         //--------------------------------------------------------------------------------
-        /// @brief  Method called after exiting the main loop.
+        /// @brief  Add an item at the end of the queue (producer thread only)
         ///
-        /// Use it to destroy your own Vulkan objects (render passes, graphics pipelines,
-        /// framebuffers, vertex & index buffers, command buffers, ...).
-        ///
-        /// Application-specific, must be implemented by the user
+        /// @returns    'false' if the queue is full
         //--------------------------------------------------------------------------------
-        virtual void destroyVulkanObjects() = 0;
-    /// @}
+        bool push(const T& item)
+        {
+            size_t current = tail.load(std::memory_order_relaxed);
+            size_t next = (current + 1) % (CAPACITY + 1);
 
+            if (next == head.load(std::memory_order_acquire))
+                return false;
+
+            items[current] = item;
+            tail.store(next, std::memory_order_release);
+            return true;
+        }
 
-        //_____ High-level management methods __________
-    protected:
-    /// @name High-level management methods
-    /// @{
         //--------------------------------------------------------------------------------
-        /// @brief  Create the GLFW window
+        /// @brief  Remove the first item of the queue (consumer thread only)
         ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// @param[out] item    The item
+        ///
+        /// @returns    'false' if the queue is empty
         //--------------------------------------------------------------------------------
-        virtual void initWindow();
+        bool pop(T& item)
+        {
+            size_t current = head.load(std::memory_order_relaxed);
+
+            if (current == tail.load(std::memory_order_acquire))
+                return false;
+
+            item = items[current];
+            head.store((current + 1) % (CAPACITY + 1), std::memory_order_release);
+            return true;
+        }
 
         //--------------------------------------------------------------------------------
-        /// @brief  Initialise all the Vulkan objects (instance, logical device, swap
-        ///         chain)
-        ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// @brief  Indicates if the queue is empty
         //--------------------------------------------------------------------------------
-        virtual void initVulkan();
+        bool empty() const
+        {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
 
+    private:
+        std::array<T, CAPACITY + 1> items;
+        std::atomic<size_t> head = 0;
+        std::atomic<size_t> tail = 0;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  View over a fixed-capacity array of command buffers, filled by the user
+    ///         code of an ApplicationT
+    //------------------------------------------------------------------------------------
+    class CommandBufferSpan
+    {
+    public:
         //--------------------------------------------------------------------------------
-        /// @brief  Main loop, in charge of the rendering
+        /// @brief  Constructor
         ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// @param  storage     The array of command buffers
+        /// @param  capacity    Size of the array
         //--------------------------------------------------------------------------------
-        virtual void mainLoop();
+        CommandBufferSpan(VkCommandBuffer* storage, uint32_t capacity)
+        : storage(storage), nb(0), maxNb(capacity)
+        {
+        }
 
         //--------------------------------------------------------------------------------
-        /// @brief  Method called during the main loop, each time a new frame must be
-        ///         rendered.
-        ///
-        /// At a high level, rendering a frame in Vulkan consists of a common set of steps:
-        ///   - Wait for the previous frame to finish
-        ///   - Acquire an image from the swap chain
-        ///   - Record a command buffer which draws the scene onto that image
-        ///   - Submit the recorded command buffer
-        ///   - Present the swap chain image
-        ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
-        ///
-        /// @param  elapsed     The time elapsed since the last call (in seconds)
+        /// @brief  Add a command buffer at the end of the span
         //--------------------------------------------------------------------------------
-        virtual void drawFrame(float elapsed);
+        inline void push_back(VkCommandBuffer commandBuffer)
+        {
+            if (nb == maxNb)
+                throw std::runtime_error("Too many command buffers!");
+
+            storage[nb++] = commandBuffer;
+        }
 
         //--------------------------------------------------------------------------------
-        /// @brief  Destroy all the Vulkan objects (instance, logical device, swap chain)
-        ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// @brief  Remove all the command buffers
         //--------------------------------------------------------------------------------
-        virtual void cleanup();
-    /// @}
+        inline void clear()
+        {
+            nb = 0;
+        }
 
+        inline uint32_t size() const { return nb; }                 ///< Number of command buffers
+        inline uint32_t capacity() const { return maxNb; }          ///< Maximum number of command buffers
+        inline bool empty() const { return nb == 0; }               ///< Indicates if the span is empty
+        inline VkCommandBuffer* data() { return storage; }          ///< Pointer to the command buffers
+        inline VkCommandBuffer* begin() { return storage; }         ///< Iterator to the first command buffer
+        inline VkCommandBuffer* end() { return storage + nb; }      ///< Iterator past the last command buffer
 
-        //_____ Utility methods __________
+        /// Access a command buffer
+        inline VkCommandBuffer& operator[](uint32_t index) { return storage[index]; }
+
+    private:
+        VkCommandBuffer* storage;
+        uint32_t nb;
+        uint32_t maxNb;
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Queue with a limited capacity, usable by several threads, which blocks
+    ///         the producers when full and the consumers when empty
+    ///
+    /// @tparam T   Type of the items
+    //------------------------------------------------------------------------------------
+    template<typename T>
+    class BoundedQueue
+    {
     public:
-    /// @name Utility methods
-    /// @{
         //--------------------------------------------------------------------------------
-        /// @brief  Creates a shader module from its SPIR-V binary code
-        ///
-        /// @param  code    The SPIR-V binary code of the shader
-        ///
-        /// @returns        The shader module
+        /// @brief  Empty the queue, change its capacity and allow it to be used again
+        ///         after a call to stop()
         //--------------------------------------------------------------------------------
-        VkShaderModule createShaderModule(const std::vector<char>& code) const;
+        void reset(size_t capacity)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            items.clear();
+            this->capacity = capacity;
+            stopped = false;
+        }
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to create a buffer
+        /// @brief  Add an item at the end of the queue, waiting for some room if needed
         ///
-        /// @param  size        Size of the buffer
-        /// @param  usage       Usage flags
-        /// @param  properties  Memory properties
-        ///
-        /// @param[out] buffer          The created buffer
-        /// @param[out] bufferMemory    Memory associated with the buffer
+        /// @returns    'false' if the queue was stopped
         //--------------------------------------------------------------------------------
-        void createBuffer(
-            VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-            VkBuffer& buffer, VkDeviceMemory& bufferMemory
-        ) const;
+        bool push(T&& item)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stopped || (items.size() < capacity); });
+
+            if (stopped)
+                return false;
+
+            items.push_back(std::move(item));
+            condition.notify_all();
+            return true;
+        }
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to create an image
+        /// @brief  Remove the first item of the queue, waiting for one if needed
         ///
-        /// @param  width       Width of the image
-        /// @param  height      Height of the image
-        /// @param  mipLevels   Number of mipmap levels
-        /// @param  nbSamples   Number of samples to use
-        /// @param  format      Image format
-        /// @param  tiling      Tiling
-        /// @param  usage       Usage flags
-        /// @param  properties  Memory properties
+        /// @param[out] item    The item
         ///
-        /// @param[out] image           The created image
-        /// @param[out] imageMemory     Memory associated with the image
+        /// @returns    'false' if the queue was stopped
         //--------------------------------------------------------------------------------
-        void createImage(
-            uint32_t width, uint32_t height, uint32_t mipLevels,
-            VkSampleCountFlagBits nbSamples, VkFormat format, VkImageTiling tiling,
-            VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
-            VkImage& image, VkDeviceMemory& imageMemory
-        ) const;
+        bool pop(T& item)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stopped || !items.empty(); });
+
+            if (stopped)
+                return false;
+
+            item = std::move(items.front());
+            items.pop_front();
+            condition.notify_all();
+            return true;
+        }
 
         //--------------------------------------------------------------------------------
-        /// @brief  Creates an image view for an image
-        ///
-        /// @param  image       The image
-        /// @param  format      Image format
-        /// @param  aspectFlags Aspect flags
-        /// @param  mipLevels   Number of mipmap levels
-        ///
-        /// @returns    The image view
+        /// @brief  Wake up all the waiting threads, and prevent any further use of the
+        ///         queue
         //--------------------------------------------------------------------------------
-        VkImageView createImageView(
-            VkImage image, VkFormat format, VkImageAspectFlags aspectFlags,
-            uint32_t mipLevels
-        ) const;
+        void stop()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+            condition.notify_all();
+        }
+
+    private:
+        std::deque<T> items;
+        size_t capacity = 1;
+        bool stopped = false;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+
+    /****************************** DEVICE CONTEXT CLASS ********************************/
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Vulkan instance and logical device, which can be shared by several
+    ///         applications (see Application::setDeviceContext())
+    ///
+    /// Created by the first application, with its configuration (which must thus enable
+    /// all the extensions and features needed by the others). Each application keeps its
+    /// own window, surface, swap chain and frame synchronisation objects. The device and
+    /// the instance are destroyed with the last application using them.
+    //------------------------------------------------------------------------------------
+    class DeviceContext
+    {
+    public:
+        DeviceContext() = default;
+        DeviceContext(const DeviceContext&) = delete;
+        DeviceContext& operator=(const DeviceContext&) = delete;
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to copy data from a buffer to another
-        ///
-        /// For instance from a buffer on the CPU to one on the GPU.
-        ///
-        /// @param  commandPool The command pool to use to create a command buffer
-        /// @param  srcBuffer   The buffer to copy from
-        /// @param  dstBuffer   The buffer to copy to
-        /// @param  size        Size of the data to copy
+        /// @brief  Destructor, destroys the device and the instance
         //--------------------------------------------------------------------------------
-        void copyBuffer(
-            VkCommandPool commandPool, VkBuffer srcBuffer, VkBuffer dstBuffer,
-            VkDeviceSize size
-        ) const;
+        ~DeviceContext();
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Helper method to copy data from a buffer to an image
+    public:
+        /// The instance
+        VkInstance instance = VK_NULL_HANDLE;
+
+        /// Debug messenger (when validation layers are used)
+        VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
+
+        /// The physical device
+        VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+
+        /// The logical device
+        VkDevice device = VK_NULL_HANDLE;
+
+        /// Queue families of the queues
+        queueFamilyIndices_t queueFamilies;
+
+        /// Queue used for the graphics
+        VkQueue graphicsQueue = VK_NULL_HANDLE;
+
+        /// Queue used for the presentation
+        VkQueue presentationQueue = VK_NULL_HANDLE;
+
+        /// Must be locked to use the queues (submission, presentation, wait for idle)
+        std::mutex queueMutex;
+
+        /// Properties of the physical device
+        VkPhysicalDeviceProperties properties{};
+
+        /// Memory properties of the physical device
+        VkPhysicalDeviceMemoryProperties memoryProperties{};
+
+        /// Capabilities of the physical device
+        std::shared_ptr<const deviceCapabilities_t> capabilities;
+
+        /// Maximum number of samples usable for multisampling
+        VkSampleCountFlagBits msaaNbMaxSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        /// Indicates if the timeline semaphores are enabled on the device
+        bool timelineSemaphoreSupported = false;
+
+        /// Indicates if VK_KHR_present_id and VK_KHR_present_wait are enabled on the
+        /// device
+        bool presentWaitSupported = false;
+
+        /// Indicates if VK_KHR_incremental_present is enabled on the device
+        bool incrementalPresentSupported = false;
+    };
+
+
+    /******************************** APPLICATION CLASS *********************************/
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Handles all the setup of the window and Vulkan
+    ///
+    /// The user must inherit from this class, and implement a few methods to create its own
+    /// Vulkan objects (render passes, graphics pipelines, framebuffers, vertex & index
+    /// buffers, command buffers, ...) and do the actual rendering.
+    //------------------------------------------------------------------------------------
+    class Application
+    {
+    public:
+    /// @name Public methods
+    /// @{
+        //--------------------------------------------------------------------------------
+        /// @brief  Constructor
         ///
-        /// @param  commandPool The command pool to use to create a command buffer
-        /// @param  buffer      The buffer to copy from
-        /// @param  image       The image to copy to
-        /// @param  width       Width of the image
-        /// @param  height      Height of the image
+        /// Should you want to change any setting in the 'config' attribute, do it in the
+        /// constructor of your derived application class, before calling the run()
+        /// method.
         //--------------------------------------------------------------------------------
-        void copyBufferToImage(
-            VkCommandPool commandPool, VkBuffer buffer, VkImage image, uint32_t width,
-            uint32_t height
-        ) const;
+        Application();
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to handle layout transitions for images
+        /// @brief  Run the application. Doesn't return until the window is closed.
         ///
-        /// @param  commandPool The command pool to use to create a command buffer
-        /// @param  image       The image to transition
-        /// @param  format      Image format
-        /// @param  oldLayout   The layout to transition from
-        /// @param  newLayout   The layout to transition to
-        /// @param  mipLevels   Number of mipmap levels
+        /// Equivalent to calling init(), then the main loop, then shutdown().
         //--------------------------------------------------------------------------------
-        void transitionImageLayout(
-            VkCommandPool commandPool, VkImage image, VkFormat format,
-            VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels
-        ) const;
+        void run();
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to generate the mipmaps of a texture image
+        /// @brief  Create the window and initialise all the Vulkan objects, so the frames
+        ///         can be rendered one by one with runFrame()
         ///
-        /// @param  commandPool The command pool to use to create a command buffer
-        /// @param  image       The image
-        /// @param  format      Image format
-        /// @param  width       Width of the image
-        /// @param  height      Height of the image
-        /// @param  mipLevels   Number of mipmap levels
+        /// Use it (with runFrame() and shutdown()) instead of run() to drive the
+        /// application from your own loop.
         //--------------------------------------------------------------------------------
-        void generateMipmaps(
-            VkCommandPool commandPool, VkImage image, VkFormat format,
-            int32_t width, int32_t height, uint32_t mipLevels
-        ) const;
+        void init();
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to record commands to copy data from a buffer to another
+        /// @brief  Process the window events and render one frame
         ///
-        /// For instance from a buffer on the CPU to one on the GPU.
+        /// The swap chain is recreated if needed, like in the main loop. Must be called
+        /// from the main thread (the one that called init()). The threading settings
+        /// (config_t::useRenderThread, config_t::usePipelinedStages and the frame
+        /// pacing) don't apply, the caller being in charge of the scheduling. In
+        /// on-demand mode (see config_t::renderOnDemand), the frame is only rendered if
+        /// needed.
         ///
-        /// @param  commandBuffer   The command buffer to record our commands to
-        /// @param  srcBuffer       The buffer to copy from
-        /// @param  dstBuffer       The buffer to copy to
-        /// @param  size            Size of the data to copy
+        /// @param  elapsed     The time elapsed since the last frame (in seconds)
+        ///
+        /// @returns            'false' if the window was closed (or close() was called),
+        ///                     in which case shutdown() must be called
         //--------------------------------------------------------------------------------
-        void recordCopyBufferCommand(
-            VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer,
-            VkDeviceSize size
-        ) const;
+        bool runFrame(float elapsed);
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to record commands to copy data from a buffer to an image
+        /// @brief  Wait for all the frames to be done, then destroy all the Vulkan objects
+        ///         and the window
+        //--------------------------------------------------------------------------------
+        void shutdown();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Use the instance and device of another application instead of creating
+        ///         new ones
         ///
-        /// @param  commandBuffer   The command buffer to record our commands to
-        /// @param  buffer          The buffer to copy from
-        /// @param  image           The image to copy to
-        /// @param  width           Width of the image
-        /// @param  height          Height of the image
+        /// Must be called before init() (or run()), with the context of an initialised
+        /// application (see getDeviceContext()). The surface of the window must be
+        /// supported by the queues of the shared device. The submissions to the shared
+        /// queues are serialised.
+        ///
+        /// @param  context     The device context to use
         //--------------------------------------------------------------------------------
-        void recordCopyBufferToImageCommand(
-            VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, uint32_t width,
-            uint32_t height
-        ) const;
+        void setDeviceContext(const std::shared_ptr<DeviceContext>& context);
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to record commands to handle layout transitions for
-        ///         images
+        /// @brief  Returns the instance and device used by the application (only valid
+        ///         after init())
+        //--------------------------------------------------------------------------------
+        inline const std::shared_ptr<DeviceContext>& getDeviceContext() const
+        {
+            return deviceContext;
+        }
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the capabilities of the physical device used by the
+        ///         application (only valid after init())
+        //--------------------------------------------------------------------------------
+        inline const deviceCapabilities_t& getDeviceCapabilities() const
+        {
+            return *deviceCapabilities;
+        }
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the statistics about the rendering of the frames
         ///
-        /// @param  commandBuffer   The command buffer to record our commands to
-        /// @param  image           The image to transition
-        /// @param  format          Image format
-        /// @param  oldLayout       The layout to transition from
-        /// @param  newLayout       The layout to transition to
-        /// @param  mipLevels       Number of mipmap levels
+        /// A copy is returned, since the statistics are updated by several threads in
+        /// pipelined mode (see config_t::usePipelinedStages).
         //--------------------------------------------------------------------------------
-        void recordTransitionImageLayoutCommand(
-            VkCommandBuffer commandBuffer, VkImage image, VkFormat format,
-            VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels
-        ) const;
+        inline frameStatistics_t getFrameStatistics() const
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+            return statistics;
+        }
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to record commands to generate the mipmaps of a texture
-        ///         image
+        /// @brief  Returns the number of the last frame submitted to the GPU (frames are
+        ///         numbered from 1, 0 means that no frame was submitted yet)
         ///
-        /// @param  commandBuffer   The command buffer to record our commands to
-        /// @param  image           The image
-        /// @param  format          Image format
-        /// @param  width           Width of the image
-        /// @param  height          Height of the image
-        /// @param  mipLevels       Number of mipmap levels
+        /// Can be called from any thread.
         //--------------------------------------------------------------------------------
-        void recordGenerateMipmapsCommand(
-            VkCommandBuffer commandBuffer, VkImage image, VkFormat format,
-            int32_t width, int32_t height, uint32_t mipLevels
-        ) const;
+        inline uint64_t getLastSubmittedFrame() const
+        {
+            return lastSubmittedFrame.load();
+        }
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to create a command buffer destined to only be executed once.
+        /// @brief  Indicates if the GPU has finished executing a frame, without blocking
         ///
-        /// Call endSingleTimeCommands() once you have added your commands to the buffer
-        /// to execute them.
+        /// When the completion of the frames is tracked with a timeline semaphore (see
+        /// config_t::useTimelineSemaphore), this method can be called from any thread.
+        /// Otherwise it must be called from the thread rendering the frames.
         ///
-        /// @param  commandPool     The command pool to use to create the command buffer
+        /// @param  frameNumber     Number of the frame (see getLastSubmittedFrame())
         ///
-        /// @returns                The command buffer
+        /// @returns                'true' if the frame was retired
         //--------------------------------------------------------------------------------
-        VkCommandBuffer beginSingleTimeCommands(VkCommandPool commandPool) const;
+        bool isFrameRetired(uint64_t frameNumber) const;
 
         //--------------------------------------------------------------------------------
-        /// @brief  Helper method to execute and release a command buffer destined to only
-        ///         be executed once (created with beginSingleTimeCommands())
+        /// @brief  Wait until the GPU has finished executing a frame (and all the ones
+        ///         submitted before it)
         ///
-        /// @param  commandPool     The command pool used to create the command buffer
-        /// @param  commandBuffer   The command buffer to execute
+        /// Must be called from the thread rendering the frames.
+        ///
+        /// @param  frameNumber     Number of the frame (see getLastSubmittedFrame())
         //--------------------------------------------------------------------------------
-        void endSingleTimeCommands(
-            VkCommandPool commandPool, VkCommandBuffer commandBuffer
-        ) const;
+        void waitForFrame(uint64_t frameNumber);
 
         //--------------------------------------------------------------------------------
-        /// @brief  Returns the index of a memory on the physical device (graphics card)
-        ///         supporting the provided properties
+        /// @brief  Try to start the rendering of a new frame: wait for its frame context
+        ///         to be available and acquire an image from the swap chain, without
+        ///         blocking longer than the provided timeout
         ///
-        /// @param  typeFilter  Type of memory
-        /// @param  properties  Properties of the desired memory
+        /// When FRAME_STATUS_READY is returned, endFrame() must be called to render the
+        /// frame. Otherwise, the caller can do something else (like streaming some assets)
+        /// and try again later.
         ///
-        /// @returns            Index of the memory
+        /// Must be called from the thread rendering the frames.
+        ///
+        /// @param  timeout     Maximum time to wait for each of the operations (in
+        ///                     nanoseconds, 0 to not wait at all)
+        ///
+        /// @returns            The status of the frame
         //--------------------------------------------------------------------------------
-        uint32_t findMemoryType(
-            uint32_t typeFilter, VkMemoryPropertyFlags properties
-        ) const;
+        frameStatus_t tryBeginFrame(uint64_t timeout = 0);
 
         //--------------------------------------------------------------------------------
-        /// @brief  Returns the first image format supported by the physical device
-        ///         (graphics card) corresponding to the provided criteria
+        /// @brief  Render the frame started by a successful call to tryBeginFrame():
+        ///         retrieve the command buffers from the user code, then submit and
+        ///         present them
         ///
-        /// @param  candidates  Candidate image formats (in order of preference)
-        /// @param  tiling      Desired tiling of the image
-        /// @param  features    Desired features
+        /// Must be called from the thread rendering the frames.
         ///
-        /// @returns            The format
+        /// @param  elapsed     The time elapsed since the last frame (in seconds)
         //--------------------------------------------------------------------------------
-        VkFormat findSupportedFormat(
-            const std::vector<VkFormat>& candidates, VkImageTiling tiling,
-            VkFormatFeatureFlags features
-        ) const;
-    /// @}
-
+        void endFrame(float elapsed);
 
-        //_____ Instance-related methods __________
-    protected:
-    /// @name Instance-related methods
-    /// @{
         //--------------------------------------------------------------------------------
-        /// @brief  Initialize the Vulkan library by creating an instance. The instance is
-        ///         the connection between the application and the Vulkan library and
-        ///         creating it involves specifying some details about the application to
-        ///         the driver.
-        ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// @brief  Returns the results of the benchmark of the presentation modes (see
+        ///         config_t::benchmarkPresentationModes)
         //--------------------------------------------------------------------------------
-        virtual void createInstance();
+        inline const std::vector<presentationBenchmarkResult_t>& getPresentationBenchmarkResults() const
+        {
+            return benchmarkResults;
+        }
 
         //--------------------------------------------------------------------------------
-        /// @brief  Creates the surface to use to render to the GLFW window
+        /// @brief  Request the rendering of a new frame (see config_t::renderOnDemand)
         ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// Can be called from any thread.
         //--------------------------------------------------------------------------------
-        virtual void createSurface();
+        void requestRedraw();
 
         //--------------------------------------------------------------------------------
-        /// @brief  Returns the required list of extensions
+        /// @brief  Indicates that a region of the current frame changed (see
+        ///         config_t::useDamageTracking)
         ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// Must be called from getCommandBuffers(). If no region is added for a frame,
+        /// the whole image is considered as changed.
         ///
-        /// @returns    The list of extension
+        /// @param  rect    The region (in pixels, clamped to the swap chain extent)
         //--------------------------------------------------------------------------------
-        virtual std::vector<const char*> getRequiredExtensions() const;
-    /// @}
+        void addDamageRect(const VkRect2D& rect);
 
-
-        //_____ Physical devices __________
-    protected:
-    /// @name Physical devices
-    /// @{
         //--------------------------------------------------------------------------------
-        /// @brief  Select a graphics card in the system that supports the features we
-        ///         need. Use the first graphics card that suits our needs.
+        /// @brief  Returns the region of a swap chain image that must be re-rendered for
+        ///         the current frame (see config_t::useDamageTracking)
         ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// Must be called from getCommandBuffers(), after the regions that changed were
+        /// added with addDamageRect(). Since an image still contains the frame presented
+        /// with it a few frames ago, the region also covers the changes of the frames
+        /// rendered since then.
+        ///
+        /// The region is meant to be used as the render area of the render pass and as
+        /// the scissor; the render pass must then preserve the previous content of the
+        /// image (VK_ATTACHMENT_LOAD_OP_LOAD, with VK_IMAGE_LAYOUT_PRESENT_SRC_KHR as the
+        /// initial layout).
+        ///
+        /// @param  imageIndex  Index of the swap chain image
+        /// @returns            The region (the whole image if the damage isn't tracked, or
+        ///                     if the image is written by compute shaders)
         //--------------------------------------------------------------------------------
-        virtual void pickPhysicalDevice();
+        VkRect2D getDamageRect(uint32_t imageIndex);
 
         //--------------------------------------------------------------------------------
-        /// @brief  Indicates if a physical device/graphics card is suitable for our needs
+        /// @brief  Request the application to stop, like if the window was closed
         ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// Can be called from any thread. This is the only way to stop the main loop in
+        /// headless mode (see config_t::headless), unless a number of frames to render
+        /// was configured.
         //--------------------------------------------------------------------------------
-        virtual bool isDeviceSuitable(VkPhysicalDevice device) const;
+        void close();
 
         //--------------------------------------------------------------------------------
-        /// @brief  Search suitable queue families on a given physical device
+        /// @brief  Execute the render jobs: render all the jobs submitted with
+        ///         submitJob() until endJobs() (or close()) is called. Doesn't return
+        ///         until all the images are saved.
         ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// Replaces run() for batch rendering, on one device initialised only once.
+        /// Requires the headless mode (see config_t::headless). Up to
+        /// config_t::nbFramesInFlight jobs are in flight, each one using a frame context,
+        /// and the readback and saving of their images overlap with the rendering of the
+        /// next ones. The settings of the main loop (threading, pacing, ...) don't apply.
         //--------------------------------------------------------------------------------
-        virtual queueFamilyIndices_t findQueueFamilies(VkPhysicalDevice device) const;
+        void runJobs();
 
         //--------------------------------------------------------------------------------
-        /// @brief  Returns the required list of device extensions
+        /// @brief  Add a job to render by runJobs()
         ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// Can be called from any thread, before or during runJobs().
+        ///
+        /// @param  job     The job (its identifier is ignored)
+        ///
+        /// @returns        The identifier of the job
         //--------------------------------------------------------------------------------
-        virtual std::vector<const char*> getRequiredDeviceExtensions(
-            VkPhysicalDevice device
-        ) const;
+        uint64_t submitJob(const renderJob_t& job);
 
         //--------------------------------------------------------------------------------
-        /// @brief  Indicates if a physical device/graphics card supports the device
-        ///         extensions we need
+        /// @brief  Indicates that no more jobs will be submitted: runJobs() returns once
+        ///         the remaining ones are done
         ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// Can be called from any thread.
         //--------------------------------------------------------------------------------
-        virtual bool checkDeviceExtensionSupport(VkPhysicalDevice device) const;
+        void endJobs();
 
         //--------------------------------------------------------------------------------
-        /// @brief  Returns the maximum level of MSAA (multisample anti-aliasing)
-        ///         supported by the physical device
+        /// @brief  Returns the statistics about the execution of the render jobs
         //--------------------------------------------------------------------------------
-        VkSampleCountFlagBits getMaxUsableSampleCount() const;
+        inline const jobStatistics_t& getJobStatistics() const
+        {
+            return jobStatistics;
+        }
     /// @}
 
 
-        //_____ Logical devices __________
+        //_____ Methods to implement __________
     protected:
-    /// @name Logical devices
+    /// @name Methods to implement
     /// @{
         //--------------------------------------------------------------------------------
-        /// @brief  Setup a logical device to interface with a physical device, using
-        ///         queues
+        /// @brief  Method called after everything was initialised (window, instance,
+        ///         logical device, swap chain), right before entering the main loop.
         ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
+        /// Use it to create your own Vulkan objects (render passes, graphics pipelines,
+        /// vertex & index buffers, command buffers, ...).
+        ///
+        /// Application-specific, must be implemented by the user
         //--------------------------------------------------------------------------------
-        virtual void createLogicalDevice();
-    /// @}
-
+        virtual void createVulkanObjects() = 0;
 
-        //_____ Swap chain __________
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called after the swap chain was created (will happen each time
+        ///         the window is resized and at application startup).
+        ///
+        /// Use it to create your own Vulkan objects (like the framebuffers) that depends
+        /// on the swap chain (ie. the dimensions and number of its images).
+        ///
+        /// Application-specific, must be implemented by the user
+        //--------------------------------------------------------------------------------
+        virtual void onSwapChainReady() = 0;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called to retrieve the number of command buffers that need to be
+        ///         executed to render the current frame.
+        ///
+        /// Application-specific, must be implemented by the user
+        ///
+        /// @returns    The number of command buffers
+        //--------------------------------------------------------------------------------
+        virtual uint32_t getNbCommandBuffers() const = 0;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called to retrieve the command buffers to execute to render the
+        ///         current frame.
+        ///
+        /// The number of those command buffers must correspond to the value returned by
+        /// getNbCommandBuffers().
+        ///
+        /// Application-specific, must be implemented by the user
+        ///
+        /// @param  elapsed     The time elapsed since the last call (in seconds)
+        /// @param  imageIndex  Index of the swap chain image to render to
+        ///
+        /// @param[out]  commandBuffers     The command buffers to execute to render the
+        ///                                 current frame.
+        //--------------------------------------------------------------------------------
+        virtual void getCommandBuffers(
+            float elapsed, uint32_t imageIndex, std::vector<VkCommandBuffer>& commandBuffers
+        ) = 0;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called right before the command buffers of the current frame
+        ///         are submitted, if config_t::useLateLatch is set
+        ///
+        /// Use it to sample the latest input state (like the camera position) and write
+        /// it into some host-visible memory read by the command buffers, to minimise the
+        /// latency between the input and the presentation of the frame. Nothing that
+        /// would require to record the command buffers again can be changed here.
+        ///
+        /// Optional, the default implementation does nothing.
+        ///
+        /// @param  elapsed     The time elapsed since the last frame (in seconds)
+        /// @param  imageIndex  Index of the swap chain image to render to
+        //--------------------------------------------------------------------------------
+        virtual void lateLatch(float elapsed, uint32_t imageIndex);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called before the command buffers of a frame are recorded, to
+        ///         update the state of the application (animations, physics, ...)
+        ///
+        /// In pipelined mode (see config_t::usePipelinedStages), it is called on its own
+        /// thread, concurrently with the recording of the previous frame: the state read
+        /// by getCommandBuffers() must thus be stored per frame context. The frame
+        /// context isn't used by the recording stage anymore when this method is called.
+        ///
+        /// Optional, the default implementation does nothing.
+        ///
+        /// @param  elapsed     The time elapsed since the last frame (in seconds)
+        /// @param  frameIndex  Index of the frame context that will be used to render the
+        ///                     frame
+        //--------------------------------------------------------------------------------
+        virtual void simulate(float elapsed, uint32_t frameIndex);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called to record the rendering of a job (see runJobs())
+        ///
+        /// The image of the render target must be fully written (its previous content
+        /// is undefined), and left in the VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL layout
+        /// (for instance as the final layout of the render pass). The per-frame objects
+        /// (like uniform buffers) of the frame context aren't used by the GPU anymore.
+        ///
+        /// Must be implemented by the user to execute render jobs.
+        ///
+        /// @param  job             The job
+        /// @param  target          The render target
+        /// @param  frameIndex      Index of the frame context used by the job
+        /// @param  commandBuffer   The command buffer (in the recording state)
+        //--------------------------------------------------------------------------------
+        virtual void recordJob(
+            const renderJob_t& job, const renderTarget_t& target, uint32_t frameIndex,
+            VkCommandBuffer commandBuffer
+        );
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called after a render target was created
+        ///
+        /// Use it to create your own Vulkan objects (like a framebuffer) that depends on
+        /// the render target.
+        ///
+        /// Optional, the default implementation does nothing.
+        ///
+        /// @param  target      The render target
+        //--------------------------------------------------------------------------------
+        virtual void onRenderTargetCreated(renderTarget_t& target);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called right before a render target is destroyed (at
+        ///         application shutdown)
+        ///
+        /// Optional, the default implementation does nothing.
+        ///
+        /// @param  target      The render target
+        //--------------------------------------------------------------------------------
+        virtual void onRenderTargetAboutToBeDestroyed(renderTarget_t& target);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called right before the swap chain destruction (will happen each
+        ///         time the window is resized and at application shutdown).
+        ///
+        /// Use it to destroy your own Vulkan objects (like the framebuffers) that depends
+        /// on the swap chain (ie. the dimensions and number of its images). Since they
+        /// might still be used by the frames in flight, destroy them with
+        /// destroyWhenRetired().
+        ///
+        /// Application-specific, must be implemented by the user
+        //--------------------------------------------------------------------------------
+        virtual void onSwapChainAboutToBeDestroyed() = 0;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called after the swap chain of an additional window was created
+        ///         (see config_t::additionalWindows)
+        ///
+        /// Use it to create your own Vulkan objects (like the framebuffers) that depends
+        /// on this swap chain (see windowTargets).
+        ///
+        /// Optional, the default implementation does nothing.
+        ///
+        /// @param  windowIndex     Index of the additional window
+        //--------------------------------------------------------------------------------
+        virtual void onWindowSwapChainReady(uint32_t windowIndex);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called right before the swap chain of an additional window is
+        ///         destroyed (when it is resized and at application shutdown)
+        ///
+        /// The objects depending on the swap chain must be destroyed with
+        /// destroyWhenRetired().
+        ///
+        /// Optional, the default implementation does nothing.
+        ///
+        /// @param  windowIndex     Index of the additional window
+        //--------------------------------------------------------------------------------
+        virtual void onWindowSwapChainAboutToBeDestroyed(uint32_t windowIndex);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called after exiting the main loop.
+        ///
+        /// Use it to destroy your own Vulkan objects (render passes, graphics pipelines,
+        /// framebuffers, vertex & index buffers, command buffers, ...).
+        ///
+        /// Application-specific, must be implemented by the user
+        //--------------------------------------------------------------------------------
+        virtual void destroyVulkanObjects() = 0;
+    /// @}
+
+
+        //_____ High-level management methods __________
     protected:
-    /// @name Swap chain
+    /// @name High-level management methods
     /// @{
         //--------------------------------------------------------------------------------
-        /// @brief  Create the swap chain
+        /// @brief  Create the GLFW window
         ///
         /// Can be overriden by the user if the default implementation doesn't fulfill its
         /// needs.
         //--------------------------------------------------------------------------------
-        virtual void createSwapChain();
+        virtual void initWindow();
 
         //--------------------------------------------------------------------------------
-        /// @brief  Destroy all the objects related to the swap chain
+        /// @brief  Initialise all the Vulkan objects (instance, logical device, swap
+        ///         chain)
         ///
         /// Can be overriden by the user if the default implementation doesn't fulfill its
         /// needs.
         //--------------------------------------------------------------------------------
-        virtual void cleanupSwapChain();
+        virtual void initVulkan();
 
         //--------------------------------------------------------------------------------
-        /// @brief  This method must called each time the window is resized, to recreate
-        ///         the swap chain and objects that depend on it or the window size
+        /// @brief  Main loop, in charge of the rendering
         ///
         /// Can be overriden by the user if the default implementation doesn't fulfill its
         /// needs.
         //--------------------------------------------------------------------------------
-        virtual void recreateSwapChain();
+        virtual void mainLoop();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Render some frames with each combination of presentation mode and
+        ///         number of swap chain images supported by the device, and measure their
+        ///         frame time and latency (see config_t::benchmarkPresentationModes and
+        ///         getPresentationBenchmarkResults())
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void benchmarkPresentationModes();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called during the main loop, each time a new frame must be
+        ///         rendered.
+        ///
+        /// At a high level, rendering a frame in Vulkan consists of a common set of steps:
+        ///   - Wait for the previous frame to finish
+        ///   - Acquire an image from the swap chain
+        ///   - Record a command buffer which draws the scene onto that image
+        ///   - Submit the recorded command buffer
+        ///   - Present the swap chain image
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        ///
+        /// @param  elapsed     The time elapsed since the last call (in seconds)
+        //--------------------------------------------------------------------------------
+        virtual void drawFrame(float elapsed);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Method called on the rendering thread for each window event, before a
+        ///         new frame is rendered
+        ///
+        /// Only used when the frames are rendered on a dedicated thread (see
+        /// config_t::useRenderThread). The resizing of the framebuffer is handled
+        /// automatically.
+        ///
+        /// Can be overriden by the user to process the events. The default
+        /// implementation does nothing.
+        ///
+        /// @param  event   The event
+        //--------------------------------------------------------------------------------
+        virtual void onWindowEvent(const windowEvent_t& event);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Rendering loop executed by the dedicated rendering thread (see
+        ///         config_t::useRenderThread)
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void renderLoop();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Wait for a frame context to be available, acquire an image from the
+        ///         swap chain and reset the objects of the frame context
+        ///
+        /// @param  frameIndex          Index of the frame context
+        /// @param  timeout             Maximum time to wait for each of the operations (in
+        ///                             nanoseconds)
+        /// @param[out] imageIndex      Index of the acquired image
+        ///
+        /// @returns    VK_SUCCESS or VK_SUBOPTIMAL_KHR if the frame can be rendered,
+        ///             VK_TIMEOUT or VK_NOT_READY if not available yet,
+        ///             VK_ERROR_OUT_OF_DATE_KHR if the swap chain must be recreated
+        //--------------------------------------------------------------------------------
+        VkResult acquireFrame(uint32_t frameIndex, uint64_t timeout, uint32_t& imageIndex);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Acquire an image from a swap chain
+        ///
+        /// When the swap chains are also used by another thread (present thread or
+        /// pipelined stages), the accesses are serialised with it. The image is then
+        /// acquired with short timeouts, releasing the lock between the attempts, so the
+        /// other thread can present the image the acquisition might be waiting for.
+        ///
+        /// @param  swapChain           The swap chain
+        /// @param  timeout             Maximum time to wait (in nanoseconds)
+        /// @param  semaphore           Semaphore to signal when the image is available
+        /// @param[out] imageIndex      Index of the acquired image
+        ///
+        /// @returns    The result of vkAcquireNextImageKHR()
+        //--------------------------------------------------------------------------------
+        VkResult acquireSwapChainImage(
+            VkSwapchainKHR swapChain, uint64_t timeout, VkSemaphore semaphore,
+            uint32_t& imageIndex
+        );
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Submit the command buffers of a frame, and present it
+        ///
+        /// @param  frameIndex          Index of the frame context
+        /// @param  imageIndex          Index of the swap chain image
+        /// @param  commandBuffers      The command buffers to submit
+        /// @param  nbCommandBuffers    The number of command buffers
+        /// @param  elapsed             The time elapsed since the last frame (in seconds)
+        /// @param  inputTime           Time at which the input state was sampled
+        ///
+        /// @returns    The result of the presentation
+        //--------------------------------------------------------------------------------
+        VkResult submitFrame(
+            uint32_t frameIndex, uint32_t imageIndex,
+            const VkCommandBuffer* commandBuffers, uint32_t nbCommandBuffers, float elapsed,
+            std::chrono::high_resolution_clock::time_point inputTime
+        );
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Present an image of the swap chain
+        ///
+        /// Called either by the rendering thread or by the present thread (see
+        /// config_t::usePresentThread).
+        ///
+        /// @param  request     Informations about the image to present
+        ///
+        /// @returns    The result of vkQueuePresentKHR()
+        //--------------------------------------------------------------------------------
+        VkResult presentFrame(const presentRequest_t& request);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Update the regions of the swap chain images that must be re-rendered
+        ///         with the damage of a submitted frame, and pass it to the presentation
+        ///         (see config_t::useDamageTracking)
+        ///
+        /// @param  frameIndex  Index of the frame context
+        /// @param  imageIndex  Index of the swap chain image
+        /// @param  request     Presentation request of the frame
+        //--------------------------------------------------------------------------------
+        void trackFrameDamage(uint32_t frameIndex, uint32_t imageIndex, presentRequest_t& request);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Loop executed by the present thread (see config_t::usePresentThread)
+        //--------------------------------------------------------------------------------
+        void presentLoop();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Start the present thread (if needed, see config_t::usePresentThread)
+        //--------------------------------------------------------------------------------
+        void startPresentThread();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Stop the present thread, after all the pending presentations are done
+        //--------------------------------------------------------------------------------
+        void stopPresentThread();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Save a captured frame (see config_t::captureInterval)
+        ///
+        /// Called by the readback thread. The default implementation writes the frame in
+        /// a file, in the format indicated by config_t::captureFormat.
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        ///
+        /// @param  capture     The captured frame
+        ///
+        /// @returns            'false' if the frame couldn't be saved
+        //--------------------------------------------------------------------------------
+        virtual bool saveCapture(const frameCapture_t& capture);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Save the image rendered by a job
+        ///
+        /// Called by the readback thread. The default implementation writes the image in
+        /// the file indicated by the job, in the format corresponding to its extension.
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        ///
+        /// @param  job     The job
+        /// @param  image   The rendered image
+        ///
+        /// @returns        'false' if the image couldn't be saved
+        //--------------------------------------------------------------------------------
+        virtual bool saveJobOutput(const renderJob_t& job, const frameCapture_t& image);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Wait for a job to render
+        ///
+        /// @param[out] job     The job
+        ///
+        /// @returns            'false' if there is no more jobs (or the application
+        ///                     must stop)
+        //--------------------------------------------------------------------------------
+        bool waitForJob(renderJob_t& job);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Record and submit the rendering of a job, in the next frame context,
+        ///         followed by the readback of its image
+        //--------------------------------------------------------------------------------
+        void processJob(const renderJob_t& job);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Retrieve a render target not used by the GPU anymore, creating it if
+        ///         needed
+        ///
+        /// @param  extent  Resolution of the image
+        /// @param  format  Format of the image
+        ///
+        /// @returns        Index of the render target
+        //--------------------------------------------------------------------------------
+        size_t acquireRenderTarget(VkExtent2D extent, VkFormat format);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Destroy all the render targets
+        //--------------------------------------------------------------------------------
+        void destroyRenderTargets();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Update the statistics about the execution of the render jobs
+        //--------------------------------------------------------------------------------
+        void updateJobStatistics();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Record a command buffer copying the image of a frame into a free
+        ///         readback buffer (see config_t::captureInterval)
+        ///
+        /// @param  frame           Context of the frame (the command buffer is allocated
+        ///                         from its command pool)
+        /// @param  imageIndex      Index of the swap chain image
+        /// @param  frameNumber     Number of the frame
+        ///
+        /// @param[out] commandBuffer   The command buffer to submit with the frame
+        ///
+        /// @returns                'false' if the capture was dropped
+        //--------------------------------------------------------------------------------
+        bool recordFrameCapture(
+            frameContext_t& frame, uint32_t imageIndex, uint64_t frameNumber,
+            VkCommandBuffer& commandBuffer
+        );
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Save the frame captured in a readback buffer (called by the readback
+        ///         thread)
+        ///
+        /// @param  slotIndex   Index of the readback buffer
+        //--------------------------------------------------------------------------------
+        void saveCaptureSlot(uint32_t slotIndex);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Check that the frames can be captured, and prepare the readback buffers
+        ///         (if needed, see config_t::captureInterval)
+        //--------------------------------------------------------------------------------
+        void setupFrameCapture();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Record the copy of some data into a readback buffer, and register the
+        ///         task delivering it once the frame being rendered is retired
+        ///
+        /// @param  commandBuffer   The command buffer (in the recording state)
+        /// @param  size            Size of the data
+        /// @param  recordCopy      Function recording the copy into the provided buffer
+        /// @param  callback        Function called with the data (optional)
+        ///
+        /// @returns                The future data
+        //--------------------------------------------------------------------------------
+        std::future<std::vector<uint8_t>> recordReadback(
+            VkCommandBuffer commandBuffer, VkDeviceSize size,
+            const std::function<void(VkBuffer)>& recordCopy,
+            const readbackCallback_t& callback
+        );
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Retrieve an unused readback buffer of at least the provided size,
+        ///         creating it if needed
+        //--------------------------------------------------------------------------------
+        readbackBuffer_t acquireReadbackBuffer(VkDeviceSize size);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Make a readback buffer available for reuse
+        //--------------------------------------------------------------------------------
+        void releaseReadbackBuffer(const readbackBuffer_t& readback);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Hand the readbacks (and captures) of the retired frames to the readback
+        ///         thread
+        ///
+        /// @param  frameNumber     Number of the last frame known to be retired
+        //--------------------------------------------------------------------------------
+        void retireReadbacks(uint64_t frameNumber);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Loop executed by the readback thread, which saves the captured frames
+        ///         and delivers the data of the readbacks
+        //--------------------------------------------------------------------------------
+        void readbackLoop();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Start the readback thread (if not already running)
+        //--------------------------------------------------------------------------------
+        void startReadbackThread();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Stop the readback thread, after all the pending readbacks are done
+        ///
+        /// All the frames must be retired.
+        //--------------------------------------------------------------------------------
+        void stopReadbackThread();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Destroy the readback buffers (including the ones used by the frame
+        ///         capture)
+        //--------------------------------------------------------------------------------
+        void destroyReadbackBuffers();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Wait until the present thread has presented a frame (returns
+        ///         immediately if the present thread isn't used)
+        ///
+        /// @param  frameNumber     Number of the frame
+        //--------------------------------------------------------------------------------
+        void waitForPresentation(uint64_t frameNumber);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Wait until the next frame can be started, according to the frame
+        ///         pacing settings (see config_t::targetFrameRate and
+        ///         config_t::usePresentWait)
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void waitForNextFrame();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  In on-demand mode, block until a new frame must be rendered (see
+        ///         config_t::renderOnDemand)
+        ///
+        /// @returns    'true' if a new frame must be rendered
+        //--------------------------------------------------------------------------------
+        bool waitForRedrawRequest();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Loop of the simulation stage (see config_t::usePipelinedStages)
+        //--------------------------------------------------------------------------------
+        void simulateLoop();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Loop of the recording stage (see config_t::usePipelinedStages)
+        //--------------------------------------------------------------------------------
+        void recordLoop();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Loop of the submission stage (see config_t::usePipelinedStages)
+        //--------------------------------------------------------------------------------
+        void submitLoop();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Stop all the stages of the pipeline (see config_t::usePipelinedStages)
+        //--------------------------------------------------------------------------------
+        void stopPipeline();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Update the statistics related to the duration of the frames
+        ///
+        /// @param  elapsed     The time elapsed since the last frame (in seconds)
+        //--------------------------------------------------------------------------------
+        void updateFrameStatistics(float elapsed);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Render one frame, if the user provides some command buffers
+        ///
+        /// The default implementation calls drawFrame(). Overriden by ApplicationT to
+        /// retrieve the command buffers without virtual calls.
+        ///
+        /// @param  elapsed     The time elapsed since the last call (in seconds)
+        ///
+        /// @returns            'false' if there was nothing to render
+        //--------------------------------------------------------------------------------
+        virtual bool renderFrame(float elapsed);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Submit and present the command buffers of the current frame (started
+        ///         by tryBeginFrame()), then recreate the swap chain if needed
+        ///
+        /// @param  elapsed             The time elapsed since the last call (in seconds)
+        /// @param  commandBuffers      The command buffers to submit
+        /// @param  nbCommandBuffers    The number of command buffers
+        /// @param  recordStart         Time at which the recording of the command buffers
+        ///                             started
+        //--------------------------------------------------------------------------------
+        void finishFrame(
+            float elapsed, const VkCommandBuffer* commandBuffers, uint32_t nbCommandBuffers,
+            std::chrono::high_resolution_clock::time_point recordStart
+        );
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Render one frame (if the user provides some command buffers) and
+        ///         update the statistics
+        ///
+        /// @param  elapsed     The time elapsed since the last call (in seconds)
+        //--------------------------------------------------------------------------------
+        void processFrame(float elapsed);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Forward the window events received from the main thread to
+        ///         onWindowEvent()
+        //--------------------------------------------------------------------------------
+        void processWindowEvents();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Retrieve the size of the framebuffer of the window (in pixels), from any
+        ///         thread
+        ///
+        /// @param[out] width   Width of the framebuffer
+        /// @param[out] height  Height of the framebuffer
+        //--------------------------------------------------------------------------------
+        void getFramebufferSize(int& width, int& height) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Indicates if the window was closed or close() was called
+        //--------------------------------------------------------------------------------
+        bool shouldClose() const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Process the pending window events (does nothing in headless mode)
+        //--------------------------------------------------------------------------------
+        void pollEvents();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Wait for some window events (or, in headless mode, for a call to
+        ///         postEmptyEvent()) and process them
+        ///
+        /// @param  timeout     Maximum time to wait (in seconds, negative to wait
+        ///                     indefinitely)
+        //--------------------------------------------------------------------------------
+        void waitEvents(double timeout);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Wake up the main thread if it is waiting in waitEvents()
+        ///
+        /// Can be called from any thread.
+        //--------------------------------------------------------------------------------
+        void postEmptyEvent();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Destroy all the Vulkan objects (instance, logical device, swap chain)
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void cleanup();
+    /// @}
+
+
+        //_____ Utility methods __________
+    public:
+    /// @name Utility methods
+    /// @{
+        //--------------------------------------------------------------------------------
+        /// @brief  Creates a shader module from its SPIR-V binary code
+        ///
+        /// @param  code    The SPIR-V binary code of the shader
+        ///
+        /// @returns        The shader module
+        //--------------------------------------------------------------------------------
+        VkShaderModule createShaderModule(const std::vector<char>& code) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to create a buffer
+        ///
+        /// @param  size        Size of the buffer
+        /// @param  usage       Usage flags
+        /// @param  properties  Memory properties
+        ///
+        /// @param[out] buffer          The created buffer
+        /// @param[out] bufferMemory    Memory associated with the buffer
+        //--------------------------------------------------------------------------------
+        void createBuffer(
+            VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+            VkBuffer& buffer, VkDeviceMemory& bufferMemory
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to create a buffer into which the GPU can copy some data
+        ///         to be read by the CPU
+        ///
+        /// Host-cached memory is used if available (host-coherent memory otherwise), and
+        /// stays mapped. Use vkInvalidateMappedMemoryRanges() before reading it.
+        ///
+        /// @param  size        Size of the buffer
+        ///
+        /// @param[out] buffer          The created buffer
+        /// @param[out] bufferMemory    Memory associated with the buffer
+        /// @param[out] data            The mapped memory
+        //--------------------------------------------------------------------------------
+        void createReadbackBuffer(
+            VkDeviceSize size, VkBuffer& buffer, VkDeviceMemory& bufferMemory, void*& data
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Record the copy of (a part of) a buffer into host memory, and retrieve
+        ///         the data once the frame is retired, without blocking
+        ///
+        /// The command buffer must be submitted with the frame being rendered (ie. be one
+        /// of the command buffers returned by getCommandBuffers()). All the previous
+        /// writes are made visible to the copy. The data is copied into host-cached
+        /// memory if available, invalidated before being read.
+        ///
+        /// The data is delivered by the readback thread, either to the callback (if any),
+        /// or as a copy in the returned future. Never wait for the future on the thread
+        /// rendering the frames before the frame is retired (see waitForFrame()).
+        ///
+        /// @param  commandBuffer   The command buffer (in the recording state)
+        /// @param  buffer          The buffer to read
+        /// @param  offset          Offset of the data in the buffer
+        /// @param  size            Size of the data
+        /// @param  callback        Function called with the data (in that case the
+        ///                         future contains an empty vector)
+        ///
+        /// @returns                The future data
+        //--------------------------------------------------------------------------------
+        std::future<std::vector<uint8_t>> readbackBuffer(
+            VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset,
+            VkDeviceSize size, const readbackCallback_t& callback = nullptr
+        );
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Record the copy of an image into host memory, and retrieve the pixels
+        ///         once the frame is retired, without blocking
+        ///
+        /// Same as readbackBuffer(), for the first mip level and layer of an image. The
+        /// rows of pixels are tightly packed.
+        ///
+        /// @param  commandBuffer   The command buffer (in the recording state)
+        /// @param  image           The image to read
+        /// @param  layout          Layout of the image (VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+        ///                         or VK_IMAGE_LAYOUT_GENERAL)
+        /// @param  width           Width of the image
+        /// @param  height          Height of the image
+        /// @param  bytesPerPixel   Size of a pixel (in bytes)
+        /// @param  aspectFlags     Aspect of the image to read
+        /// @param  callback        Function called with the pixels (in that case the
+        ///                         future contains an empty vector)
+        ///
+        /// @returns                The future pixels
+        //--------------------------------------------------------------------------------
+        std::future<std::vector<uint8_t>> readbackImage(
+            VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout,
+            uint32_t width, uint32_t height, uint32_t bytesPerPixel,
+            VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT,
+            const readbackCallback_t& callback = nullptr
+        );
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to create an image
+        ///
+        /// @param  width       Width of the image
+        /// @param  height      Height of the image
+        /// @param  mipLevels   Number of mipmap levels
+        /// @param  nbSamples   Number of samples to use
+        /// @param  format      Image format
+        /// @param  tiling      Tiling
+        /// @param  usage       Usage flags
+        /// @param  properties  Memory properties
+        ///
+        /// @param[out] image           The created image
+        /// @param[out] imageMemory     Memory associated with the image
+        ///
+        /// @param  nbLayers    Number of layers (one per view for the targets of a
+        ///                     multiview render pass, see config_t::nbViews)
+        //--------------------------------------------------------------------------------
+        void createImage(
+            uint32_t width, uint32_t height, uint32_t mipLevels,
+            VkSampleCountFlagBits nbSamples, VkFormat format, VkImageTiling tiling,
+            VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
+            VkImage& image, VkDeviceMemory& imageMemory, uint32_t nbLayers = 1
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Creates an image view for an image
+        ///
+        /// @param  image       The image
+        /// @param  format      Image format
+        /// @param  aspectFlags Aspect flags
+        /// @param  mipLevels   Number of mipmap levels
+        /// @param  nbLayers    Number of layers (an array view is created if higher than
+        ///                     1)
+        ///
+        /// @returns    The image view
+        //--------------------------------------------------------------------------------
+        VkImageView createImageView(
+            VkImage image, VkFormat format, VkImageAspectFlags aspectFlags,
+            uint32_t mipLevels, uint32_t nbLayers = 1
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the informations needed to create a multiview render pass
+        ///         (see config_t::nbViews), to chain to VkRenderPassCreateInfo::pNext
+        ///
+        /// The single subpass renders all the views, which are correlated (rendered from
+        /// close points of view).
+        //--------------------------------------------------------------------------------
+        VkRenderPassMultiviewCreateInfo getMultiviewCreateInfo() const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to copy data from a buffer to another
+        ///
+        /// For instance from a buffer on the CPU to one on the GPU.
+        ///
+        /// @param  commandPool The command pool to use to create a command buffer
+        /// @param  srcBuffer   The buffer to copy from
+        /// @param  dstBuffer   The buffer to copy to
+        /// @param  size        Size of the data to copy
+        //--------------------------------------------------------------------------------
+        void copyBuffer(
+            VkCommandPool commandPool, VkBuffer srcBuffer, VkBuffer dstBuffer,
+            VkDeviceSize size
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to copy data from a buffer to an image
+        ///
+        /// @param  commandPool The command pool to use to create a command buffer
+        /// @param  buffer      The buffer to copy from
+        /// @param  image       The image to copy to
+        /// @param  width       Width of the image
+        /// @param  height      Height of the image
+        //--------------------------------------------------------------------------------
+        void copyBufferToImage(
+            VkCommandPool commandPool, VkBuffer buffer, VkImage image, uint32_t width,
+            uint32_t height
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to handle layout transitions for images
+        ///
+        /// @param  commandPool The command pool to use to create a command buffer
+        /// @param  image       The image to transition
+        /// @param  format      Image format
+        /// @param  oldLayout   The layout to transition from
+        /// @param  newLayout   The layout to transition to
+        /// @param  mipLevels   Number of mipmap levels
+        /// @param  nbLayers    Number of layers
+        //--------------------------------------------------------------------------------
+        void transitionImageLayout(
+            VkCommandPool commandPool, VkImage image, VkFormat format,
+            VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels,
+            uint32_t nbLayers = 1
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to generate the mipmaps of a texture image
+        ///
+        /// @param  commandPool The command pool to use to create a command buffer
+        /// @param  image       The image
+        /// @param  format      Image format
+        /// @param  width       Width of the image
+        /// @param  height      Height of the image
+        /// @param  mipLevels   Number of mipmap levels
+        //--------------------------------------------------------------------------------
+        void generateMipmaps(
+            VkCommandPool commandPool, VkImage image, VkFormat format,
+            int32_t width, int32_t height, uint32_t mipLevels
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to record commands to copy data from a buffer to another
+        ///
+        /// For instance from a buffer on the CPU to one on the GPU.
+        ///
+        /// @param  commandBuffer   The command buffer to record our commands to
+        /// @param  srcBuffer       The buffer to copy from
+        /// @param  dstBuffer       The buffer to copy to
+        /// @param  size            Size of the data to copy
+        //--------------------------------------------------------------------------------
+        void recordCopyBufferCommand(
+            VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer,
+            VkDeviceSize size
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to record commands to copy data from a buffer to an image
+        ///
+        /// @param  commandBuffer   The command buffer to record our commands to
+        /// @param  buffer          The buffer to copy from
+        /// @param  image           The image to copy to
+        /// @param  width           Width of the image
+        /// @param  height          Height of the image
+        //--------------------------------------------------------------------------------
+        void recordCopyBufferToImageCommand(
+            VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, uint32_t width,
+            uint32_t height
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to record commands to handle layout transitions for
+        ///         images
+        ///
+        /// @param  commandBuffer   The command buffer to record our commands to
+        /// @param  image           The image to transition
+        /// @param  format          Image format
+        /// @param  oldLayout       The layout to transition from
+        /// @param  newLayout       The layout to transition to
+        /// @param  mipLevels       Number of mipmap levels
+        /// @param  nbLayers        Number of layers
+        //--------------------------------------------------------------------------------
+        void recordTransitionImageLayoutCommand(
+            VkCommandBuffer commandBuffer, VkImage image, VkFormat format,
+            VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels,
+            uint32_t nbLayers = 1
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to record commands to generate the mipmaps of a texture
+        ///         image
+        ///
+        /// @param  commandBuffer   The command buffer to record our commands to
+        /// @param  image           The image
+        /// @param  format          Image format
+        /// @param  width           Width of the image
+        /// @param  height          Height of the image
+        /// @param  mipLevels       Number of mipmap levels
+        //--------------------------------------------------------------------------------
+        void recordGenerateMipmapsCommand(
+            VkCommandBuffer commandBuffer, VkImage image, VkFormat format,
+            int32_t width, int32_t height, uint32_t mipLevels
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to create a command buffer destined to only be executed once.
+        ///
+        /// Call endSingleTimeCommands() once you have added your commands to the buffer
+        /// to execute them.
+        ///
+        /// @param  commandPool     The command pool to use to create the command buffer
+        ///
+        /// @returns                The command buffer
+        //--------------------------------------------------------------------------------
+        VkCommandBuffer beginSingleTimeCommands(VkCommandPool commandPool) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Helper method to execute and release a command buffer destined to only
+        ///         be executed once (created with beginSingleTimeCommands())
+        ///
+        /// @param  commandPool     The command pool used to create the command buffer
+        /// @param  commandBuffer   The command buffer to execute
+        //--------------------------------------------------------------------------------
+        void endSingleTimeCommands(
+            VkCommandPool commandPool, VkCommandBuffer commandBuffer
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the index of a memory on the physical device (graphics card)
+        ///         supporting the provided properties
+        ///
+        /// @param  typeFilter  Type of memory
+        /// @param  properties  Properties of the desired memory
+        ///
+        /// @returns            Index of the memory
+        //--------------------------------------------------------------------------------
+        uint32_t findMemoryType(
+            uint32_t typeFilter, VkMemoryPropertyFlags properties
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the first image format supported by the physical device
+        ///         (graphics card) corresponding to the provided criteria
+        ///
+        /// @param  candidates  Candidate image formats (in order of preference)
+        /// @param  tiling      Desired tiling of the image
+        /// @param  features    Desired features
+        ///
+        /// @returns            The format
+        //--------------------------------------------------------------------------------
+        VkFormat findSupportedFormat(
+            const std::vector<VkFormat>& candidates, VkImageTiling tiling,
+            VkFormatFeatureFlags features
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the properties of a format on the physical device (graphics
+        ///         card)
+        ///
+        /// The ones of the core Vulkan 1.0 formats come from the capabilities of the
+        /// device, the other ones are queried.
+        ///
+        /// @param  format  The format
+        ///
+        /// @returns        The properties of the format
+        //--------------------------------------------------------------------------------
+        VkFormatProperties getFormatProperties(VkFormat format) const;
+    /// @}
+
+
+        //_____ Instance-related methods __________
+    protected:
+    /// @name Instance-related methods
+    /// @{
+        //--------------------------------------------------------------------------------
+        /// @brief  Initialize the Vulkan library by creating an instance. The instance is
+        ///         the connection between the application and the Vulkan library and
+        ///         creating it involves specifying some details about the application to
+        ///         the driver.
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void createInstance();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Creates the surface to use to render to the GLFW window
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void createSurface();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the required list of extensions
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        ///
+        /// @returns    The list of extension
+        //--------------------------------------------------------------------------------
+        virtual std::vector<const char*> getRequiredExtensions() const;
+    /// @}
+
+
+        //_____ Physical devices __________
+    protected:
+    /// @name Physical devices
+    /// @{
+        //--------------------------------------------------------------------------------
+        /// @brief  Select a graphics card in the system that supports the features we
+        ///         need. Use the one requested by the KNM_VK_DEVICE environment variable
+        ///         or by config_t::physicalDevice if any, the suitable one with the
+        ///         highest score otherwise (see rateDevice()).
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void pickPhysicalDevice();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Indicates if a physical device/graphics card is suitable for our needs
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual bool isDeviceSuitable(VkPhysicalDevice device) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the score of a suitable physical device/graphics card, the
+        ///         one with the highest score being selected
+        ///
+        /// By default the devices are ranked by type (discrete, integrated, virtual,
+        /// then CPU), then by size of their largest device-local memory heap, then by
+        /// queue topology (graphics and presentation in the same family, dedicated
+        /// compute and transfer families), and finally by number of supported optional
+        /// features (timeline semaphores, presentation wait and incremental
+        /// presentation, when requested by the configuration).
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        ///
+        /// @param  device  The physical device
+        ///
+        /// @returns        The score of the device
+        //--------------------------------------------------------------------------------
+        virtual uint64_t rateDevice(VkPhysicalDevice device) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the capabilities of a physical device/graphics card
+        ///
+        /// They are gathered on the first call, and loaded from (or saved to) the
+        /// folder configured by config_t::capabilitiesCacheDir if any.
+        ///
+        /// @param  device  The physical device
+        ///
+        /// @returns        The capabilities of the device
+        //--------------------------------------------------------------------------------
+        std::shared_ptr<const deviceCapabilities_t> getDeviceCapabilities(
+            VkPhysicalDevice device
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Enumerate the extensions, features, queue families, memory properties
+        ///         and format properties of a physical device/graphics card
+        ///
+        /// @param  device          The physical device
+        /// @param  capabilities    The capabilities to fill (the properties must be
+        ///                         already there)
+        //--------------------------------------------------------------------------------
+        void queryDeviceCapabilities(
+            VkPhysicalDevice device, deviceCapabilities_t& capabilities
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Load the capabilities of a physical device/graphics card saved by a
+        ///         previous run
+        ///
+        /// @param  path            Path of the file
+        /// @param  capabilities    The capabilities to fill (the properties must be
+        ///                         already there, to check that the file describes the
+        ///                         same device and driver)
+        ///
+        /// @returns                'true' if the capabilities were loaded
+        //--------------------------------------------------------------------------------
+        bool loadDeviceCapabilities(
+            const std::string& path, deviceCapabilities_t& capabilities
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Save the capabilities of a physical device/graphics card, for the next
+        ///         runs
+        ///
+        /// @param  path            Path of the file
+        /// @param  capabilities    The capabilities
+        //--------------------------------------------------------------------------------
+        void saveDeviceCapabilities(
+            const std::string& path, const deviceCapabilities_t& capabilities
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Search suitable queue families on a given physical device
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual queueFamilyIndices_t findQueueFamilies(VkPhysicalDevice device) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Choose the format of the swap chain images (or of the offscreen images
+        ///         in headless mode)
+        //--------------------------------------------------------------------------------
+        void selectSurfaceImageFormat();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the required list of device extensions
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual std::vector<const char*> getRequiredDeviceExtensions(
+            VkPhysicalDevice device
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Indicates if a physical device/graphics card supports the device
+        ///         extensions we need
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual bool checkDeviceExtensionSupport(VkPhysicalDevice device) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Indicates if a physical device/graphics card supports timeline
+        ///         semaphores (Vulkan 1.2+)
+        //--------------------------------------------------------------------------------
+        bool checkTimelineSemaphoreSupport(VkPhysicalDevice device) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Indicates if a physical device/graphics card supports waiting for the
+        ///         presentation of the frames (VK_KHR_present_id and VK_KHR_present_wait)
+        //--------------------------------------------------------------------------------
+        bool checkPresentWaitSupport(VkPhysicalDevice device) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Indicates if a physical device/graphics card supports passing the
+        ///         regions that changed to the presentation engine
+        ///         (VK_KHR_incremental_present)
+        //--------------------------------------------------------------------------------
+        bool checkIncrementalPresentSupport(VkPhysicalDevice device) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Indicates if a physical device/graphics card supports rendering the
+        ///         number of views needed by multiview render passes (see
+        ///         config_t::nbViews)
+        //--------------------------------------------------------------------------------
+        bool checkMultiviewSupport(VkPhysicalDevice device) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the maximum level of MSAA (multisample anti-aliasing)
+        ///         supported by the physical device
+        //--------------------------------------------------------------------------------
+        VkSampleCountFlagBits getMaxUsableSampleCount() const;
+    /// @}
+
+
+        //_____ Logical devices __________
+    protected:
+    /// @name Logical devices
+    /// @{
+        //--------------------------------------------------------------------------------
+        /// @brief  Setup a logical device to interface with a physical device, using
+        ///         queues
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void createLogicalDevice();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Create the device context from the instance and devices of the
+        ///         application, so they can be shared with other applications
+        //--------------------------------------------------------------------------------
+        void createDeviceContext();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Use the instance and devices of the shared device context, and create
+        ///         the surface of the window
+        //--------------------------------------------------------------------------------
+        void attachDeviceContext();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Wait for the device to be idle (the shared queues must not be used
+        ///         during the wait)
+        //--------------------------------------------------------------------------------
+        void waitForDeviceIdle();
+    /// @}
+
+
+        //_____ Swap chain __________
+    protected:
+    /// @name Swap chain
+    /// @{
+        //--------------------------------------------------------------------------------
+        /// @brief  Create the swap chain
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void createSwapChain();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Destroy all the objects depending on the swap chain
+        ///
+        /// The swap chain itself isn't destroyed: when it is recreated, it is passed to
+        /// its replacement and only destroyed once not used anymore (see
+        /// destroyRetiredSwapChains()). The same goes for the objects depending on it,
+        /// which are destroyed through destroyWhenRetired().
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void cleanupSwapChain();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Destroy the swap chains replaced since (and the objects depending on
+        ///         them), once the first frame rendered with their replacement is
+        ///         presented and retired
+        ///
+        /// @param  all     Destroy all of them, whether their frames are retired or not
+        ///                 (the caller is responsible for the synchronization)
+        //--------------------------------------------------------------------------------
+        void destroyRetiredSwapChains(bool all = false);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Destroy an object depending on the swap chain once the frames in flight
+        ///         don't use it anymore
+        ///
+        /// When called while the swap chain is recreated (ie. from
+        /// onSwapChainAboutToBeDestroyed() or onWindowSwapChainAboutToBeDestroyed()), the
+        /// destructor is only called when the old swap chain is destroyed. Otherwise (at
+        /// application shutdown), it is called right away.
+        ///
+        /// @param  destructor  Function destroying the object (must capture the handles
+        ///                     by value)
+        //--------------------------------------------------------------------------------
+        void destroyWhenRetired(std::function<void()> destructor);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  This method must called each time the window is resized, to recreate
+        ///         the swap chain and objects that depend on it or the window size
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void recreateSwapChain();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Create image views to access the images of the swap chain
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void createImageViews();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  In headless mode, create the offscreen images standing in for the swap
+        ///         chain images (see config_t::headless)
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        //--------------------------------------------------------------------------------
+        virtual void createOffscreenImages();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  In headless mode, destroy the offscreen images
+        //--------------------------------------------------------------------------------
+        void destroyOffscreenImages();
+
+        //------------------------------------------------------------------------------------
+        /// @brief  Creates the frame contexts (one for each frame-in-flight), containing
+        ///         the semaphores and fences that will be used to synchronise the
+        ///         rendering, a command pool and a scratch area
+        //------------------------------------------------------------------------------------
+        virtual void createSyncObjects();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the context of the frame currently being rendered
+        //--------------------------------------------------------------------------------
+        inline frameContext_t& getCurrentFrameContext()
+        {
+            return frames[currentFrame];
+        }
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the extent of the presented images (the swap chain ones)
+        //--------------------------------------------------------------------------------
+        inline VkExtent2D getPresentExtent() const
+        {
+            return swapChainExtent;
+        }
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the resolution at which the current frame must be rendered
+        ///         (in the top-left corner of the render images), to use for the
+        ///         viewport, scissor and render area
+        ///
+        /// Equal to the presentation extent, unless the dynamic resolution is used (see
+        /// config_t::useDynamicResolution).
+        //--------------------------------------------------------------------------------
+        inline VkExtent2D getRenderExtent() const
+        {
+            return renderExtent;
+        }
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the extent of the render images (the maximum render
+        ///         resolution), to use for the framebuffers
+        //--------------------------------------------------------------------------------
+        inline VkExtent2D getMaxRenderExtent() const
+        {
+            return config.useDynamicResolution ? maxRenderExtent : swapChainExtent;
+        }
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the views of the images into which the frames must be rendered
+        ///         (one for each swap chain image)
+        ///
+        /// Those are the views of the swap chain images, unless the dynamic resolution is
+        /// used (see config_t::useDynamicResolution).
+        //--------------------------------------------------------------------------------
+        inline const std::vector<VkImageView>& getRenderImageViews() const
+        {
+            return config.useDynamicResolution ? renderImageViews : swapChainImageViews;
+        }
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Create the render images (if the dynamic resolution is used, see
+        ///         config_t::useDynamicResolution)
+        //--------------------------------------------------------------------------------
+        void createRenderImages();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Destroy the render images
+        //--------------------------------------------------------------------------------
+        void destroyRenderImages();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Create the query pool used to measure the GPU time of the frames (if the
+        ///         dynamic resolution is used and the device supports it)
+        //--------------------------------------------------------------------------------
+        void createTimestampQueries();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Compute the render resolution from the current scale
+        //--------------------------------------------------------------------------------
+        void updateRenderExtent();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Retrieve the GPU time of the last frame that used a frame context (which
+        ///         must be retired), and adapt the render resolution if needed
+        ///
+        /// @param  frameIndex  Index of the frame context
+        //--------------------------------------------------------------------------------
+        void updateResolutionScale(uint32_t frameIndex);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Record the command buffers surrounding the ones of the user when the
+        ///         dynamic resolution is used: measure of the GPU time, and scaling of the
+        ///         render image into the swap chain image
+        ///
+        /// @param  frame       Context of the frame (the command buffers are allocated
+        ///                     from its command pool)
+        /// @param  frameIndex  Index of the frame context
+        /// @param  imageIndex  Index of the swap chain image
+        ///
+        /// @param[out] beginCommandBuffer  Command buffer to submit before the ones of the
+        ///                                 user
+        /// @param[out] endCommandBuffer    Command buffer to submit after the ones of the
+        ///                                 user
+        //--------------------------------------------------------------------------------
+        void recordDynamicResolutionCommands(
+            frameContext_t& frame, uint32_t frameIndex, uint32_t imageIndex,
+            VkCommandBuffer& beginCommandBuffer, VkCommandBuffer& endCommandBuffer
+        );
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Record the command buffers surrounding the ones of the user when the
+        ///         swap chain images are written by compute shaders: transitions of the
+        ///         swap chain image to and from the VK_IMAGE_LAYOUT_GENERAL layout (see
+        ///         config_t::useComputePresentation)
+        ///
+        /// @param  frame       Context of the frame (the command buffers are allocated
+        ///                     from its command pool)
+        /// @param  imageIndex  Index of the swap chain image
+        ///
+        /// @param[out] beginCommandBuffer  Command buffer to submit before the ones of the
+        ///                                 user
+        /// @param[out] endCommandBuffer    Command buffer to submit after the ones of the
+        ///                                 user
+        //--------------------------------------------------------------------------------
+        void recordComputePresentationCommands(
+            frameContext_t& frame, uint32_t imageIndex,
+            VkCommandBuffer& beginCommandBuffer, VkCommandBuffer& endCommandBuffer
+        );
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Retrieve the details about the swap chain support by a physical device
+        ///
+        /// @param  device  The physical device
+        ///
+        /// @returns        The details about the swap chain support
+        //--------------------------------------------------------------------------------
+        swapChainSupportDetails_t querySwapChainSupport(VkPhysicalDevice device) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Retrieve the details about the support of a surface by a physical
+        ///         device
+        ///
+        /// @param  device      The physical device
+        /// @param  surface     The surface
+        ///
+        /// @returns            The details about the swap chain support
+        //--------------------------------------------------------------------------------
+        swapChainSupportDetails_t querySwapChainSupport(
+            VkPhysicalDevice device, VkSurfaceKHR surface
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Forget the formats and presentation modes supported by a surface
+        ///         (must be called before destroying it)
+        ///
+        /// @param  surface     The surface
+        //--------------------------------------------------------------------------------
+        void clearSurfaceSupport(VkSurfaceKHR surface);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Select the best surface format from the provided list
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        ///
+        /// @param  availableFormats    List of available formats
+        ///
+        /// @returns                    The best surface format
+        //--------------------------------------------------------------------------------
+        virtual VkSurfaceFormatKHR chooseSwapSurfaceFormat(
+            const std::vector<VkSurfaceFormatKHR>& availableFormats
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Select the best presentation mode from the provided list, according to
+        ///         config_t::presentationPolicy
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        ///
+        /// @param  availablePresentModes    List of available modes
+        ///
+        /// @returns                        The best presentation mode
+        //--------------------------------------------------------------------------------
+        virtual VkPresentModeKHR chooseSwapPresentationMode(
+            const std::vector<VkPresentModeKHR>& availablePresentModes
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Select the number of images of the swap chain, according to
+        ///         config_t::presentationPolicy and config_t::swapChainImageCount
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        ///
+        /// @param  capabilities        The capabilities of the surface
+        /// @param  presentationMode    The presentation mode that will be used
+        ///
+        /// @returns                    The number of images
+        //--------------------------------------------------------------------------------
+        virtual uint32_t chooseSwapImageCount(
+            const VkSurfaceCapabilitiesKHR& capabilities, VkPresentModeKHR presentationMode
+        ) const;
+        
+        //--------------------------------------------------------------------------------
+        /// @brief  Select the swap extent (the resolution of the swap chain images)
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        ///
+        /// @param  capabilities    The capabilities of the surface
+        ///
+        /// @returns                The selected swap extent
+        //--------------------------------------------------------------------------------
+        virtual VkExtent2D chooseSwapExtent(
+            const VkSurfaceCapabilitiesKHR& capabilities
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Returns the usage of the swap chain images (of the main window and of
+        ///         the additional ones), according to config_t::swapChainImageUsage and
+        ///         to the features using the images (capture, dynamic resolution, compute
+        ///         presentation)
+        ///
+        /// Throws if the usage isn't supported by the surface.
+        ///
+        /// @param  capabilities    The capabilities of the surface
+        /// @param  format          The format of the swap chain images
+        ///
+        /// @returns                The usage of the images
+        //--------------------------------------------------------------------------------
+        VkImageUsageFlags getSwapChainImageUsage(
+            const VkSurfaceCapabilitiesKHR& capabilities, VkFormat format
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Create the additional windows (see config_t::additionalWindows)
+        //--------------------------------------------------------------------------------
+        void createAdditionalWindows();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Create the surfaces, synchronisation objects and swap chains of the
+        ///         additional windows
+        //--------------------------------------------------------------------------------
+        void createWindowTargets();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Destroy the additional windows, and all their Vulkan objects
+        //--------------------------------------------------------------------------------
+        void destroyWindowTargets();
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Create the swap chain (and image views) of an additional window,
+        ///         replacing the previous one if any
+        ///
+        /// @param  windowIndex     Index of the additional window
+        //--------------------------------------------------------------------------------
+        void createWindowSwapChain(uint32_t windowIndex);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Recreate the swap chain of an additional window, once the frames in
+        ///         flight are retired (unless the window is minimized)
+        ///
+        /// @param  windowIndex     Index of the additional window
+        //--------------------------------------------------------------------------------
+        void recreateWindowSwapChain(uint32_t windowIndex);
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Acquire an image from the swap chain of each additional window, for a
+        ///         frame
+        ///
+        /// @param  frameIndex  Index of the frame context
+        /// @param  timeout     Maximum time to wait for each image (in nanoseconds). Nothing
+        ///                     is rendered in the windows without available image.
+        //--------------------------------------------------------------------------------
+        void acquireWindowImages(uint32_t frameIndex, uint64_t timeout);
+    /// @}
+
+
+        //_____ Validation layers __________
+    protected:
+    /// @name Validation layers
+    /// @{
+        //--------------------------------------------------------------------------------
+        /// @brief  Checks if all of the requested validation layers are available
+        //--------------------------------------------------------------------------------
+        bool checkValidationLayerSupport() const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Populate the provided messenger creation info
+        ///
+        /// Can be overriden by the user if the default implementation doesn't fulfill its
+        /// needs.
+        ///
+        /// @param[out] createInfo  The structure to populate
+        //--------------------------------------------------------------------------------
+        virtual void populateDebugMessengerCreateInfo(
+            VkDebugUtilsMessengerCreateInfoEXT& createInfo
+        ) const;
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Tell Vulkan about the callback function to call from validation layers
+        //--------------------------------------------------------------------------------
+        void setupDebugMessenger();
+    /// @}
+
+
+        //_____ Attributes __________
+    protected:
+        // The configuration of the application
+        config_t config;
+
+        // Window, instance and surface
+        GLFWwindow* window = nullptr;
+        VkInstance instance = VK_NULL_HANDLE;
+        VkSurfaceKHR surface = VK_NULL_HANDLE;
+        VkFormat surfaceImageFormat = VK_FORMAT_UNDEFINED;
+        std::atomic<bool> framebufferResized = false;
+        std::atomic<int> framebufferWidth = 0;
+        std::atomic<int> framebufferHeight = 0;
+
+        // Devices (possibly shared with other applications)
+        std::shared_ptr<DeviceContext> deviceContext;
+        VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+        VkDevice device = VK_NULL_HANDLE;
+        VkSampleCountFlagBits msaaNbMaxSamples = VK_SAMPLE_COUNT_1_BIT;
+        std::shared_ptr<const deviceCapabilities_t> deviceCapabilities;
+
+        // Capabilities of the physical devices and formats/presentation modes supported
+        // by the surfaces, gathered once (see getDeviceCapabilities() and
+        // querySwapChainSupport())
+        mutable std::mutex capabilitiesMutex;
+        mutable std::map<VkPhysicalDevice, std::shared_ptr<const deviceCapabilities_t>> capabilitiesCache;
+        mutable std::map<std::pair<VkPhysicalDevice, VkSurfaceKHR>, swapChainSupportDetails_t> surfaceSupportCache;
+
+        // Queues
+        VkQueue graphicsQueue = VK_NULL_HANDLE;
+        VkQueue presentationQueue = VK_NULL_HANDLE;
+
+        // Swap chain
+        VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+        std::vector<VkImage> swapChainImages;
+        std::vector<VkImageView> swapChainImageViews;
+        VkExtent2D swapChainExtent;
+
+        // Dynamic resolution (see config_t::useDynamicResolution)
+        std::vector<VkImage> renderImages;
+        std::vector<VkDeviceMemory> renderImageMemories;
+        std::vector<VkImageView> renderImageViews;
+        VkExtent2D renderExtent = { 0, 0 };
+        VkExtent2D maxRenderExtent = { 0, 0 };
+        float resolutionScale = 1.0f;
+        VkQueryPool timestampQueryPool = VK_NULL_HANDLE;
+        uint64_t timestampMask = UINT64_MAX;
+        float gpuTimeSum = 0.0f;
+        uint32_t nbGpuTimeSamples = 0;
+
+        // Time spent waiting for the current frame context, accumulated over the
+        // attempts to begin the frame (see tryBeginFrame())
+        float frameWaitTime = 0.0f;
+
+        // Additional windows (see config_t::additionalWindows)
+        std::deque<windowTarget_t> windowTargets;
+
+        // Offscreen images standing in for the swap chain images (in headless mode)
+        std::vector<VkDeviceMemory> offscreenImageMemories;
+        uint32_t nextOffscreenImage = 0;
+
+        // Swap chains replaced by a new one, and the objects depending on them
+        std::vector<retiredSwapChain_t> retiredSwapChains;
+
+        // Destructors given to destroyWhenRetired() during the recreation of a swap chain
+        bool deferringDestructions = false;
+        std::vector<std::function<void()>> deferredDestructors;
+
+        // Frames-in-flight
+        std::vector<frameContext_t> frames;
+        std::atomic<uint32_t> currentFrame = 0;
+        bool frameBegun = false;
+        uint32_t frameImageIndex = 0;
+        std::vector<VkCommandBuffer> commandBufferList;
+        std::atomic<uint64_t> lastSubmittedFrame = 0;
+
+        // Timeline semaphore tracking the completion of the frames (if supported)
+        bool timelineSemaphoreSupported = false;
+        VkSemaphore frameTimelineSemaphore = VK_NULL_HANDLE;
+
+        // Frame pacing
+        std::chrono::high_resolution_clock::time_point nextFrameTime;
+        std::chrono::high_resolution_clock::time_point frameStartTime;
+        std::chrono::high_resolution_clock::time_point lastSubmitTime;
+        bool presentWaitSupported = false;
+        uint64_t lastPresentId = 0;
+#ifdef VK_KHR_present_wait
+        PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+#endif
+
+        // Multiview (see config_t::nbViews)
+        uint32_t multiviewViewMask = 0;
+        uint32_t multiviewCorrelationMask = 0;
+
+        // Damage tracking (see config_t::useDamageTracking)
+        bool incrementalPresentSupported = false;
+        std::mutex damageMutex;
+        std::vector<VkRect2D> imageDamageRects;
+
+        // Present thread (if used)
+        std::thread presentThread;
+        std::mutex presentMutex;
+        std::condition_variable presentCondition;
+        LockFreeQueue<presentRequest_t, MAX_NB_FRAMES_IN_FLIGHT> presentRequests;
+        uint64_t lastPresentedFrame = 0;
+        bool stopPresenting = false;
+        std::atomic<bool> presentOutOfDate = false;
+        std::atomic<VkResult> presentError = VK_SUCCESS;
+
+        // Pipelined stages (if used)
+        std::atomic<bool> pipelineRunning = false;
+        BoundedQueue<pipelinedFrame_t> simulatedFrames;
+        BoundedQueue<pipelinedFrame_t> recordedFrames;
+        std::mutex pipelineMutex;
+        std::condition_variable pipelineCondition;
+        uint64_t lastRecordedFrame = 0;
+        uint64_t lastProcessedFrame = 0;
+
+        // Used to serialize the accesses to the swap chain when several threads use it
+        // (the accesses to the queues are serialized by the device context)
+        std::mutex swapChainMutex;
+
+        // On-demand rendering
+        std::atomic<bool> redrawRequested = true;
+        std::mutex redrawMutex;
+        std::condition_variable redrawCondition;
+        std::chrono::high_resolution_clock::time_point lastRedrawTime;
+
+        // Statistics (updated by several threads in pipelined mode)
+        frameStatistics_t statistics;
+        mutable std::mutex statisticsMutex;
+
+        // Benchmark of the presentation modes
+        std::vector<presentationBenchmarkResult_t> benchmarkResults;
+        VkPresentModeKHR benchmarkPresentationMode = VK_PRESENT_MODE_FIFO_KHR;
+        uint32_t benchmarkImageCount = 0;
+
+        // Frame capture (if used)
+        std::vector<captureSlot_t> captureSlots;
+        std::atomic<uint64_t> nbCapturedFrames = 0;
+        std::atomic<uint64_t> nbDroppedCaptures = 0;
+        std::vector<VkCommandBuffer> submittedCommandBuffers;
+        std::ofstream captureVideoFile;
+        VkExtent2D captureVideoExtent = { 0, 0 };
+
+        // Readbacks, and the thread delivering them (also used by the frame capture).
+        // The pending ones wait for their frame to be retired.
+        std::thread readbackThread;
+        std::mutex readbackMutex;
+        std::condition_variable readbackCondition;
+        bool stopReadbacks = false;
+        std::vector<std::pair<uint64_t, std::function<void()>>> pendingReadbacks;
+        std::deque<std::function<void()>> readbackTasks;
+        std::vector<readbackBuffer_t> freeReadbackBuffers;
+        uint64_t recordingFrameNumber = 0;
+
+        // Render jobs (see runJobs())
+        std::deque<renderJob_t> jobs;
+        std::mutex jobMutex;
+        bool jobsEnded = false;
+        uint64_t nbSubmittedJobs = 0;
+        std::vector<renderTarget_t> renderTargets;
+        std::atomic<uint64_t> nbCompletedJobs = 0;
+        std::atomic<uint64_t> nbFailedJobs = 0;
+        jobStatistics_t jobStatistics;
+        std::chrono::high_resolution_clock::time_point jobsStartTime;
+
+        // Closing of the application (see close()), and events posted to the main
+        // thread in headless mode
+        std::atomic<bool> closeRequested = false;
+        std::mutex eventMutex;
+        std::condition_variable eventCondition;
+        bool eventPosted = false;
+
+        // Rendering thread (if used)
+        std::atomic<bool> renderThreadRunning = false;
+        std::atomic<bool> stopRendering = false;
+        LockFreeQueue<windowEvent_t, 256> windowEvents;
+
+        // Events not yet in the queue because it was full (main thread only)
+        std::deque<windowEvent_t> pendingWindowEvents;
+
+        // Debug messenger (when validation layers are used)
+        VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
+
+
+        //_____ Window callbacks (rendering thread) __________
+    protected:
+        void postWindowEvent(const windowEvent_t& event);
+        void flushWindowEvents();
+
+        static void onWindowKey(GLFWwindow* window, int key, int scancode, int action, int mods);
+        static void onWindowMouseButton(GLFWwindow* window, int button, int action, int mods);
+        static void onWindowCursorPosition(GLFWwindow* window, double x, double y);
+        static void onWindowScroll(GLFWwindow* window, double x, double y);
+        static void onWindowRefresh(GLFWwindow* window);
+        static void onAdditionalWindowResized(GLFWwindow* window, int width, int height);
+
+
+        //_____ Friend functions __________
+        friend void onFramebufferWindowResized(GLFWwindow* window, int width, int height);
+    };
+
+
+    //------------------------------------------------------------------------------------
+    /// @brief  Variant of the Application class resolving the per-frame hooks at compile
+    ///         time
+    ///
+    /// The derived class must implement the following (non-virtual) method, called
+    /// directly each frame instead of Application::getNbCommandBuffers() and
+    /// Application::getCommandBuffers():
+    ///
+    ///     void recordCommandBuffers(
+    ///         float elapsed, uint32_t imageIndex, CommandBufferSpan& commandBuffers
+    ///     );
+    ///
+    /// Up to MAX_NB_COMMAND_BUFFERS command buffers can be added to the span. The other
+    /// methods to implement are the same as for Application. Application::drawFrame()
+    /// isn't called anymore by the main loop.
+    ///
+    /// @tparam Derived     The derived application class
+    //------------------------------------------------------------------------------------
+    template<typename Derived>
+    class ApplicationT : public Application
+    {
+    protected:
+        //--------------------------------------------------------------------------------
+        /// @brief  Render one frame, retrieving the command buffers from the derived
+        ///         class without any virtual call or memory allocation
+        //--------------------------------------------------------------------------------
+        bool renderFrame(float elapsed) final
+        {
+            if (tryBeginFrame(UINT64_MAX) != FRAME_STATUS_READY)
+                return true;
+
+            frameBegun = false;
+
+            auto recordStart = std::chrono::high_resolution_clock::now();
+
+            CommandBufferSpan commandBuffers(commandBufferStorage.data(), MAX_NB_COMMAND_BUFFERS);
+            static_cast<Derived*>(this)->recordCommandBuffers(
+                elapsed, frameImageIndex, commandBuffers
+            );
+
+            finishFrame(elapsed, commandBuffers.data(), commandBuffers.size(), recordStart);
+            return true;
+        }
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Only used by the code paths not using the static dispatch (like the
+        ///         pipelined stages), returns the maximum number of command buffers
+        //--------------------------------------------------------------------------------
+        uint32_t getNbCommandBuffers() const final
+        {
+            return MAX_NB_COMMAND_BUFFERS;
+        }
+
+        //--------------------------------------------------------------------------------
+        /// @brief  Adapter used by the code paths not using the static dispatch (like the
+        ///         pipelined stages)
+        //--------------------------------------------------------------------------------
+        void getCommandBuffers(
+            float elapsed, uint32_t imageIndex, std::vector<VkCommandBuffer>& outCommandBuffers
+        ) final
+        {
+            std::array<VkCommandBuffer, MAX_NB_COMMAND_BUFFERS> storage;
+
+            CommandBufferSpan commandBuffers(storage.data(), MAX_NB_COMMAND_BUFFERS);
+            static_cast<Derived*>(this)->recordCommandBuffers(
+                elapsed, imageIndex, commandBuffers
+            );
+
+            outCommandBuffers.assign(commandBuffers.begin(), commandBuffers.end());
+        }
+
+    private:
+        std::array<VkCommandBuffer, MAX_NB_COMMAND_BUFFERS> commandBufferStorage;
+    };
+
+
+#ifdef KNM_VULKAN_TOOLS_IMPLEMENTATION
+
+    /***************************** DEBUG CALLBACK FUNCTION ******************************/
+
+    //------------------------------------------------------------------------------------
+    // The default callback function to call from validation layers
+    //------------------------------------------------------------------------------------
+    static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
+        VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
+        VkDebugUtilsMessageTypeFlagsEXT messageType,
+        const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
+        void* pUserData
+    )
+    {
+        std::cerr << "Validation layer: " << pCallbackData->pMessage << std::endl;
+        return VK_FALSE;
+    }
+
+
+    /********************************* HELPER FUNCTIONS **********************************/
+
+    std::vector<char> readFile(const std::string& filename)
+    {
+        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+        if (!file.is_open())
+            throw std::runtime_error("Failed to open file!");
+
+        size_t fileSize = (size_t) file.tellg();
+        std::vector<char> buffer(fileSize);
+
+        file.seekg(0);
+        file.read(buffer.data(), fileSize);
+
+        file.close();
+
+        return buffer;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void onFramebufferWindowResized(GLFWwindow* window, int width, int height)
+    {
+        auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+
+        app->framebufferWidth = width;
+        app->framebufferHeight = height;
+        app->framebufferResized = true;
+
+        if (app->config.renderOnDemand)
+            app->requestRedraw();
+
+        if (app->config.useRenderThread)
+        {
+            windowEvent_t event;
+            event.type = WINDOW_EVENT_FRAMEBUFFER_RESIZED;
+            event.width = width;
+            event.height = height;
+            app->postWindowEvent(event);
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool compareFeatures(
+        void* required, void* supported, size_t size, size_t offset, bool apiVersionSupported
+    )
+    {
+        VkBool32* required_bool = (VkBool32*) (static_cast<uint8_t*>(required) + offset);
+        VkBool32* supported_bool = (VkBool32*) (static_cast<uint8_t*>(supported) + offset);
+        size_t nb = (size - offset) / sizeof(VkBool32);
+
+        for (size_t i = 0; i < nb; ++i)
+        {
+            if (required_bool[i] && (!supported_bool[i] || !apiVersionSupported))
+                return false;
+        }
+
+        return true;
+    }
+
+    //-----------------------------------------------------------------------
+
+    const char* getPresentationModeName(VkPresentModeKHR presentationMode)
+    {
+        switch (presentationMode)
+        {
+            case VK_PRESENT_MODE_IMMEDIATE_KHR: return "IMMEDIATE";
+            case VK_PRESENT_MODE_MAILBOX_KHR: return "MAILBOX";
+            case VK_PRESENT_MODE_FIFO_KHR: return "FIFO";
+            case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO_RELAXED";
+            default: return "UNKNOWN";
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Convert the pixels of a captured frame to tightly packed RGB triplets
+    //------------------------------------------------------------------------------------
+    static void convertCaptureToRGB(const frameCapture_t& capture, std::vector<uint8_t>& rgb)
+    {
+        bool bgra = (capture.format == VK_FORMAT_B8G8R8A8_UNORM) ||
+                    (capture.format == VK_FORMAT_B8G8R8A8_SRGB);
+
+        size_t nbPixels = size_t(capture.width) * capture.height;
+        rgb.resize(nbPixels * 3);
+
+        const uint8_t* src = capture.data;
+        uint8_t* dst = rgb.data();
+
+        for (size_t i = 0; i < nbPixels; ++i, src += 4, dst += 3)
+        {
+            dst[0] = bgra ? src[2] : src[0];
+            dst[1] = src[1];
+            dst[2] = bgra ? src[0] : src[2];
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Update a CRC-32 (as used by the PNG chunks) with some data
+    //------------------------------------------------------------------------------------
+    static uint32_t updateCRC32(uint32_t crc, const uint8_t* data, size_t size)
+    {
+        // The initialisation of a local static is thread-safe (several applications
+        // might save PNG files at the same time)
+        static const std::array<uint32_t, 256> table = []() {
+            std::array<uint32_t, 256> result;
+
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+
+                result[n] = c;
+            }
+
+            return result;
+        }();
+
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i)
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+        return ~crc;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Returns the bounding box of two rectangles (the empty ones being ignored)
+    //------------------------------------------------------------------------------------
+    static VkRect2D unionRects(const VkRect2D& a, const VkRect2D& b)
+    {
+        if ((a.extent.width == 0) || (a.extent.height == 0))
+            return b;
+
+        if ((b.extent.width == 0) || (b.extent.height == 0))
+            return a;
+
+        int32_t x0 = std::min(a.offset.x, b.offset.x);
+        int32_t y0 = std::min(a.offset.y, b.offset.y);
+        int32_t x1 = std::max(a.offset.x + int32_t(a.extent.width), b.offset.x + int32_t(b.extent.width));
+        int32_t y1 = std::max(a.offset.y + int32_t(a.extent.height), b.offset.y + int32_t(b.extent.height));
+
+        return { { x0, y0 }, { uint32_t(x1 - x0), uint32_t(y1 - y0) } };
+    }
+
+    //------------------------------------------------------------------------------------
+    // Returns the values identifying the format of the files containing the capabilities
+    // of a physical device, and the device and driver they describe
+    //------------------------------------------------------------------------------------
+    static std::vector<uint32_t> getCapabilitiesSignature(
+        uint32_t vulkanVersion, const deviceCapabilities_t& capabilities
+    )
+    {
+        std::vector<uint32_t> signature = {
+            0x434D4E4B,     // "KNMC"
+            1,              // Version of the file format
+            vulkanVersion,
+            capabilities.properties.vendorID,
+            capabilities.properties.deviceID,
+            capabilities.properties.apiVersion,
+            capabilities.properties.driverVersion,
+            sizeof(VkPhysicalDeviceMemoryProperties),
+            sizeof(VkPhysicalDeviceFeatures),
+            sizeof(VkExtensionProperties),
+            sizeof(VkQueueFamilyProperties),
+            sizeof(VkFormatProperties),
+        };
+
+#ifdef VK_API_VERSION_1_1
+        signature.push_back(sizeof(VkPhysicalDeviceVulkan11Features));
+#endif
+
+#ifdef VK_API_VERSION_1_2
+        signature.push_back(sizeof(VkPhysicalDeviceVulkan12Features));
+#endif
+
+#ifdef VK_API_VERSION_1_3
+        signature.push_back(sizeof(VkPhysicalDeviceVulkan13Features));
+#endif
+
+        for (uint32_t i = 0; i < VK_UUID_SIZE; ++i)
+            signature.push_back(capabilities.deviceUUID[i]);
+
+        return signature;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Write a list of POD values in a file (preceded by their number)
+    //------------------------------------------------------------------------------------
+    template<typename T>
+    static void writeArray(std::ofstream& file, const std::vector<T>& values)
+    {
+        uint32_t count = (uint32_t) values.size();
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(values.data()), sizeof(T) * count);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Read a list of POD values written by writeArray()
+    //------------------------------------------------------------------------------------
+    template<typename T>
+    static bool readArray(std::ifstream& file, std::vector<T>& values)
+    {
+        uint32_t count = 0;
+        if (!file.read(reinterpret_cast<char*>(&count), sizeof(count)) || (count > 65536))
+            return false;
+
+        values.resize(count);
+        return bool(file.read(reinterpret_cast<char*>(values.data()), sizeof(T) * count));
+    }
+
+    //------------------------------------------------------------------------------------
+    // Indicates if a physical device is designated by a selector (see
+    // config_t::physicalDevice): its index, its UUID or a part of its name
+    //------------------------------------------------------------------------------------
+    static bool matchDeviceSelector(
+        const deviceCapabilities_t& capabilities, uint32_t index, const std::string& selector
+    )
+    {
+        // Index
+        if (std::all_of(selector.begin(), selector.end(), [](char c) { return isdigit((unsigned char) c); }))
+            return (selector.size() < 10) && (std::stoul(selector) == index);
+
+        // UUID
+        std::string lowerSelector;
+        for (char c : selector)
+        {
+            if (c != '-')
+                lowerSelector += (char) tolower((unsigned char) c);
+        }
+
+        char uuid[2 * VK_UUID_SIZE + 1];
+        for (uint32_t i = 0; i < VK_UUID_SIZE; ++i)
+            snprintf(uuid + 2 * i, 3, "%02x", capabilities.deviceUUID[i]);
+
+        if (lowerSelector == uuid)
+            return true;
+
+        // Part of the name
+        std::string name = capabilities.properties.deviceName;
+        std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+            return (char) tolower((unsigned char) c);
+        });
+
+        lowerSelector.clear();
+        for (char c : selector)
+            lowerSelector += (char) tolower((unsigned char) c);
+
+        return name.find(lowerSelector) != std::string::npos;
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool writePPM(const std::string& filename, const frameCapture_t& capture)
+    {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        std::vector<uint8_t> rgb;
+        convertCaptureToRGB(capture, rgb);
+
+        file << "P6\n" << capture.width << " " << capture.height << "\n255\n";
+        file.write(reinterpret_cast<const char*>(rgb.data()), rgb.size());
+
+        return file.good();
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool writePNG(const std::string& filename, const frameCapture_t& capture)
+    {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        auto appendUInt32 = [](std::vector<uint8_t>& data, uint32_t value) {
+            data.push_back(uint8_t(value >> 24));
+            data.push_back(uint8_t(value >> 16));
+            data.push_back(uint8_t(value >> 8));
+            data.push_back(uint8_t(value));
+        };
+
+        auto writeChunk = [&file, &appendUInt32](const char* type, const std::vector<uint8_t>& data) {
+            std::vector<uint8_t> chunk;
+            chunk.reserve(data.size() + 12);
+
+            appendUInt32(chunk, uint32_t(data.size()));
+            chunk.insert(chunk.end(), type, type + 4);
+            chunk.insert(chunk.end(), data.begin(), data.end());
+            appendUInt32(chunk, updateCRC32(0, chunk.data() + 4, data.size() + 4));
+
+            file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+        };
+
+        // Signature
+        const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+        // Header (8-bits RGB)
+        std::vector<uint8_t> header;
+        appendUInt32(header, capture.width);
+        appendUInt32(header, capture.height);
+        header.insert(header.end(), { 8, 2, 0, 0, 0 });
+        writeChunk("IHDR", header);
+
+        // Scanlines (each one preceded by its filter type, none)
+        std::vector<uint8_t> rgb;
+        convertCaptureToRGB(capture, rgb);
+
+        size_t rowSize = size_t(capture.width) * 3;
+
+        std::vector<uint8_t> scanlines;
+        scanlines.reserve((rowSize + 1) * capture.height);
+
+        for (uint32_t y = 0; y < capture.height; ++y)
+        {
+            scanlines.push_back(0);
+            scanlines.insert(
+                scanlines.end(), rgb.begin() + y * rowSize, rgb.begin() + (y + 1) * rowSize
+            );
+        }
+
+        // zlib stream made of stored (uncompressed) deflate blocks: the goal is to not
+        // slow down the capture, not to produce small files
+        const size_t MAX_BLOCK_SIZE = 65535;
+
+        std::vector<uint8_t> compressed;
+        compressed.reserve(scanlines.size() + (scanlines.size() / MAX_BLOCK_SIZE + 1) * 5 + 6);
+        compressed.push_back(0x78);
+        compressed.push_back(0x01);
+
+        uint32_t a = 1, b = 0;
+        size_t offset = 0;
+
+        do
+        {
+            size_t blockSize = std::min(MAX_BLOCK_SIZE, scanlines.size() - offset);
+            bool last = (offset + blockSize == scanlines.size());
+
+            compressed.push_back(last ? 1 : 0);
+            compressed.push_back(uint8_t(blockSize));
+            compressed.push_back(uint8_t(blockSize >> 8));
+            compressed.push_back(uint8_t(~blockSize));
+            compressed.push_back(uint8_t(~blockSize >> 8));
+
+            for (size_t i = offset; i < offset + blockSize; ++i)
+            {
+                a = (a + scanlines[i]) % 65521;
+                b = (b + a) % 65521;
+            }
+
+            compressed.insert(
+                compressed.end(), scanlines.begin() + offset, scanlines.begin() + offset + blockSize
+            );
+
+            offset += blockSize;
+        }
+        while (offset < scanlines.size());
+
+        appendUInt32(compressed, (b << 16) | a);
+
+        writeChunk("IDAT", compressed);
+        writeChunk("IEND", std::vector<uint8_t>());
+
+        return file.good();
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool writeY4MFrame(std::ofstream& file, const frameCapture_t& capture)
+    {
+        std::vector<uint8_t> rgb;
+        convertCaptureToRGB(capture, rgb);
+
+        // Planar YCbCr (BT.601, limited range)
+        size_t nbPixels = size_t(capture.width) * capture.height;
+        std::vector<uint8_t> planes(nbPixels * 3);
+
+        uint8_t* y = planes.data();
+        uint8_t* u = y + nbPixels;
+        uint8_t* v = u + nbPixels;
+
+        for (size_t i = 0; i < nbPixels; ++i)
+        {
+            int r = rgb[i * 3];
+            int g = rgb[i * 3 + 1];
+            int b = rgb[i * 3 + 2];
+
+            y[i] = uint8_t(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            u[i] = uint8_t(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            v[i] = uint8_t(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+
+        file << "FRAME\n";
+        file.write(reinterpret_cast<const char*>(planes.data()), planes.size());
+
+        return file.good();
+    }
+
+
+    //------------------------------------------------------------------------------------
+    // Number of applications using GLFW (initialised by the first one, and terminated by
+    // the last one)
+    //------------------------------------------------------------------------------------
+    static uint32_t nbGLFWUsers = 0;
+
+
+    /******************************* DEVICE CAPABILITIES ********************************/
+
+    bool deviceCapabilities_t::hasExtension(const char* name) const
+    {
+        return std::any_of(
+            extensions.begin(), extensions.end(),
+            [name](const VkExtensionProperties& extension) {
+                return strcmp(extension.extensionName, name) == 0;
+            }
+        );
+    }
+
+
+    /********************************** DEVICE CONTEXT **********************************/
+
+    DeviceContext::~DeviceContext()
+    {
+        if (device != VK_NULL_HANDLE)
+            vkDestroyDevice(device, nullptr);
+
+        if (debugMessenger != VK_NULL_HANDLE)
+        {
+            // Destroy the debug messenger (we have to look up the address of the function
+            // ourselves)
+            auto func = (PFN_vkDestroyDebugUtilsMessengerEXT) vkGetInstanceProcAddr(
+                instance, "vkDestroyDebugUtilsMessengerEXT"
+            );
+
+            if (func != nullptr)
+                func(instance, debugMessenger, nullptr);
+        }
+
+        if (instance != VK_NULL_HANDLE)
+            vkDestroyInstance(instance, nullptr);
+    }
+
+
+    /*************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+    Application::Application()
+    {
+        config.debugCallback = debugCallback;
+
+#ifdef VK_API_VERSION_1_3
+        config.features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        config.features12.pNext = &config.features13;
+#endif
+
+#ifdef VK_API_VERSION_1_2
+        config.features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        config.features11.pNext = &config.features12;
+#endif
+
+#ifdef VK_API_VERSION_1_1
+        config.features11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+#endif
+
+        config.features10.samplerAnisotropy = VK_TRUE;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::run()
+    {
+        init();
+        mainLoop();
+        shutdown();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::runJobs()
+    {
+        if (!config.headless)
+            throw std::runtime_error("Render jobs can only be executed in headless mode!");
+
+        if (config.useDynamicResolution)
+            throw std::runtime_error("Dynamic resolution not supported by the render jobs!");
+
+        init();
+
+        jobsStartTime = std::chrono::high_resolution_clock::now();
+
+        renderJob_t job;
+        while (waitForJob(job))
+        {
+            processJob(job);
+            updateJobStatistics();
+        }
+
+        // All the images are saved once the readback thread is stopped
+        shutdown();
+        updateJobStatistics();
+    }
+
+    //-----------------------------------------------------------------------
+
+    uint64_t Application::submitJob(const renderJob_t& job)
+    {
+        // Only the common 4-bytes formats can be saved
+        switch (job.format)
+        {
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+                break;
+
+            default:
+                throw std::runtime_error("Format of the render job not supported!");
+        }
+
+        if ((job.extent.width == 0) || (job.extent.height == 0))
+            throw std::runtime_error("Invalid size of the render job!");
+
+        uint64_t id;
+
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+
+            id = ++nbSubmittedJobs;
+
+            jobs.push_back(job);
+            jobs.back().id = id;
+        }
+
+        // Wake up runJobs() if it is waiting
+        postEmptyEvent();
+
+        return id;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::endJobs()
+    {
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            jobsEnded = true;
+        }
+
+        postEmptyEvent();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::init()
+    {
+        initWindow();
+        initVulkan();
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::runFrame(float elapsed)
+    {
+        // Retrieve window-related events
+        pollEvents();
+
+        if (shouldClose())
+            return false;
+
+        // In on-demand mode, only render when needed
+        if (config.renderOnDemand)
+        {
+            bool timeElapsed = (config.onDemandMaxFrameInterval > 0.0f) &&
+                               (std::chrono::high_resolution_clock::now() - lastRedrawTime >=
+                                std::chrono::duration<double>(config.onDemandMaxFrameInterval));
+
+            if (!redrawRequested.exchange(false) && !timeElapsed)
+                return true;
+        }
+
+        processFrame(elapsed);
+
+        return true;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::shutdown()
+    {
+        waitForPresentation(lastSubmittedFrame.load());
+        waitForDeviceIdle();
+
+        cleanup();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::setDeviceContext(const std::shared_ptr<DeviceContext>& context)
+    {
+        if (device != VK_NULL_HANDLE)
+            throw std::runtime_error("The device context must be set before the initialisation!");
+
+        if (!context || (context->device == VK_NULL_HANDLE))
+            throw std::runtime_error("Invalid device context!");
+
+        deviceContext = context;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::initWindow()
+    {
+        // In headless mode, the offscreen images have the size of the window
+        if (config.headless)
+        {
+            if ((config.windowWidth == 0) || (config.windowHeight == 0))
+                throw std::runtime_error("Invalid size of the offscreen images!");
+
+            framebufferWidth = config.windowWidth;
+            framebufferHeight = config.windowHeight;
+            return;
+        }
+
+        if (nbGLFWUsers++ == 0)
+            glfwInit();
+
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+
+        window = glfwCreateWindow(
+            config.windowWidth, config.windowHeight, config.windowTitle.data(),
+            nullptr, nullptr
+        );
+
+        glfwSetWindowUserPointer(window, this);
+        glfwSetFramebufferSizeCallback(window, onFramebufferWindowResized);
+        glfwSetWindowRefreshCallback(window, onWindowRefresh);
+
+        int width, height;
+        glfwGetFramebufferSize(window, &width, &height);
+        framebufferWidth = width;
+        framebufferHeight = height;
+
+        // The input events must be forwarded to the rendering thread
+        if (config.useRenderThread)
+        {
+            glfwSetKeyCallback(window, onWindowKey);
+            glfwSetMouseButtonCallback(window, onWindowMouseButton);
+            glfwSetCursorPosCallback(window, onWindowCursorPosition);
+            glfwSetScrollCallback(window, onWindowScroll);
+        }
+
+        createAdditionalWindows();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::initVulkan()
+    {
+        // The view masks of the multiview render passes are 32-bit wide
+        if ((config.nbViews == 0) || (config.nbViews > 32))
+            throw std::runtime_error("Invalid number of views (must be between 1 and 32)!");
+
+        // Multiview rendering is a feature of Vulkan 1.1
+        if (config.nbViews > 1)
+        {
+#ifdef VK_API_VERSION_1_1
+            if (config.vulkanVersion < VK_API_VERSION_1_1)
+                throw std::runtime_error("Multiview rendering requires Vulkan 1.1!");
+
+            config.features11.multiview = VK_TRUE;
+
+            multiviewViewMask = UINT32_MAX >> (32 - config.nbViews);
+            multiviewCorrelationMask = multiviewViewMask;
+#else
+            throw std::runtime_error("Multiview rendering requires Vulkan 1.1!");
+#endif
+        }
+
+        // Use the shared instance and device if any, create them otherwise
+        if (deviceContext)
+        {
+            attachDeviceContext();
+        }
+        else
+        {
+            createInstance();
+            setupDebugMessenger();
+            createSurface();
+
+            pickPhysicalDevice();
+            createLogicalDevice();
+            createDeviceContext();
+        }
+
+        createSyncObjects();
+        createTimestampQueries();
+        startPresentThread();
+        setupFrameCapture();
+
+        createVulkanObjects();
+
+        createSwapChain();
+        createImageViews();
+        createRenderImages();
+        onSwapChainReady();
+
+        createWindowTargets();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::mainLoop()
+    {
+        if (config.benchmarkPresentationModes)
+        {
+            benchmarkPresentationModes();
+            return;
+        }
+
+        if (config.usePipelinedStages)
+        {
+            // The main thread only processes the window events, each stage of the
+            // processing of the frames runs on its own thread
+            std::exception_ptr exceptions[3] = { nullptr, nullptr, nullptr };
+
+            simulatedFrames.reset(config.nbFramesInFlight);
+            recordedFrames.reset(config.nbFramesInFlight);
+            lastRecordedFrame = lastSubmittedFrame.load();
+            lastProcessedFrame = lastRecordedFrame;
+
+            stopRendering = false;
+            renderThreadRunning = true;
+            pipelineRunning = true;
+
+            auto startStage = [this, &exceptions](int index, void (Application::*loop)()) {
+                return std::thread([this, &exceptions, index, loop]() {
+                    try
+                    {
+                        (this->*loop)();
+                    }
+                    catch (...)
+                    {
+                        exceptions[index] = std::current_exception();
+                    }
+
+                    stopPipeline();
+                    postEmptyEvent();
+                });
+            };
+
+            std::thread stages[] = {
+                startStage(0, &Application::simulateLoop),
+                startStage(1, &Application::recordLoop),
+                startStage(2, &Application::submitLoop),
+            };
+
+            // Use a timeout to notice when the stages stop on their own
+            while (!shouldClose() && !stopRendering)
+            {
+                waitEvents(0.1);
+                flushWindowEvents();
+            }
+
+            stopPipeline();
+
+            for (auto& stage : stages)
+                stage.join();
+
+            pipelineRunning = false;
+            renderThreadRunning = false;
+
+            waitForDeviceIdle();
+
+            for (auto& exception : exceptions)
+            {
+                if (exception)
+                    std::rethrow_exception(exception);
+            }
+
+            return;
+        }
+
+        if (config.useRenderThread)
+        {
+            // The main thread only processes the window events, everything else is done
+            // by the rendering thread
+            std::exception_ptr renderException = nullptr;
+
+            stopRendering = false;
+            renderThreadRunning = true;
+
+            std::thread renderThread([this, &renderException]() {
+                try
+                {
+                    renderLoop();
+                }
+                catch (...)
+                {
+                    renderException = std::current_exception();
+                }
+
+                stopRendering = true;
+                postEmptyEvent();
+            });
+
+            // Use a timeout to notice when the rendering thread stops on its own
+            while (!shouldClose() && !stopRendering)
+            {
+                waitEvents(0.1);
+                flushWindowEvents();
+            }
+
+            stopRendering = true;
+
+            {
+                // The rendering thread might be waiting for a redraw request
+                std::lock_guard<std::mutex> lock(redrawMutex);
+                redrawCondition.notify_one();
+            }
+
+            renderThread.join();
+            renderThreadRunning = false;
+
+            if (renderException)
+                std::rethrow_exception(renderException);
+
+            return;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        auto previousTime = startTime;
+
+        while (!shouldClose()) {
+            // In on-demand mode, wait for a new frame to be requested
+            if (config.renderOnDemand && !waitForRedrawRequest())
+                continue;
+
+            waitForNextFrame();
+
+            auto currentTime = std::chrono::high_resolution_clock::now();
+            float elapsed = std::chrono::duration<float, std::chrono::seconds::period>(
+                currentTime - previousTime
+            ).count();
+
+            // Retrieve window-related events
+            pollEvents();
+
+            processFrame(elapsed);
+
+            previousTime = currentTime;
+        }
+
+        // The present thread must not use the queues anymore
+        waitForPresentation(lastSubmittedFrame.load());
+        waitForDeviceIdle();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::benchmarkPresentationModes()
+    {
+        const uint32_t NB_WARMUP_FRAMES = 30;
+
+        if (config.headless)
+            throw std::runtime_error("Presentation modes can't be benchmarked in headless mode!");
+
+        swapChainSupportDetails_t swapChainSupport = querySwapChainSupport(physicalDevice);
+        const auto& capabilities = swapChainSupport.capabilities;
+
+        uint32_t maxImageCount = capabilities.minImageCount + 2;
+        if ((capabilities.maxImageCount > 0) && (maxImageCount > capabilities.maxImageCount))
+            maxImageCount = capabilities.maxImageCount;
+
+        const VkPresentModeKHR modes[] = {
+            VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR,
+            VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR
+        };
+
+        benchmarkResults.clear();
+
+        for (auto mode : modes)
+        {
+            if (std::find(swapChainSupport.presentationModes.begin(),
+                          swapChainSupport.presentationModes.end(), mode) ==
+                swapChainSupport.presentationModes.end())
+            {
+                continue;
+            }
+
+            for (uint32_t imageCount = capabilities.minImageCount; imageCount <= maxImageCount; ++imageCount)
+            {
+                // Recreate the swap chain with the combination to test
+                benchmarkPresentationMode = mode;
+                benchmarkImageCount = imageCount;
+                recreateSwapChain();
+
+                presentationBenchmarkResult_t result;
+                result.presentationMode = mode;
+                result.imageCount = imageCount;
+                result.submitToPresentMeasured = presentWaitSupported;
+
+                uint32_t nbMeasuredFrames = 0;
+                auto previousTime = std::chrono::high_resolution_clock::now();
+
+                for (uint32_t i = 0; i < NB_WARMUP_FRAMES + config.benchmarkNbFrames; ++i)
+                {
+                    if (shouldClose())
+                        break;
+
+                    waitForNextFrame();
+
+                    auto currentTime = std::chrono::high_resolution_clock::now();
+                    float elapsed = std::chrono::duration<float, std::chrono::seconds::period>(
+                        currentTime - previousTime
+                    ).count();
+
+                    pollEvents();
+
+                    processFrame(elapsed);
+
+                    previousTime = currentTime;
+
+                    if (i >= NB_WARMUP_FRAMES)
+                    {
+                        frameStatistics_t stats = getFrameStatistics();
+
+                        result.frameTime += stats.frameTime;
+                        result.inputToSubmitLatency += stats.inputToSubmitLatency;
+                        result.submitToPresentLatency += stats.submitToPresentLatency;
+                        ++nbMeasuredFrames;
+                    }
+                }
+
+                if (nbMeasuredFrames == 0)
+                    break;
+
+                result.frameTime /= nbMeasuredFrames;
+                result.inputToSubmitLatency /= nbMeasuredFrames;
+                result.submitToPresentLatency /= nbMeasuredFrames;
+
+                benchmarkResults.push_back(result);
+            }
+        }
+
+        // The benchmark is done, go back to the normal choices
+        benchmarkImageCount = 0;
+
+        waitForPresentation(lastSubmittedFrame.load());
+        waitForDeviceIdle();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::renderLoop()
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        auto previousTime = startTime;
+
+        while (!stopRendering && !shouldClose()) {
+            // In on-demand mode, wait for a new frame to be requested
+            if (config.renderOnDemand && !waitForRedrawRequest())
+                continue;
+
+            waitForNextFrame();
+
+            auto currentTime = std::chrono::high_resolution_clock::now();
+            float elapsed = std::chrono::duration<float, std::chrono::seconds::period>(
+                currentTime - previousTime
+            ).count();
+
+            // Process the window-related events forwarded by the main thread
+            processWindowEvents();
+
+            processFrame(elapsed);
+
+            previousTime = currentTime;
+        }
+
+        // The present thread must not use the queues anymore
+        waitForPresentation(lastSubmittedFrame.load());
+        waitForDeviceIdle();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::processFrame(float elapsed)
+    {
+        // In on-demand mode, the swap chain might need to be recreated before the
+        // frame can be drawn, since we don't continuously render
+        if (config.renderOnDemand && framebufferResized)
+        {
+            framebufferResized = false;
+            recreateSwapChain();
+        }
+
+        // Destroy the swap chains not used anymore
+        destroyRetiredSwapChains();
+
+        lastRedrawTime = std::chrono::high_resolution_clock::now();
+
+        // Without late latching, the input state is sampled at the start of the frame
+        frameStartTime = std::chrono::high_resolution_clock::now();
+
+        simulate(elapsed, currentFrame);
+
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+            statistics.simulateTime = std::chrono::duration<float, std::chrono::seconds::period>(
+                std::chrono::high_resolution_clock::now() - frameStartTime
+            ).count();
+        }
+
+        // Draw the frame (if necessary)
+        if (renderFrame(elapsed))
+        {
+            updateFrameStatistics(elapsed);
+
+            uint64_t nbFrames;
+            {
+                std::lock_guard<std::mutex> lock(statisticsMutex);
+                nbFrames = ++statistics.nbFrames;
+            }
+
+            // In headless mode, stop once the requested number of frames is rendered
+            if (config.headless && (config.headlessNbFrames > 0) &&
+                (nbFrames >= config.headlessNbFrames))
+            {
+                close();
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::renderFrame(float elapsed)
+    {
+        // Ensure we have allocated enough space for the user-supplied command buffers
+        uint32_t nbCommandBuffers = getNbCommandBuffers();
+        if (nbCommandBuffers == 0)
+            return false;
+
+        if (nbCommandBuffers != commandBufferList.size())
+            commandBufferList.resize(nbCommandBuffers);
+
+        drawFrame(elapsed);
+        return true;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::updateFrameStatistics(float elapsed)
+    {
+        // Use moving averages for the pacing statistics
+        const float smoothing = 0.05f;
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+
+        if (statistics.nbFrames == 0)
+            statistics.averageFrameTime = elapsed;
+        else
+            statistics.averageFrameTime += (elapsed - statistics.averageFrameTime) * smoothing;
+
+        float targetFrameTime = (config.targetFrameRate > 0.0f ?
+                                    1.0f / config.targetFrameRate :
+                                    statistics.averageFrameTime);
+
+        if (statistics.nbFrames > 0)
+        {
+            statistics.pacingJitter += (
+                std::abs(elapsed - targetFrameTime) - statistics.pacingJitter
+            ) * smoothing;
+        }
+
+        statistics.frameTime = elapsed;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::simulateLoop()
+    {
+        const uint32_t nbFramesInFlight = config.nbFramesInFlight;
+
+        uint64_t frameNumber = lastSubmittedFrame.load() + 1;
+        auto previousTime = std::chrono::high_resolution_clock::now();
+
+        while (!stopRendering)
+        {
+            // In on-demand mode, wait for a new frame to be requested
+            if (config.renderOnDemand && !waitForRedrawRequest())
+                continue;
+
+            waitForNextFrame();
+
+            auto currentTime = std::chrono::high_resolution_clock::now();
+            float elapsed = std::chrono::duration<float, std::chrono::seconds::period>(
+                currentTime - previousTime
+            ).count();
+
+            previousTime = currentTime;
+
+            // Process the window-related events forwarded by the main thread
+            processWindowEvents();
+
+            if (getNbCommandBuffers() == 0)
+                continue;
+
+            // The recording of the previous frame using the same frame context must be
+            // done
+            {
+                std::unique_lock<std::mutex> lock(pipelineMutex);
+                pipelineCondition.wait(lock, [this, frameNumber, nbFramesInFlight]() {
+                    return stopRendering || (lastRecordedFrame + nbFramesInFlight >= frameNumber);
+                });
+            }
+
+            if (stopRendering)
+                break;
+
+            pipelinedFrame_t frame;
+            frame.frameNumber = frameNumber;
+            frame.frameIndex = frameNumber % nbFramesInFlight;
+            frame.elapsed = elapsed;
+            frame.inputTime = std::chrono::high_resolution_clock::now();
+
+            lastRedrawTime = frame.inputTime;
+
+            simulate(elapsed, frame.frameIndex);
+
+            {
+                std::lock_guard<std::mutex> lock(statisticsMutex);
+                statistics.simulateTime = std::chrono::duration<float, std::chrono::seconds::period>(
+                    std::chrono::high_resolution_clock::now() - frame.inputTime
+                ).count();
+            }
+
+            updateFrameStatistics(elapsed);
+
+            if (!simulatedFrames.push(std::move(frame)))
+                break;
+
+            ++frameNumber;
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::recordLoop()
+    {
+        // Timeout used when acquiring a swap chain image, to not prevent the submission
+        // stage from presenting images (and thus releasing them) for too long
+        const uint64_t ACQUIRE_TIMEOUT = 1000000;
+
+        const uint32_t nbFramesInFlight = config.nbFramesInFlight;
+
+        pipelinedFrame_t frame;
+
+        while (simulatedFrames.pop(frame))
+        {
+            auto recordStart = std::chrono::high_resolution_clock::now();
+
+            // The previous frame using the same frame context must have gone through the
+            // submission stage before the context is reused (the simulation stage only
+            // waits for it to be recorded)
+            {
+                std::unique_lock<std::mutex> lock(pipelineMutex);
+                pipelineCondition.wait(lock, [this, &frame, nbFramesInFlight]() {
+                    return stopRendering ||
+                           (lastProcessedFrame + nbFramesInFlight >= frame.frameNumber);
+                });
+            }
+
+            if (stopRendering)
+                return;
+
+            VkResult result = VK_NOT_READY;
+            while (!stopRendering)
+            {
+                // When the swap chain must be recreated, wait for all the recorded frames
+                // to be submitted and presented first
+                if (presentOutOfDate.exchange(false) || framebufferResized ||
+                    (result == VK_ERROR_OUT_OF_DATE_KHR))
+                {
+                    {
+                        std::unique_lock<std::mutex> lock(pipelineMutex);
+                        pipelineCondition.wait(lock, [this]() {
+                            return stopRendering || (lastProcessedFrame >= lastRecordedFrame);
+                        });
+                    }
+
+                    if (stopRendering)
+                        return;
+
+                    recreateSwapChain();
+                }
+
+                result = acquireFrame(frame.frameIndex, ACQUIRE_TIMEOUT, frame.imageIndex);
+                if ((result == VK_SUCCESS) || (result == VK_SUBOPTIMAL_KHR))
+                    break;
+            }
+
+            if (stopRendering)
+                return;
+
+            // Destroy the swap chains not used anymore
+            destroyRetiredSwapChains();
+
+            // Ask the user code to record the command buffers
+            currentFrame = frame.frameIndex;
+            recordingFrameNumber = frame.frameNumber;
+
+            frame.commandBuffers.resize(getNbCommandBuffers());
+            getCommandBuffers(frame.elapsed, frame.imageIndex, frame.commandBuffers);
+
+            {
+                std::lock_guard<std::mutex> lock(statisticsMutex);
+                statistics.recordTime = std::chrono::duration<float, std::chrono::seconds::period>(
+                    std::chrono::high_resolution_clock::now() - recordStart
+                ).count();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(pipelineMutex);
+                lastRecordedFrame = frame.frameNumber;
+            }
+
+            pipelineCondition.notify_all();
+
+            if (!recordedFrames.push(std::move(frame)))
+                return;
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::submitLoop()
+    {
+        pipelinedFrame_t frame;
+
+        while (recordedFrames.pop(frame))
+        {
+            auto submitStart = std::chrono::high_resolution_clock::now();
+
+            VkResult result = submitFrame(
+                frame.frameIndex, frame.imageIndex, frame.commandBuffers.data(),
+                frame.commandBuffers.size(), frame.elapsed, frame.inputTime
+            );
+
+            // Let the recording stage recreate the swap chain if needed
+            if ((result == VK_ERROR_OUT_OF_DATE_KHR) || (result == VK_SUBOPTIMAL_KHR))
+                presentOutOfDate = true;
+            else if (result != VK_SUCCESS)
+                throw std::runtime_error("Failed to present swap chain image!");
+
+            uint64_t nbFrames;
+            {
+                std::lock_guard<std::mutex> lock(statisticsMutex);
+
+                statistics.submitTime = std::chrono::duration<float, std::chrono::seconds::period>(
+                    std::chrono::high_resolution_clock::now() - submitStart
+                ).count();
+
+                nbFrames = ++statistics.nbFrames;
+            }
+
+            // In headless mode, stop once the requested number of frames is rendered
+            if (config.headless && (config.headlessNbFrames > 0) &&
+                (nbFrames >= config.headlessNbFrames))
+            {
+                close();
+            }
+
+            {
+                // Notify the recording stage (which might be waiting to reuse the frame
+                // context, or to recreate the swap chain)
+                std::lock_guard<std::mutex> lock(pipelineMutex);
+                lastProcessedFrame = frame.frameNumber;
+            }
+
+            pipelineCondition.notify_all();
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::stopPipeline()
+    {
+        stopRendering = true;
+
+        simulatedFrames.stop();
+        recordedFrames.stop();
+
+        {
+            std::lock_guard<std::mutex> lock(pipelineMutex);
+        }
+
+        pipelineCondition.notify_all();
+
+        {
+            // The simulation stage might be waiting for a redraw request
+            std::lock_guard<std::mutex> lock(redrawMutex);
+        }
+
+        redrawCondition.notify_all();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::waitForNextFrame()
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<double> interval(
+            config.targetFrameRate > 0.0f ? 1.0 / config.targetFrameRate : 0.0
+        );
+
+#ifdef VK_KHR_present_wait
+        // Wait for the previous frame to be displayed, so the next one starts just after
+        // a vertical blank. Errors (like an out-of-date swap chain) are ignored, they
+        // will be reported by the next acquisition of a swap chain image.
+        //
+        // Only used to pace the frames (or to measure the presentation latency during
+        // a benchmark): without a frame rate limit, waiting would serialise the CPU and
+        // the display, and defeat the frames in flight.
+        if (presentWaitSupported && ((config.targetFrameRate > 0.0f) || (benchmarkImageCount > 0)) &&
+            (lastPresentId > 0) && !pipelineRunning)
+        {
+            // The swap chain must not be used concurrently by the present thread
+            waitForPresentation(lastPresentId);
+
+            uint64_t timeout = (config.targetFrameRate > 0.0f ?
+                std::chrono::duration_cast<std::chrono::nanoseconds>(interval * 2).count() :
+                100000000);
+
+            VkResult result = waitForPresent(device, swapChain, lastPresentId, timeout);
+
+            if (result == VK_SUCCESS)
+            {
+                std::lock_guard<std::mutex> lock(statisticsMutex);
+                statistics.submitToPresentLatency = std::chrono::duration<float, std::chrono::seconds::period>(
+                    std::chrono::high_resolution_clock::now() - lastSubmitTime
+                ).count();
+            }
+        }
+#endif
+
+        // Frame limiter
+        if (config.targetFrameRate > 0.0f)
+        {
+            auto deadline = nextFrameTime + std::chrono::duration_cast<
+                std::chrono::high_resolution_clock::duration
+            >(interval);
+
+            auto now = std::chrono::high_resolution_clock::now();
+
+            // Sleep during most of the remaining time (the precision of the sleep isn't
+            // good enough for the last part), then spin
+            const auto spinDuration = std::chrono::microseconds(2000);
+
+            if (deadline - now > spinDuration)
+                std::this_thread::sleep_for(deadline - now - spinDuration);
+
+            while (std::chrono::high_resolution_clock::now() < deadline)
+                std::this_thread::yield();
+
+            // Don't try to catch up if we are late by more than one frame
+            now = std::chrono::high_resolution_clock::now();
+            if (now - deadline > interval)
+                nextFrameTime = now;
+            else
+                nextFrameTime = deadline;
+        }
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        statistics.pacingTime = std::chrono::duration<float, std::chrono::seconds::period>(
+            std::chrono::high_resolution_clock::now() - start
+        ).count();
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::waitForRedrawRequest()
+    {
+        std::chrono::duration<double> maxInterval(config.onDemandMaxFrameInterval);
+
+        if (!redrawRequested)
+        {
+            double timeout = config.onDemandMaxFrameInterval - std::chrono::duration<double>(
+                std::chrono::high_resolution_clock::now() - lastRedrawTime
+            ).count();
+
+            if (renderThreadRunning)
+            {
+                // Wake up when a redraw is requested or some window events are received
+                std::unique_lock<std::mutex> lock(redrawMutex);
+
+                auto predicate = [this]() {
+                    return redrawRequested || stopRendering || !windowEvents.empty();
+                };
+
+                if (config.onDemandMaxFrameInterval <= 0.0f)
+                    redrawCondition.wait(lock, predicate);
+                else if (timeout > 0.0)
+                    redrawCondition.wait_for(lock, std::chrono::duration<double>(timeout), predicate);
+
+                lock.unlock();
+
+                // The user code might request a redraw while processing the events
+                processWindowEvents();
+            }
+            else
+            {
+                if (config.onDemandMaxFrameInterval <= 0.0f)
+                    waitEvents(-1.0);
+                else if (timeout > 0.0)
+                    waitEvents(timeout);
+            }
+        }
+
+        bool timeElapsed = (config.onDemandMaxFrameInterval > 0.0f) &&
+                           (std::chrono::high_resolution_clock::now() - lastRedrawTime >= maxInterval);
+
+        return redrawRequested.exchange(false) || timeElapsed;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::requestRedraw()
+    {
+        {
+            std::lock_guard<std::mutex> lock(redrawMutex);
+            redrawRequested = true;
+        }
+
+        redrawCondition.notify_one();
+
+        // Wake up the main thread if it is waiting for events
+        if (!renderThreadRunning)
+            postEmptyEvent();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::close()
+    {
+        closeRequested = true;
+
+        // Wake up the main thread if it is waiting for events
+        postEmptyEvent();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::addDamageRect(const VkRect2D& rect)
+    {
+        // Clamp the region to the swap chain extent
+        int32_t x0 = std::clamp(rect.offset.x, 0, int32_t(swapChainExtent.width));
+        int32_t y0 = std::clamp(rect.offset.y, 0, int32_t(swapChainExtent.height));
+        int32_t x1 = std::clamp(rect.offset.x + int32_t(rect.extent.width), x0, int32_t(swapChainExtent.width));
+        int32_t y1 = std::clamp(rect.offset.y + int32_t(rect.extent.height), y0, int32_t(swapChainExtent.height));
+
+        if ((x1 == x0) || (y1 == y0))
+            return;
+
+        frames[currentFrame].damageRects.push_back(
+            { { x0, y0 }, { uint32_t(x1 - x0), uint32_t(y1 - y0) } }
+        );
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkRect2D Application::getDamageRect(uint32_t imageIndex)
+    {
+        const VkRect2D fullRect = { { 0, 0 }, getRenderExtent() };
+
+        const frameContext_t& frame = frames[currentFrame];
+
+        // The previous content of the images written by compute shaders isn't preserved
+        if (!config.useDamageTracking || config.useDynamicResolution ||
+            config.useComputePresentation || frame.damageRects.empty())
+        {
+            return fullRect;
+        }
+
+        // Changes of the frames rendered since the image was last used
+        VkRect2D rect;
+        {
+            std::lock_guard<std::mutex> lock(damageMutex);
+
+            if (imageIndex >= imageDamageRects.size())
+                return fullRect;
+
+            rect = imageDamageRects[imageIndex];
+        }
+
+        // Changes of the current frame
+        for (const auto& damageRect : frame.damageRects)
+            rect = unionRects(rect, damageRect);
+
+        return rect;
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::shouldClose() const
+    {
+        if (closeRequested || (!config.headless && glfwWindowShouldClose(window)))
+            return true;
+
+        for (const auto& target : windowTargets)
+        {
+            if (glfwWindowShouldClose(target.window))
+                return true;
+        }
+
+        return false;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::pollEvents()
+    {
+        if (!config.headless)
+            glfwPollEvents();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::waitEvents(double timeout)
+    {
+        if (!config.headless)
+        {
+            if (timeout < 0.0)
+                glfwWaitEvents();
+            else
+                glfwWaitEventsTimeout(timeout);
+
+            return;
+        }
+
+        // Without window, only wait for an empty event to be posted
+        std::unique_lock<std::mutex> lock(eventMutex);
+
+        auto predicate = [this]() {
+            return eventPosted || closeRequested;
+        };
+
+        if (timeout < 0.0)
+            eventCondition.wait(lock, predicate);
+        else
+            eventCondition.wait_for(lock, std::chrono::duration<double>(timeout), predicate);
+
+        eventPosted = false;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::postEmptyEvent()
+    {
+        if (!config.headless)
+        {
+            glfwPostEmptyEvent();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            eventPosted = true;
+        }
+
+        eventCondition.notify_all();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::processWindowEvents()
+    {
+        windowEvent_t event;
+        while (windowEvents.pop(event))
+            onWindowEvent(event);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onWindowEvent(const windowEvent_t& event)
+    {
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::lateLatch(float elapsed, uint32_t imageIndex)
+    {
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::recordJob(
+        const renderJob_t& job, const renderTarget_t& target, uint32_t frameIndex,
+        VkCommandBuffer commandBuffer
+    )
+    {
+        throw std::runtime_error("recordJob() must be implemented to execute render jobs!");
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onRenderTargetCreated(renderTarget_t& target)
+    {
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onWindowSwapChainReady(uint32_t windowIndex)
+    {
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onWindowSwapChainAboutToBeDestroyed(uint32_t windowIndex)
+    {
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onRenderTargetAboutToBeDestroyed(renderTarget_t& target)
+    {
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::simulate(float elapsed, uint32_t frameIndex)
+    {
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::getFramebufferSize(int& width, int& height) const
+    {
+        // GLFW can only be used from the main thread (and there is no window in
+        // headless mode)
+        if (renderThreadRunning || config.headless)
+        {
+            width = framebufferWidth;
+            height = framebufferHeight;
+        }
+        else
+        {
+            glfwGetFramebufferSize(window, &width, &height);
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::postWindowEvent(const windowEvent_t& event)
+    {
+        // Maximum number of events kept while the rendering thread is late
+        const size_t MAX_NB_PENDING_EVENTS = 1024;
+
+        windowEvent_t timedEvent = event;
+        timedEvent.time = glfwGetTime();
+
+        // If the rendering thread is late, the events are kept until there is room in the
+        // queue. Consecutive cursor, scroll and resize events are merged, and only the
+        // cursor and scroll ones are dropped if too many events are pending (so no key
+        // or button is left pressed).
+        windowEvent_t* last = (pendingWindowEvents.empty() ? nullptr : &pendingWindowEvents.back());
+
+        if ((last != nullptr) && (last->type == timedEvent.type) &&
+            (timedEvent.type != WINDOW_EVENT_KEY) && (timedEvent.type != WINDOW_EVENT_MOUSE_BUTTON))
+        {
+            if (timedEvent.type == WINDOW_EVENT_SCROLL)
+            {
+                timedEvent.x += last->x;
+                timedEvent.y += last->y;
+            }
+
+            *last = timedEvent;
+        }
+        else if ((pendingWindowEvents.size() >= MAX_NB_PENDING_EVENTS) &&
+                 ((timedEvent.type == WINDOW_EVENT_CURSOR_POSITION) ||
+                  (timedEvent.type == WINDOW_EVENT_SCROLL)))
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+            ++statistics.nbDroppedWindowEvents;
+        }
+        else
+        {
+            pendingWindowEvents.push_back(timedEvent);
+        }
+
+        flushWindowEvents();
+
+        // Wake up the rendering thread if it is waiting for a redraw request
+        if (config.renderOnDemand)
+        {
+            std::lock_guard<std::mutex> lock(redrawMutex);
+            redrawCondition.notify_one();
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::flushWindowEvents()
+    {
+        while (!pendingWindowEvents.empty() && windowEvents.push(pendingWindowEvents.front()))
+            pendingWindowEvents.pop_front();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onWindowKey(GLFWwindow* window, int key, int scancode, int action, int mods)
+    {
+        auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+
+        windowEvent_t event;
+        event.type = WINDOW_EVENT_KEY;
+        event.key = key;
+        event.scancode = scancode;
+        event.action = action;
+        event.mods = mods;
+        app->postWindowEvent(event);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onWindowMouseButton(GLFWwindow* window, int button, int action, int mods)
+    {
+        auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+
+        windowEvent_t event;
+        event.type = WINDOW_EVENT_MOUSE_BUTTON;
+        event.button = button;
+        event.action = action;
+        event.mods = mods;
+        app->postWindowEvent(event);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onWindowCursorPosition(GLFWwindow* window, double x, double y)
+    {
+        auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+
+        windowEvent_t event;
+        event.type = WINDOW_EVENT_CURSOR_POSITION;
+        event.x = x;
+        event.y = y;
+        app->postWindowEvent(event);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onWindowScroll(GLFWwindow* window, double x, double y)
+    {
+        auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+
+        windowEvent_t event;
+        event.type = WINDOW_EVENT_SCROLL;
+        event.x = x;
+        event.y = y;
+        app->postWindowEvent(event);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onWindowRefresh(GLFWwindow* window)
+    {
+        auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+
+        // The content of the window must be drawn again (it was exposed)
+        if (app->config.renderOnDemand)
+            app->requestRedraw();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::onAdditionalWindowResized(GLFWwindow* window, int width, int height)
+    {
+        auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+
+        for (auto& target : app->windowTargets)
+        {
+            if (target.window == window)
+            {
+                target.framebufferWidth = width;
+                target.framebufferHeight = height;
+                target.outOfDate = true;
+                break;
+            }
+        }
+
+        if (app->config.renderOnDemand)
+            app->requestRedraw();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::drawFrame(float elapsed)
+    {
+        if (tryBeginFrame(UINT64_MAX) == FRAME_STATUS_READY)
+            endFrame(elapsed);
+    }
+
+    //-----------------------------------------------------------------------
+
+    frameStatus_t Application::tryBeginFrame(uint64_t timeout)
+    {
+        if (frameBegun)
+            return FRAME_STATUS_READY;
+
+        VkResult result = acquireFrame(currentFrame, timeout, frameImageIndex);
+
+        if ((result == VK_TIMEOUT) || (result == VK_NOT_READY))
+        {
+            return FRAME_STATUS_NOT_READY;
+        }
+        else if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            recreateSwapChain();
+
+            // The frame wasn't drawn
+            redrawRequested = true;
+            return FRAME_STATUS_SWAP_CHAIN_RECREATED;
+        }
+
+        frameBegun = true;
+
+        // The readbacks recorded from now on are done by the next frame
+        recordingFrameNumber = lastSubmittedFrame.load() + 1;
+
+        return FRAME_STATUS_READY;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::endFrame(float elapsed)
+    {
+        if (!frameBegun)
+            throw std::runtime_error("No frame was started!");
+
+        frameBegun = false;
+
+        // Ensure we have allocated enough space for the user-supplied command buffers
+        uint32_t nbCommandBuffers = getNbCommandBuffers();
+        if (nbCommandBuffers != commandBufferList.size())
+            commandBufferList.resize(nbCommandBuffers);
+
+        // Ask the user code to do some rendering
+        auto recordStart = std::chrono::high_resolution_clock::now();
+
+        getCommandBuffers(elapsed, frameImageIndex, commandBufferList);
+
+        finishFrame(elapsed, commandBufferList.data(), commandBufferList.size(), recordStart);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::finishFrame(
+        float elapsed, const VkCommandBuffer* commandBuffers, uint32_t nbCommandBuffers,
+        std::chrono::high_resolution_clock::time_point recordStart
+    )
+    {
+        auto submitStart = std::chrono::high_resolution_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+            statistics.recordTime = std::chrono::duration<float, std::chrono::seconds::period>(
+                submitStart - recordStart
+            ).count();
+        }
+
+        // Submit the command buffers and present the frame
+        VkResult result = submitFrame(
+            currentFrame, frameImageIndex, commandBuffers, nbCommandBuffers, elapsed,
+            frameStartTime
+        );
+
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+            statistics.submitTime = std::chrono::duration<float, std::chrono::seconds::period>(
+                std::chrono::high_resolution_clock::now() - submitStart
+            ).count();
+        }
+
+        // Handle errors from the frame presentation on screen
+        if ((result == VK_ERROR_OUT_OF_DATE_KHR) || (result == VK_SUBOPTIMAL_KHR) ||
+            framebufferResized)
+        {
+            framebufferResized = false;
+            recreateSwapChain();
+        }
+        else if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to present swap chain image!");
+        }
+
+        currentFrame = (currentFrame + 1) % config.nbFramesInFlight;
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkResult Application::acquireFrame(uint32_t frameIndex, uint64_t timeout, uint32_t& imageIndex)
+    {
+        frameContext_t& frame = frames[frameIndex];
+
+        // Wait for the previous frame using the same context to finish
+        auto waitStart = std::chrono::high_resolution_clock::now();
+
+        VkResult result;
+
+#ifdef VK_API_VERSION_1_2
+        if (frameTimelineSemaphore != VK_NULL_HANDLE)
+        {
+            VkSemaphoreWaitInfo waitInfo{};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &frameTimelineSemaphore;
+            waitInfo.pValues = &frame.frameNumber;
+
+            result = vkWaitSemaphores(device, &waitInfo, timeout);
+        }
+        else
+#endif
+        {
+            result = vkWaitForFences(device, 1, &frame.inFlightFence, VK_TRUE, timeout);
+        }
+
+        // The frame might be begun after several attempts: only the total wait time is
+        // reported
+        frameWaitTime += std::chrono::duration<float, std::chrono::seconds::period>(
+            std::chrono::high_resolution_clock::now() - waitStart
+        ).count();
+
+        if (result == VK_TIMEOUT)
+            return result;
+
+        // The frame that last used the context (and all the previous ones) is retired,
+        // its capture can be saved
+        retireReadbacks(frame.frameNumber);
+
+        // Its GPU time is known, the render resolution can be adapted
+        if (config.useDynamicResolution)
+            updateResolutionScale(frameIndex);
+
+        // Acquire an image from the swap chain (the swap chain might be used by the
+        // submission stage at the same time in pipelined mode). In headless mode, the
+        // offscreen images are used in turn: since there are at least as many as frames
+        // in flight, the frame that last used the next one is already retired.
+        if (config.headless)
+        {
+            imageIndex = nextOffscreenImage;
+            nextOffscreenImage = (nextOffscreenImage + 1) % swapChainImages.size();
+            result = VK_SUCCESS;
+        }
+        else
+        {
+            result = acquireSwapChainImage(
+                swapChain, timeout, frame.imageAvailableSemaphore, imageIndex
+            );
+        }
+
+        if ((result == VK_TIMEOUT) || (result == VK_NOT_READY) ||
+            (result == VK_ERROR_OUT_OF_DATE_KHR))
+        {
+            return result;
+        }
+        else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+        {
+            throw std::runtime_error("Failed to acquire swap chain image!");
+        }
+
+        acquireWindowImages(frameIndex, timeout);
+
+        if (frame.inFlightFence != VK_NULL_HANDLE)
+            vkResetFences(device, 1, &frame.inFlightFence);
+
+        // The command buffers allocated from the frame's command pool aren't in use
+        // anymore
+        vkResetCommandPool(device, frame.commandPool, 0);
+
+        frame.renderExtent = renderExtent;
+        frame.damageRects.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+            statistics.waitTime = frameWaitTime;
+        }
+
+        frameWaitTime = 0.0f;
+
+        return result;
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkResult Application::acquireSwapChainImage(
+        VkSwapchainKHR swapChain, uint64_t timeout, VkSemaphore semaphore,
+        uint32_t& imageIndex
+    )
+    {
+        // Without other thread using the swap chains, no need to serialise anything
+        if (!presentThread.joinable() && !pipelineRunning)
+        {
+            return vkAcquireNextImageKHR(
+                device, swapChain, timeout, semaphore, VK_NULL_HANDLE, &imageIndex
+            );
+        }
+
+        // Never wait for an image while holding the lock: the image might only be
+        // released by a presentation done by the other thread
+        const uint64_t ATTEMPT_TIMEOUT = 1000000;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        while (true)
+        {
+            VkResult result;
+
+            {
+                std::lock_guard<std::mutex> lock(swapChainMutex);
+
+                result = vkAcquireNextImageKHR(
+                    device, swapChain, std::min(timeout, ATTEMPT_TIMEOUT), semaphore,
+                    VK_NULL_HANDLE, &imageIndex
+                );
+            }
+
+            if ((result != VK_TIMEOUT) && (result != VK_NOT_READY))
+                return result;
+
+            uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::high_resolution_clock::now() - start
+            ).count();
+
+            if (elapsed >= timeout)
+                return result;
+
+            std::this_thread::yield();
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkResult Application::submitFrame(
+        uint32_t frameIndex, uint32_t imageIndex,
+        const VkCommandBuffer* commandBuffers, uint32_t nbCommandBuffers, float elapsed,
+        std::chrono::high_resolution_clock::time_point inputTime
+    )
+    {
+        frameContext_t& frame = frames[frameIndex];
+        VkResult result;
+
+        // Let the user code sample the latest input state
+        if (config.useLateLatch)
+        {
+            inputTime = std::chrono::high_resolution_clock::now();
+            lateLatch(elapsed, imageIndex);
+        }
+
+        // Submit the command buffer (waiting for the images of all the windows)
+        std::array<VkSemaphore, MAX_NB_WINDOWS> waitSemaphores;
+        std::array<VkPipelineStageFlags, MAX_NB_WINDOWS> waitStages;
+        uint32_t nbWaitSemaphores = 0;
+
+        // (the images written by compute shaders are needed earlier)
+        waitSemaphores[nbWaitSemaphores] = frame.imageAvailableSemaphore;
+        waitStages[nbWaitSemaphores] = config.useComputePresentation ?
+                                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT :
+                                            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        ++nbWaitSemaphores;
+
+        for (const auto& target : windowTargets)
+        {
+            if (target.imageIndex != UINT32_MAX)
+            {
+                waitSemaphores[nbWaitSemaphores] = target.imageAvailableSemaphores[frameIndex];
+                waitStages[nbWaitSemaphores] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                ++nbWaitSemaphores;
+            }
+        }
+
+        VkSemaphore signalSemaphores[] = {
+            frame.renderFinishedSemaphore
+        };
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.waitSemaphoreCount = nbWaitSemaphores;
+        submitInfo.pWaitSemaphores = waitSemaphores.data();
+        submitInfo.pWaitDstStageMask = waitStages.data();
+        submitInfo.commandBufferCount = nbCommandBuffers;
+        submitInfo.pCommandBuffers = commandBuffers;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = signalSemaphores;
+
+        uint64_t frameNumber = lastSubmittedFrame.load() + 1;
+
+#ifdef VK_API_VERSION_1_2
+        // Also signal the timeline semaphore with the number of the frame (the value
+        // is ignored for the binary semaphore)
+        VkSemaphore timelineSignalSemaphores[] = {
+            frame.renderFinishedSemaphore,
+            frameTimelineSemaphore
+        };
+
+        uint64_t timelineSignalValues[] = {
+            0,
+            frameNumber
+        };
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.signalSemaphoreValueCount = 2;
+        timelineInfo.pSignalSemaphoreValues = timelineSignalValues;
+
+        if (frameTimelineSemaphore != VK_NULL_HANDLE)
+        {
+            submitInfo.pNext = &timelineInfo;
+            submitInfo.signalSemaphoreCount = 2;
+            submitInfo.pSignalSemaphores = timelineSignalSemaphores;
+        }
+#endif
+
+        // In headless mode, there is no swap chain image to wait for, and no presentation
+        // to signal
+        if (config.headless)
+        {
+            submitInfo.waitSemaphoreCount = 0;
+            submitInfo.signalSemaphoreCount = 0;
+
+#ifdef VK_API_VERSION_1_2
+            if (frameTimelineSemaphore != VK_NULL_HANDLE)
+            {
+                timelineInfo.signalSemaphoreValueCount = 1;
+                timelineInfo.pSignalSemaphoreValues = &frameNumber;
+
+                submitInfo.signalSemaphoreCount = 1;
+                submitInfo.pSignalSemaphores = &frameTimelineSemaphore;
+            }
+#endif
+        }
+
+        // Surround the command buffers of the user with the ones measuring the GPU time
+        // and scaling the render image, if the dynamic resolution is used, or the ones
+        // transitioning the layout of the image written by compute shaders
+        submittedCommandBuffers.clear();
+
+        VkCommandBuffer beginCommandBuffer = VK_NULL_HANDLE;
+        VkCommandBuffer endCommandBuffer = VK_NULL_HANDLE;
+
+        if (config.useDynamicResolution)
+        {
+            recordDynamicResolutionCommands(
+                frame, frameIndex, imageIndex, beginCommandBuffer, endCommandBuffer
+            );
+        }
+        else if (config.useComputePresentation)
+        {
+            recordComputePresentationCommands(
+                frame, imageIndex, beginCommandBuffer, endCommandBuffer
+            );
+        }
+
+        if (beginCommandBuffer != VK_NULL_HANDLE)
+        {
+            submittedCommandBuffers.push_back(beginCommandBuffer);
+            submittedCommandBuffers.insert(
+                submittedCommandBuffers.end(), commandBuffers, commandBuffers + nbCommandBuffers
+            );
+            submittedCommandBuffers.push_back(endCommandBuffer);
+        }
+
+        // Copy the image into a readback buffer if the frame must be captured
+        VkCommandBuffer captureCommandBuffer = VK_NULL_HANDLE;
+        if ((config.captureInterval > 0) && (frameNumber % config.captureInterval == 0) &&
+            recordFrameCapture(frame, imageIndex, frameNumber, captureCommandBuffer))
+        {
+            if (submittedCommandBuffers.empty())
+                submittedCommandBuffers.assign(commandBuffers, commandBuffers + nbCommandBuffers);
+
+            submittedCommandBuffers.push_back(captureCommandBuffer);
+        }
+
+        if (!submittedCommandBuffers.empty())
+        {
+            submitInfo.commandBufferCount = submittedCommandBuffers.size();
+            submitInfo.pCommandBuffers = submittedCommandBuffers.data();
+        }
+
+        // The previous presentation waiting for the 'render finished' semaphore of the
+        // frame context must have been done before it can be signaled again
+        waitForPresentation(frame.frameNumber);
+
+        {
+            // The queue can be used by other threads, or shared with other applications
+            std::lock_guard<std::mutex> lock(deviceContext->queueMutex);
+
+            if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, frame.inFlightFence) != VK_SUCCESS)
+                throw std::runtime_error("Failed to submit draw command buffer!");
+        }
+
+        lastSubmitTime = std::chrono::high_resolution_clock::now();
+
+        frame.frameNumber = frameNumber;
+        lastSubmittedFrame.store(frameNumber);
+
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+
+            statistics.inputToSubmitLatency = std::chrono::duration<float, std::chrono::seconds::period>(
+                lastSubmitTime - inputTime
+            ).count();
+
+            statistics.nbCapturedFrames = nbCapturedFrames.load();
+            statistics.nbDroppedCaptures = nbDroppedCaptures.load();
+        }
+
+        presentRequest_t request;
+
+        if (config.useDamageTracking)
+            trackFrameDamage(frameIndex, imageIndex, request);
+
+        if (config.headless)
+            return VK_SUCCESS;
+
+        // Presentation
+        request.swapChain = swapChain;
+        request.imageIndex = imageIndex;
+        request.waitSemaphore = frame.renderFinishedSemaphore;
+        request.frameNumber = frameNumber;
+
+        // The images of the additional windows are presented at the same time
+        for (uint32_t i = 0; i < windowTargets.size(); ++i)
+        {
+            const windowTarget_t& target = windowTargets[i];
+
+            if (target.imageIndex != UINT32_MAX)
+            {
+                request.additionalSwapChains[request.nbAdditionalSwapChains] = target.swapChain;
+                request.additionalImageIndices[request.nbAdditionalSwapChains] = target.imageIndex;
+                request.additionalWindowIndices[request.nbAdditionalSwapChains] = i;
+                ++request.nbAdditionalSwapChains;
+            }
+        }
+
+        // Identify the presentation, so we can wait for it later
+        if (presentWaitSupported)
+        {
+            request.presentId = frameNumber;
+            lastPresentId = frameNumber;
+        }
+
+        if (presentThread.joinable())
+        {
+            // Let the present thread do it (the ring can't be full, since at most one
+            // presentation per frame-in-flight can be pending)
+            {
+                std::lock_guard<std::mutex> lock(presentMutex);
+                presentRequests.push(request);
+            }
+
+            presentCondition.notify_all();
+
+            // Errors are reported asynchronously, by the previous presentations
+            result = presentError.exchange(VK_SUCCESS);
+            if (presentOutOfDate.exchange(false))
+                result = VK_ERROR_OUT_OF_DATE_KHR;
+        }
+        else
+        {
+            result = presentFrame(request);
+        }
+
+        return result;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::trackFrameDamage(uint32_t frameIndex, uint32_t imageIndex, presentRequest_t& request)
+    {
+        frameContext_t& frame = frames[frameIndex];
+
+        const VkRect2D fullRect = { { 0, 0 }, swapChainExtent };
+
+        // Without any region, the whole image changed
+        VkRect2D frameRect = { { 0, 0 }, { 0, 0 } };
+        for (const auto& damageRect : frame.damageRects)
+            frameRect = unionRects(frameRect, damageRect);
+
+        if (frame.damageRects.empty() || config.useDynamicResolution)
+            frameRect = fullRect;
+
+        {
+            std::lock_guard<std::mutex> lock(damageMutex);
+
+            // After the creation of the swap chain, the images must be fully rendered
+            if (imageDamageRects.size() != swapChainImages.size())
+                imageDamageRects.assign(swapChainImages.size(), fullRect);
+
+            // The other images don't contain the changes of this frame yet, while this one
+            // is now up-to-date
+            for (uint32_t i = 0; i < imageDamageRects.size(); ++i)
+                imageDamageRects[i] = unionRects(imageDamageRects[i], frameRect);
+
+            imageDamageRects[imageIndex] = { { 0, 0 }, { 0, 0 } };
+        }
+
+        // The regions are passed to the presentation engine (their bounding box if there
+        // are too many of them)
+        if (incrementalPresentSupported && !frame.damageRects.empty() && !config.useDynamicResolution)
+        {
+            if (frame.damageRects.size() <= MAX_NB_DAMAGE_RECTS)
+            {
+                std::copy(frame.damageRects.begin(), frame.damageRects.end(), request.damageRects.begin());
+                request.nbDamageRects = frame.damageRects.size();
+            }
+            else
+            {
+                request.damageRects[0] = frameRect;
+                request.nbDamageRects = 1;
+            }
+        }
+
+        frame.damageRects.clear();
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkResult Application::presentFrame(const presentRequest_t& request)
+    {
+        // The swap chains of all the windows are presented together (the main one first)
+        uint32_t nbSwapChains = 1 + request.nbAdditionalSwapChains;
+
+        std::array<VkSwapchainKHR, MAX_NB_WINDOWS> swapChains;
+        std::array<uint32_t, MAX_NB_WINDOWS> imageIndices;
+        std::array<uint64_t, MAX_NB_WINDOWS> presentIds;
+        std::array<VkResult, MAX_NB_WINDOWS> results;
+
+        swapChains[0] = request.swapChain;
+        imageIndices[0] = request.imageIndex;
+        presentIds[0] = request.presentId;
+
+        for (uint32_t i = 1; i < nbSwapChains; ++i)
+        {
+            swapChains[i] = request.additionalSwapChains[i - 1];
+            imageIndices[i] = request.additionalImageIndices[i - 1];
+            presentIds[i] = 0;
+        }
+
+        VkPresentInfoKHR presentInfo{};
+        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        presentInfo.waitSemaphoreCount = 1;
+        presentInfo.pWaitSemaphores = &request.waitSemaphore;
+        presentInfo.swapchainCount = nbSwapChains;
+        presentInfo.pSwapchains = swapChains.data();
+        presentInfo.pImageIndices = imageIndices.data();
+        presentInfo.pResults = results.data();
+
+#ifdef VK_KHR_present_id
+        VkPresentIdKHR presentId{};
+        presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        presentId.swapchainCount = nbSwapChains;
+        presentId.pPresentIds = presentIds.data();
+
+        if (request.presentId > 0)
+            presentInfo.pNext = &presentId;
+#endif
+
+#ifdef VK_KHR_incremental_present
+        // Only the main window is concerned by the damage tracking, the whole images of
+        // the additional windows changed
+        std::array<VkRectLayerKHR, MAX_NB_DAMAGE_RECTS> rectangles;
+        std::array<VkPresentRegionKHR, MAX_NB_WINDOWS> regions{};
+
+        for (uint32_t i = 0; i < request.nbDamageRects; ++i)
+        {
+            rectangles[i].offset = request.damageRects[i].offset;
+            rectangles[i].extent = request.damageRects[i].extent;
+            rectangles[i].layer = 0;
+        }
+
+        regions[0].rectangleCount = request.nbDamageRects;
+        regions[0].pRectangles = rectangles.data();
+
+        VkPresentRegionsKHR presentRegions{};
+        presentRegions.sType = VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR;
+        presentRegions.swapchainCount = nbSwapChains;
+        presentRegions.pRegions = regions.data();
+
+        if (request.nbDamageRects > 0)
+        {
+            presentRegions.pNext = presentInfo.pNext;
+            presentInfo.pNext = &presentRegions;
+        }
+#endif
+
+        VkResult result;
+
+        {
+            std::unique_lock<std::mutex> swapChainLock(swapChainMutex, std::defer_lock);
+            if (presentThread.joinable() || pipelineRunning)
+                swapChainLock.lock();
+
+            std::lock_guard<std::mutex> queueLock(deviceContext->queueMutex);
+
+            result = vkQueuePresentKHR(presentationQueue, &presentInfo);
+        }
+
+        if ((result != VK_SUCCESS) && (result != VK_SUBOPTIMAL_KHR) &&
+            (result != VK_ERROR_OUT_OF_DATE_KHR))
+        {
+            return result;
+        }
+
+        // The swap chains of the additional windows are recreated before their next
+        // image is acquired
+        for (uint32_t i = 1; i < nbSwapChains; ++i)
+        {
+            if ((results[i] == VK_ERROR_OUT_OF_DATE_KHR) || (results[i] == VK_SUBOPTIMAL_KHR))
+                windowTargets[request.additionalWindowIndices[i - 1]].outOfDate = true;
+            else if (results[i] != VK_SUCCESS)
+                return results[i];
+        }
+
+        return results[0];
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::presentLoop()
+    {
+        while (true)
+        {
+            presentRequest_t request;
+
+            {
+                std::unique_lock<std::mutex> lock(presentMutex);
+
+                presentCondition.wait(lock, [this]() {
+                    return stopPresenting || !presentRequests.empty();
+                });
+
+                // Only stop once all the pending presentations are done
+                if (!presentRequests.pop(request))
+                    break;
+            }
+
+            VkResult result = presentFrame(request);
+
+            // Report the errors to the rendering thread, which will recreate the swap
+            // chain if needed
+            if ((result == VK_ERROR_OUT_OF_DATE_KHR) || (result == VK_SUBOPTIMAL_KHR))
+                presentOutOfDate = true;
+            else if (result != VK_SUCCESS)
+                presentError = result;
+
+            {
+                std::lock_guard<std::mutex> lock(presentMutex);
+                lastPresentedFrame = request.frameNumber;
+            }
+
+            presentCondition.notify_all();
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::startPresentThread()
+    {
+        if (!config.usePresentThread || config.usePipelinedStages || config.headless)
+            return;
+
+        stopPresenting = false;
+        lastPresentedFrame = lastSubmittedFrame.load();
+
+        presentThread = std::thread(&Application::presentLoop, this);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::stopPresentThread()
+    {
+        if (!presentThread.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(presentMutex);
+            stopPresenting = true;
+        }
+
+        presentCondition.notify_all();
+        presentThread.join();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::waitForPresentation(uint64_t frameNumber)
+    {
+        if (!presentThread.joinable())
+            return;
+
+        std::unique_lock<std::mutex> lock(presentMutex);
+        presentCondition.wait(lock, [this, frameNumber]() {
+            return lastPresentedFrame >= frameNumber;
+        });
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::saveCapture(const frameCapture_t& capture)
+    {
+        char suffix[32];
+
+        switch (config.captureFormat)
+        {
+            case CAPTURE_FORMAT_PNG:
+                snprintf(suffix, sizeof(suffix), "_%06llu.png", (unsigned long long) capture.frameNumber);
+                return writePNG(config.capturePrefix + suffix, capture);
+
+            case CAPTURE_FORMAT_PPM:
+                snprintf(suffix, sizeof(suffix), "_%06llu.ppm", (unsigned long long) capture.frameNumber);
+                return writePPM(config.capturePrefix + suffix, capture);
+
+            case CAPTURE_FORMAT_Y4M:
+                // All the frames are written in the same file, so they must have the
+                // same size
+                if (!captureVideoFile.is_open())
+                {
+                    captureVideoFile.open(config.capturePrefix + ".y4m", std::ios::binary);
+                    if (!captureVideoFile.is_open())
+                        return false;
+
+                    captureVideoExtent = { capture.width, capture.height };
+
+                    captureVideoFile << "YUV4MPEG2 W" << capture.width << " H" << capture.height
+                                     << " F" << config.captureFrameRate << ":1 Ip A1:1 C444\n";
+                }
+                else if ((capture.width != captureVideoExtent.width) ||
+                         (capture.height != captureVideoExtent.height))
+                {
+                    return false;
+                }
+
+                return writeY4MFrame(captureVideoFile, capture);
+        }
+
+        return false;
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::saveJobOutput(const renderJob_t& job, const frameCapture_t& image)
+    {
+        size_t pos = job.outputPath.find_last_of('.');
+        if (pos == std::string::npos)
+            return false;
+
+        std::string extension = job.outputPath.substr(pos + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+        if (extension == "png")
+            return writePNG(job.outputPath, image);
+        else if (extension == "ppm")
+            return writePPM(job.outputPath, image);
+
+        return false;
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::waitForJob(renderJob_t& job)
+    {
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(jobMutex);
+
+                if (!jobs.empty())
+                {
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                    return true;
+                }
+
+                if (jobsEnded)
+                    return false;
+            }
+
+            if (shouldClose())
+                return false;
+
+            // Woken up by submitJob(), endJobs() or close()
+            waitEvents(-1.0);
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::processJob(const renderJob_t& job)
+    {
+        // Wait for the frame context to be available (the job that last used it is then
+        // retired, and its image handed to the readback thread)
+        uint32_t imageIndex;
+        acquireFrame(currentFrame, UINT64_MAX, imageIndex);
+
+        frameContext_t& frame = frames[currentFrame];
+
+        // The job is rendered by the next frame
+        uint64_t frameNumber = lastSubmittedFrame.load() + 1;
+        recordingFrameNumber = frameNumber;
+
+        renderTarget_t& target = renderTargets[acquireRenderTarget(job.extent, job.format)];
+        target.frameNumber = frameNumber;
+
+        // Record the job in a command buffer allocated from the pool of the frame
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = frame.commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate job command buffer!");
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+        recordJob(job, target, currentFrame, commandBuffer);
+
+        // The image is saved by the readback thread once the frame is retired
+        readbackImage(
+            commandBuffer, target.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            job.extent.width, job.extent.height, 4, VK_IMAGE_ASPECT_COLOR_BIT,
+            [this, job, frameNumber](const void* data, VkDeviceSize size) {
+                frameCapture_t image;
+                image.frameNumber = frameNumber;
+                image.width = job.extent.width;
+                image.height = job.extent.height;
+                image.format = job.format;
+                image.data = static_cast<const uint8_t*>(data);
+
+                if (saveJobOutput(job, image))
+                    ++nbCompletedJobs;
+                else
+                    ++nbFailedJobs;
+            }
+        );
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record job command buffer!");
+
+        submitFrame(
+            currentFrame, imageIndex, &commandBuffer, 1, 0.0f,
+            std::chrono::high_resolution_clock::now()
+        );
+
+        currentFrame = (currentFrame + 1) % config.nbFramesInFlight;
+    }
+
+    //-----------------------------------------------------------------------
+
+    size_t Application::acquireRenderTarget(VkExtent2D extent, VkFormat format)
+    {
+        for (size_t i = 0; i < renderTargets.size(); ++i)
+        {
+            const renderTarget_t& target = renderTargets[i];
+
+            if ((target.extent.width == extent.width) &&
+                (target.extent.height == extent.height) &&
+                (target.format == format) && isFrameRetired(target.frameNumber))
+            {
+                return i;
+            }
+        }
+
+        renderTarget_t target;
+        target.extent = extent;
+        target.format = format;
+
+        createImage(
+            extent.width, extent.height, 1, VK_SAMPLE_COUNT_1_BIT, format,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, target.image, target.memory
+        );
+
+        target.imageView = createImageView(target.image, format, VK_IMAGE_ASPECT_COLOR_BIT, 1);
+
+        onRenderTargetCreated(target);
+
+        renderTargets.push_back(target);
+        jobStatistics.nbRenderTargets = renderTargets.size();
+
+        return renderTargets.size() - 1;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::destroyRenderTargets()
+    {
+        for (auto& target : renderTargets)
+        {
+            onRenderTargetAboutToBeDestroyed(target);
+
+            vkDestroyImageView(device, target.imageView, nullptr);
+            vkDestroyImage(device, target.image, nullptr);
+            vkFreeMemory(device, target.memory, nullptr);
+        }
+
+        renderTargets.clear();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::updateJobStatistics()
+    {
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            jobStatistics.nbSubmittedJobs = nbSubmittedJobs;
+        }
+
+        jobStatistics.nbCompletedJobs = nbCompletedJobs.load();
+        jobStatistics.nbFailedJobs = nbFailedJobs.load();
+
+        jobStatistics.elapsedTime = std::chrono::duration<float, std::chrono::seconds::period>(
+            std::chrono::high_resolution_clock::now() - jobsStartTime
+        ).count();
+
+        if (jobStatistics.elapsedTime > 0.0f)
+            jobStatistics.jobsPerSecond = jobStatistics.nbCompletedJobs / jobStatistics.elapsedTime;
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::recordFrameCapture(
+        frameContext_t& frame, uint32_t imageIndex, uint64_t frameNumber,
+        VkCommandBuffer& commandBuffer
+    )
+    {
+        // Find a free readback buffer (the capture is dropped if the saving of the
+        // previous ones is late)
+        captureSlot_t* slot = nullptr;
+        uint32_t slotIndex = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(readbackMutex);
+
+            for (slotIndex = 0; slotIndex < captureSlots.size(); ++slotIndex)
+            {
+                if (!captureSlots[slotIndex].used)
+                {
+                    slot = &captureSlots[slotIndex];
+                    slot->used = true;
+                    break;
+                }
+            }
+        }
+
+        if (slot == nullptr)
+        {
+            ++nbDroppedCaptures;
+            return false;
+        }
+
+        // (Re)create the buffer if it is too small (it isn't used by the GPU anymore)
+        VkDeviceSize size = VkDeviceSize(swapChainExtent.width) * swapChainExtent.height * 4;
+        if (slot->size < size)
+        {
+            if (slot->buffer != VK_NULL_HANDLE)
+            {
+                vkDestroyBuffer(device, slot->buffer, nullptr);
+                vkFreeMemory(device, slot->memory, nullptr);
+            }
+
+            createReadbackBuffer(size, slot->buffer, slot->memory, slot->data);
+            slot->size = size;
+        }
+
+        slot->capture.frameNumber = frameNumber;
+        slot->capture.width = swapChainExtent.width;
+        slot->capture.height = swapChainExtent.height;
+        slot->capture.format = surfaceImageFormat;
+        slot->capture.data = nullptr;
+
+        // Record the copy in a command buffer allocated from the pool of the frame
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = frame.commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate capture command buffer!");
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+        VkImageMemoryBarrier imageBarrier{};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = swapChainImages[imageIndex];
+        imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageBarrier.subresourceRange.baseMipLevel = 0;
+        imageBarrier.subresourceRange.levelCount = 1;
+        imageBarrier.subresourceRange.baseArrayLayer = 0;
+        imageBarrier.subresourceRange.layerCount = 1;
+
+        // Wait for the rendering of the frame. The image was last written either by a
+        // render pass, by the blit of the dynamic resolution or by compute shaders, and
+        // the barriers putting it in 'captureImageLayout' end at the bottom of the
+        // pipe: all the commands must be waited for to chain with them.
+        imageBarrier.oldLayout = config.captureImageLayout;
+        imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        imageBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &imageBarrier
+        );
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = { swapChainExtent.width, swapChainExtent.height, 1 };
+
+        vkCmdCopyImageToBuffer(
+            commandBuffer, swapChainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            slot->buffer, 1, &region
+        );
+
+        // Put the image back in its layout, and make the copy visible to the CPU
+        imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        imageBarrier.newLayout = config.captureImageLayout;
+        imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        imageBarrier.dstAccessMask = 0;
+
+        VkBufferMemoryBarrier bufferBarrier{};
+        bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.buffer = slot->buffer;
+        bufferBarrier.offset = 0;
+        bufferBarrier.size = VK_WHOLE_SIZE;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr,
+            1, &bufferBarrier,
+            1, &imageBarrier
+        );
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record capture command buffer!");
+
+        // The capture can be saved once the frame is retired
+        {
+            std::lock_guard<std::mutex> lock(readbackMutex);
+            pendingReadbacks.emplace_back(frameNumber, [this, slotIndex]() {
+                saveCaptureSlot(slotIndex);
+            });
+        }
+
+        return true;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::saveCaptureSlot(uint32_t slotIndex)
+    {
+        captureSlot_t& slot = captureSlots[slotIndex];
+
+        // Make the copy done by the GPU visible (if the memory isn't coherent)
+        VkMappedMemoryRange range{};
+        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = slot.memory;
+        range.offset = 0;
+        range.size = VK_WHOLE_SIZE;
+
+        vkInvalidateMappedMemoryRanges(device, 1, &range);
+
+        slot.capture.data = static_cast<const uint8_t*>(slot.data);
+
+        if (saveCapture(slot.capture))
+            ++nbCapturedFrames;
+        else
+            ++nbDroppedCaptures;
+
+        {
+            std::lock_guard<std::mutex> lock(readbackMutex);
+            slot.used = false;
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::setupFrameCapture()
+    {
+        if (config.captureInterval == 0)
+            return;
+
+        // Only the common 4-bytes formats can be saved
+        switch (surfaceImageFormat)
+        {
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+                break;
+
+            default:
+                throw std::runtime_error("Format of the swap chain images not supported by the frame capture!");
+        }
+
+        captureSlots.resize(std::max(config.captureNbBuffers, 1u));
+
+        startReadbackThread();
+    }
+
+    //-----------------------------------------------------------------------
+
+    std::future<std::vector<uint8_t>> Application::readbackBuffer(
+        VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset,
+        VkDeviceSize size, const readbackCallback_t& callback
+    )
+    {
+        return recordReadback(
+            commandBuffer, size,
+            [commandBuffer, buffer, offset, size](VkBuffer dstBuffer) {
+                VkBufferCopy copyRegion{};
+                copyRegion.srcOffset = offset;
+                copyRegion.dstOffset = 0;
+                copyRegion.size = size;
+
+                vkCmdCopyBuffer(commandBuffer, buffer, dstBuffer, 1, &copyRegion);
+            },
+            callback
+        );
+    }
+
+    //-----------------------------------------------------------------------
+
+    std::future<std::vector<uint8_t>> Application::readbackImage(
+        VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout,
+        uint32_t width, uint32_t height, uint32_t bytesPerPixel,
+        VkImageAspectFlags aspectFlags, const readbackCallback_t& callback
+    )
+    {
+        return recordReadback(
+            commandBuffer, VkDeviceSize(width) * height * bytesPerPixel,
+            [commandBuffer, image, layout, width, height, aspectFlags](VkBuffer dstBuffer) {
+                VkBufferImageCopy region{};
+                region.bufferOffset = 0;
+                region.bufferRowLength = 0;
+                region.bufferImageHeight = 0;
+                region.imageSubresource.aspectMask = aspectFlags;
+                region.imageSubresource.mipLevel = 0;
+                region.imageSubresource.baseArrayLayer = 0;
+                region.imageSubresource.layerCount = 1;
+                region.imageOffset = { 0, 0, 0 };
+                region.imageExtent = { width, height, 1 };
+
+                vkCmdCopyImageToBuffer(commandBuffer, image, layout, dstBuffer, 1, &region);
+            },
+            callback
+        );
+    }
+
+    //-----------------------------------------------------------------------
+
+    std::future<std::vector<uint8_t>> Application::recordReadback(
+        VkCommandBuffer commandBuffer, VkDeviceSize size,
+        const std::function<void(VkBuffer)>& recordCopy,
+        const readbackCallback_t& callback
+    )
+    {
+        readbackBuffer_t readback = acquireReadbackBuffer(size);
+
+        // Make the previous writes visible to the copy
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            1, &barrier,
+            0, nullptr,
+            0, nullptr
+        );
+
+        recordCopy(readback.buffer);
+
+        // Make the copy visible to the CPU
+        VkBufferMemoryBarrier bufferBarrier{};
+        bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.buffer = readback.buffer;
+        bufferBarrier.offset = 0;
+        bufferBarrier.size = size;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+            0, nullptr,
+            1, &bufferBarrier,
+            0, nullptr
+        );
+
+        // The data is delivered by the readback thread, once the frame is retired
+        auto promise = std::make_shared<std::promise<std::vector<uint8_t>>>();
+        std::future<std::vector<uint8_t>> future = promise->get_future();
+
+        auto task = [this, readback, size, callback, promise]() {
+            VkMappedMemoryRange range{};
+            range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range.memory = readback.memory;
+            range.offset = 0;
+            range.size = VK_WHOLE_SIZE;
+
+            vkInvalidateMappedMemoryRanges(device, 1, &range);
+
+            try
+            {
+                std::vector<uint8_t> data;
+
+                if (callback)
+                {
+                    callback(readback.data, size);
+                }
+                else
+                {
+                    const uint8_t* bytes = static_cast<const uint8_t*>(readback.data);
+                    data.assign(bytes, bytes + size);
+                }
+
+                promise->set_value(std::move(data));
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+
+            releaseReadbackBuffer(readback);
+        };
+
+        startReadbackThread();
+
+        {
+            std::lock_guard<std::mutex> lock(readbackMutex);
+            pendingReadbacks.emplace_back(recordingFrameNumber, std::move(task));
+        }
+
+        return future;
+    }
+
+    //-----------------------------------------------------------------------
+
+    readbackBuffer_t Application::acquireReadbackBuffer(VkDeviceSize size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(readbackMutex);
+
+            // Use the smallest buffer large enough
+            auto best = freeReadbackBuffers.end();
+            for (auto iter = freeReadbackBuffers.begin(); iter != freeReadbackBuffers.end(); ++iter)
+            {
+                if ((iter->size >= size) &&
+                    ((best == freeReadbackBuffers.end()) || (iter->size < best->size)))
+                {
+                    best = iter;
+                }
+            }
+
+            if (best != freeReadbackBuffers.end())
+            {
+                readbackBuffer_t readback = *best;
+                freeReadbackBuffers.erase(best);
+                return readback;
+            }
+        }
+
+        readbackBuffer_t readback;
+        createReadbackBuffer(size, readback.buffer, readback.memory, readback.data);
+        readback.size = size;
+
+        return readback;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::releaseReadbackBuffer(const readbackBuffer_t& readback)
+    {
+        std::lock_guard<std::mutex> lock(readbackMutex);
+        freeReadbackBuffers.push_back(readback);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::retireReadbacks(uint64_t frameNumber)
+    {
+        if (!readbackThread.joinable())
+            return;
+
+        bool retired = false;
+
+        {
+            std::lock_guard<std::mutex> lock(readbackMutex);
+
+            auto iter = pendingReadbacks.begin();
+            while (iter != pendingReadbacks.end())
+            {
+                if (iter->first <= frameNumber)
+                {
+                    readbackTasks.push_back(std::move(iter->second));
+                    iter = pendingReadbacks.erase(iter);
+                    retired = true;
+                }
+                else
+                {
+                    ++iter;
+                }
+            }
+        }
+
+        if (retired)
+            readbackCondition.notify_one();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::readbackLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(readbackMutex);
+
+                readbackCondition.wait(lock, [this]() {
+                    return stopReadbacks || !readbackTasks.empty();
+                });
+
+                // Only stop once all the retired readbacks are done
+                if (readbackTasks.empty())
+                    break;
+
+                task = std::move(readbackTasks.front());
+                readbackTasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::startReadbackThread()
+    {
+        if (readbackThread.joinable())
+            return;
+
+        stopReadbacks = false;
+        readbackThread = std::thread(&Application::readbackLoop, this);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::stopReadbackThread()
+    {
+        if (!readbackThread.joinable())
+            return;
+
+        {
+            // All the frames are retired at this point
+            std::lock_guard<std::mutex> lock(readbackMutex);
+
+            for (auto& readback : pendingReadbacks)
+                readbackTasks.push_back(std::move(readback.second));
+
+            pendingReadbacks.clear();
+            stopReadbacks = true;
+        }
+
+        readbackCondition.notify_all();
+        readbackThread.join();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::destroyReadbackBuffers()
+    {
+        if (captureVideoFile.is_open())
+            captureVideoFile.close();
+
+        for (auto& slot : captureSlots)
+        {
+            if (slot.buffer != VK_NULL_HANDLE)
+            {
+                vkDestroyBuffer(device, slot.buffer, nullptr);
+                vkFreeMemory(device, slot.memory, nullptr);
+            }
+        }
+
+        captureSlots.clear();
+
+        for (auto& readback : freeReadbackBuffers)
+        {
+            vkDestroyBuffer(device, readback.buffer, nullptr);
+            vkFreeMemory(device, readback.memory, nullptr);
+        }
+
+        freeReadbackBuffers.clear();
+
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        statistics.nbCapturedFrames = nbCapturedFrames.load();
+        statistics.nbDroppedCaptures = nbDroppedCaptures.load();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::cleanup()
+    {
+        stopPresentThread();
+        stopReadbackThread();
+        destroyReadbackBuffers();
+        destroyRenderTargets();
+
+        cleanupSwapChain();
+        destroyWindowTargets();
+
+        destroyRetiredSwapChains(true);
+        vkDestroySwapchainKHR(device, swapChain, nullptr);
+        swapChain = VK_NULL_HANDLE;
+
+        destroyVulkanObjects();
+
+        for (auto& frame : frames)
+        {
+            vkDestroySemaphore(device, frame.imageAvailableSemaphore, nullptr);
+            vkDestroySemaphore(device, frame.renderFinishedSemaphore, nullptr);
+            vkDestroyFence(device, frame.inFlightFence, nullptr);
+            vkDestroyCommandPool(device, frame.commandPool, nullptr);
+        }
+
+        frames.clear();
+
+        if (frameTimelineSemaphore != VK_NULL_HANDLE)
+        {
+            vkDestroySemaphore(device, frameTimelineSemaphore, nullptr);
+            frameTimelineSemaphore = VK_NULL_HANDLE;
+        }
+
+        if (timestampQueryPool != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(device, timestampQueryPool, nullptr);
+            timestampQueryPool = VK_NULL_HANDLE;
+        }
+
+        if (surface != VK_NULL_HANDLE)
+        {
+            clearSurfaceSupport(surface);
+            vkDestroySurfaceKHR(instance, surface, nullptr);
+            surface = VK_NULL_HANDLE;
+        }
+
+        // The device and the instance are destroyed with the last application using them
+        deviceContext.reset();
+        device = VK_NULL_HANDLE;
+        instance = VK_NULL_HANDLE;
+        debugMessenger = VK_NULL_HANDLE;
+
+        if (!config.headless)
+        {
+            glfwDestroyWindow(window);
+
+            if (--nbGLFWUsers == 0)
+                glfwTerminate();
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::isFrameRetired(uint64_t frameNumber) const
+    {
+        if (frameNumber > lastSubmittedFrame.load())
+            return false;
+
+#ifdef VK_API_VERSION_1_2
+        if (frameTimelineSemaphore != VK_NULL_HANDLE)
+        {
+            uint64_t value = 0;
+            vkGetSemaphoreCounterValue(device, frameTimelineSemaphore, &value);
+            return value >= frameNumber;
+        }
+#endif
+
+        // If the frame context used by the frame was reused since, the frame was
+        // already waited for
+        for (const auto& frame : frames)
+        {
+            if (frame.frameNumber == frameNumber)
+                return vkGetFenceStatus(device, frame.inFlightFence) == VK_SUCCESS;
+        }
+
+        return true;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::waitForFrame(uint64_t frameNumber)
+    {
+        if ((frameNumber == 0) || (frameNumber > lastSubmittedFrame.load()))
+            return;
+
+#ifdef VK_API_VERSION_1_2
+        if (frameTimelineSemaphore != VK_NULL_HANDLE)
+        {
+            VkSemaphoreWaitInfo waitInfo{};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &frameTimelineSemaphore;
+            waitInfo.pValues = &frameNumber;
+
+            vkWaitSemaphores(device, &waitInfo, UINT64_MAX);
+        }
+        else
+#endif
+        {
+            // Wait for the fences of all the frames up to the requested one
+            std::vector<VkFence> fences;
+            for (const auto& frame : frames)
+            {
+                if ((frame.frameNumber > 0) && (frame.frameNumber <= frameNumber))
+                    fences.push_back(frame.inFlightFence);
+            }
+
+            if (!fences.empty())
+                vkWaitForFences(device, fences.size(), fences.data(), VK_TRUE, UINT64_MAX);
+        }
+
+        // The readbacks done by the frame can be delivered
+        retireReadbacks(frameNumber);
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkShaderModule Application::createShaderModule(const std::vector<char>& code) const
+    {
+        // Fill in a struct with some information about the shader
+        VkShaderModuleCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.codeSize = code.size();
+        createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+        VkShaderModule shaderModule;
+        if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create shader module!");
+
+        return shaderModule;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::createBuffer(
+        VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+        VkBuffer& buffer, VkDeviceMemory& bufferMemory
+    ) const
+    {
+        // Create the buffer
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create buffer!");
+
+        // Allocate some memory for it
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
+
+        if (vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate buffer memory!");
+
+        vkBindBufferMemory(device, buffer, bufferMemory, 0);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::createReadbackBuffer(
+        VkDeviceSize size, VkBuffer& buffer, VkDeviceMemory& bufferMemory, void*& data
+    ) const
+    {
+        // Create the buffer
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create buffer!");
+
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+
+        // Prefer host-cached memory (much faster to read by the CPU), fall back to
+        // host-coherent memory
+        const VkPhysicalDeviceMemoryProperties& memProperties = deviceCapabilities->memoryProperties;
+
+        const VkMemoryPropertyFlags candidates[] = {
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        };
+
+        uint32_t memoryType = UINT32_MAX;
+        for (auto properties : candidates)
+        {
+            for (uint32_t i = 0; (i < memProperties.memoryTypeCount) && (memoryType == UINT32_MAX); ++i)
+            {
+                if ((memRequirements.memoryTypeBits & (1 << i)) &&
+                    ((memProperties.memoryTypes[i].propertyFlags & properties) == properties))
+                {
+                    memoryType = i;
+                }
+            }
+        }
+
+        if (memoryType == UINT32_MAX)
+            throw std::runtime_error("Failed to find suitable memory type!");
+
+        // Allocate and map the memory
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = memoryType;
+
+        if (vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate buffer memory!");
+
+        vkBindBufferMemory(device, buffer, bufferMemory, 0);
+
+        if (vkMapMemory(device, bufferMemory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS)
+            throw std::runtime_error("Failed to map buffer memory!");
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::createImage(
+        uint32_t width, uint32_t height, uint32_t mipLevels,
+        VkSampleCountFlagBits nbSamples, VkFormat format, VkImageTiling tiling,
+        VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
+        VkImage& image, VkDeviceMemory& imageMemory, uint32_t nbLayers
+    ) const
+    {
+        // Create the image
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.extent.width = width;
+        imageInfo.extent.height = height;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = mipLevels;
+        imageInfo.arrayLayers = nbLayers;
+        imageInfo.format = format;
+        imageInfo.tiling = tiling;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage = usage;
+        imageInfo.samples = nbSamples;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create an image!");
+
+        // Allocate memory on the GPU for the image
+        VkMemoryRequirements memRequirements;
+        vkGetImageMemoryRequirements(device, image, &memRequirements);
+
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
+
+        if (vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate image memory!");
+
+        vkBindImageMemory(device, image, imageMemory, 0);
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkImageView Application::createImageView(
+        VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels,
+        uint32_t nbLayers
+    ) const
+    {
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = image;
+        viewInfo.viewType = (nbLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D);
+        viewInfo.format = format;
+        viewInfo.subresourceRange.aspectMask = aspectFlags;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = mipLevels;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = nbLayers;
+
+        VkImageView imageView;
+        if (vkCreateImageView(device, &viewInfo, nullptr, &imageView) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create image view!");
+
+        return imageView;
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkRenderPassMultiviewCreateInfo Application::getMultiviewCreateInfo() const
+    {
+        if (config.nbViews <= 1)
+            throw std::runtime_error("Multiview rendering not enabled!");
+
+        VkRenderPassMultiviewCreateInfo multiviewInfo{};
+        multiviewInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+        multiviewInfo.subpassCount = 1;
+        multiviewInfo.pViewMasks = &multiviewViewMask;
+        multiviewInfo.correlationMaskCount = 1;
+        multiviewInfo.pCorrelationMasks = &multiviewCorrelationMask;
+
+        return multiviewInfo;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::copyBuffer(
+        VkCommandPool commandPool, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size
+    ) const
+    {
+        // Create the command buffer
+        VkCommandBuffer commandBuffer = beginSingleTimeCommands(commandPool);
+
+        // Copy command
+        recordCopyBufferCommand(commandBuffer, srcBuffer, dstBuffer, size);
+
+        // Execute and release the command buffer
+        endSingleTimeCommands(commandPool, commandBuffer);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::copyBufferToImage(
+        VkCommandPool commandPool, VkBuffer buffer, VkImage image,
+        uint32_t width, uint32_t height
+    ) const
+    {
+        // Create the command buffer
+        VkCommandBuffer commandBuffer = beginSingleTimeCommands(commandPool);
+
+        // Image copy command
+        recordCopyBufferToImageCommand(commandBuffer, buffer, image, width,  height);
+
+        // Execute and release the command buffer
+        endSingleTimeCommands(commandPool, commandBuffer);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::transitionImageLayout(
+        VkCommandPool commandPool, VkImage image, VkFormat format,
+        VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels,
+        uint32_t nbLayers
+    ) const
+    {
+        // Create the command buffer
+        VkCommandBuffer commandBuffer = beginSingleTimeCommands(commandPool);
+
+        // Create a barrier to perform layout transition
+        recordTransitionImageLayoutCommand(
+            commandBuffer, image, format, oldLayout, newLayout, mipLevels, nbLayers
+        );
+
+        // Execute and release the command buffer
+        endSingleTimeCommands(commandPool, commandBuffer);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::generateMipmaps(
+        VkCommandPool commandPool, VkImage image, VkFormat imageFormat,
+        int32_t texWidth, int32_t texHeight, uint32_t mipLevels
+    ) const
+    {
+        // Create the command buffer
+        VkCommandBuffer commandBuffer = beginSingleTimeCommands(commandPool);
+
+        // Create a barrier to perform layout transition of each mipmap level
+        recordGenerateMipmapsCommand(
+            commandBuffer, image, imageFormat, texWidth, texHeight,  mipLevels
+        );
+
+        // Execute and release the command buffer
+        endSingleTimeCommands(commandPool, commandBuffer);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::recordCopyBufferCommand(
+        VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size
+    ) const
+    {
+        // Copy command
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = 0; // Optional
+        copyRegion.dstOffset = 0; // Optional
+        copyRegion.size = size;
+        vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::recordCopyBufferToImageCommand(
+        VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image,
+        uint32_t width, uint32_t height
+    ) const
+    {
+        // Image copy command
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {
+            width,
+            height,
+            1
+        };
+
+        vkCmdCopyBufferToImage(
+            commandBuffer,
+            buffer,
+            image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1,
+            &region
+        );
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::recordTransitionImageLayoutCommand(
+        VkCommandBuffer commandBuffer, VkImage image, VkFormat format,
+        VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels,
+        uint32_t nbLayers
+    ) const
+    {
+        // Create a barrier to perform layout transition
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = mipLevels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = nbLayers;
+
+        VkPipelineStageFlags sourceStage;
+        VkPipelineStageFlags destinationStage;
+
+        if ((oldLayout == VK_IMAGE_LAYOUT_UNDEFINED) &&
+            (newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL))
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+            sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        }
+        else if ((oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) &&
+                 (newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL))
+        {
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+            sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        }
+        else
+        {
+            throw std::invalid_argument("Unsupported layout transition!");
+        }
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            sourceStage, destinationStage,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier
+        );
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::recordGenerateMipmapsCommand(
+        VkCommandBuffer commandBuffer, VkImage image, VkFormat imageFormat,
+        int32_t texWidth, int32_t texHeight, uint32_t mipLevels
+    ) const
+    {
+        // Check if image format supports linear blitting
+        VkFormatProperties formatProperties = getFormatProperties(imageFormat);
+
+        if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+            throw std::runtime_error("Texture image format does not support linear blitting!");
+
+        // Create a barrier to perform layout transition of each mipmap level
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.image = image;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        barrier.subresourceRange.levelCount = 1;
+
+        // Iterate over all mipmap level
+        int32_t mipWidth = texWidth;
+        int32_t mipHeight = texHeight;
+
+        for (uint32_t i = 1; i < mipLevels; ++i)
+        {
+            // Transition the layout of level i-1 to VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+            barrier.subresourceRange.baseMipLevel = i - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier
+            );
+
+            // Copy and resize the image of level i-1 to level i
+            VkImageBlit blit{};
+            blit.srcOffsets[0] = { 0, 0, 0 };
+            blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = i - 1;
+            blit.srcSubresource.baseArrayLayer = 0;
+            blit.srcSubresource.layerCount = 1;
+            blit.dstOffsets[0] = { 0, 0, 0 };
+            blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
+            blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.dstSubresource.mipLevel = i;
+            blit.dstSubresource.baseArrayLayer = 0;
+            blit.dstSubresource.layerCount = 1;
+
+            vkCmdBlitImage(
+                commandBuffer,
+                image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1, &blit,
+                VK_FILTER_LINEAR
+            );
+
+            // Transition the layout of level i-1 to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier
+            );
+
+            if (mipWidth > 1) mipWidth /= 2;
+            if (mipHeight > 1) mipHeight /= 2;
+        }
+
+        // Transition the layout of the last level to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier
+        );
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkCommandBuffer Application::beginSingleTimeCommands(VkCommandPool commandPool) const
+    {
+        // Allocate a command buffer
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
+
+        // Start recording commands
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+        return commandBuffer;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::endSingleTimeCommands(
+        VkCommandPool commandPool, VkCommandBuffer commandBuffer
+    ) const
+    {
+        // End recording commands
+        vkEndCommandBuffer(commandBuffer);
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+
+        // Execute the command buffer
+        {
+            std::lock_guard<std::mutex> lock(deviceContext->queueMutex);
+
+            vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+            vkQueueWaitIdle(graphicsQueue);
+        }
+
+        // Cleanup
+        vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+    }
+
+    //-----------------------------------------------------------------------
+
+    uint32_t Application::findMemoryType(
+        uint32_t typeFilter, VkMemoryPropertyFlags properties
+    ) const
+    {
+        // Info about the available types of memory
+        const VkPhysicalDeviceMemoryProperties& memProperties = deviceCapabilities->memoryProperties;
+
+        // Find a memory type that is suitable for the buffer
+        for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i)
+        {
+            if ((typeFilter & (1 << i)) &&
+                ((memProperties.memoryTypes[i].propertyFlags & properties) == properties))
+            {
+                return i;
+            }
+        }
+
+        throw std::runtime_error("Failed to find suitable memory type!");
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkFormat Application::findSupportedFormat(
+        const std::vector<VkFormat>& candidates, VkImageTiling tiling,
+        VkFormatFeatureFlags features
+    ) const
+    {
+        for (VkFormat format : candidates)
+        {
+            VkFormatProperties props = getFormatProperties(format);
+
+            if ((tiling == VK_IMAGE_TILING_LINEAR) &&
+                ((props.linearTilingFeatures & features) == features))
+            {
+                return format;
+            }
+            else if ((tiling == VK_IMAGE_TILING_OPTIMAL) &&
+                     ((props.optimalTilingFeatures & features) == features))
+            {
+                return format;
+            }
+        }
+
+        throw std::runtime_error("Failed to find supported format!");
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkFormatProperties Application::getFormatProperties(VkFormat format) const
+    {
+        if ((uint32_t) format < deviceCapabilities->formats.size())
+            return deviceCapabilities->formats[format];
+
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+        return properties;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::createInstance()
+    {
+        // If necessary, check that all the needed validation layers are available
+        if (enableValidationLayers && !checkValidationLayerSupport()) {
+            throw std::runtime_error("Validation layers requested, but not available!");
+        }
+
+        // Fill in a struct with some information about our application
+        VkApplicationInfo appInfo{};
+        appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        appInfo.pApplicationName = config.applicationName.data();
+        appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
+        appInfo.pEngineName = "No Engine";
+        appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
+        appInfo.apiVersion = config.vulkanVersion;
+
+        // Fill in a struct with sufficient information for creating an instance
+        VkInstanceCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        createInfo.pApplicationInfo = &appInfo;
+
+        //-- Enable the needed extensions
+        auto requiredExtensions = getRequiredExtensions();
+        createInfo.enabledExtensionCount = (uint32_t) requiredExtensions.size();
+        createInfo.ppEnabledExtensionNames = requiredExtensions.data();
+
+#ifdef __APPLE__
+        //-- MacOS-related flags
+        createInfo.flags |= VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR;
+#endif
+
+        //-- Validation layers
+        VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
+        if (enableValidationLayers) {
+            createInfo.enabledLayerCount = static_cast<uint32_t>(config.validationLayers.size());
+            createInfo.ppEnabledLayerNames = config.validationLayers.data();
+
+            // Needed to have a debug messenger during instance creation/destruction
+            populateDebugMessengerCreateInfo(debugCreateInfo);
+            createInfo.pNext = (VkDebugUtilsMessengerCreateInfoEXT*) &debugCreateInfo;
+        } else {
+            createInfo.enabledLayerCount = 0;
+            createInfo.pNext = nullptr;
+        }
+
+        // Creation of the instance
+        if (vkCreateInstance(&createInfo, nullptr, &instance) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create instance!");
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::createSurface()
+    {
+        if (config.headless)
+            return;
+
+        if (glfwCreateWindowSurface(instance, window, nullptr, &surface) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create window surface!");
+    }
+
+    //-----------------------------------------------------------------------
+
+    std::vector<const char*> Application::getRequiredExtensions() const
+    {
+        std::vector<const char*> extensions;
+
+        // Retrieve GLFW-related extensions (no window in headless mode)
+        if (!config.headless)
+        {
+            uint32_t glfwExtensionCount = 0;
+            const char** glfwExtensions;
+
+            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+
+            for(uint32_t i = 0; i < glfwExtensionCount; ++i)
+                extensions.emplace_back(glfwExtensions[i]);
+        }
+
+#ifdef __APPLE__
+        // MacOS-related extensions
+        extensions.emplace_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
+#endif
+
+        // Validation layers-related extensions
+        if (enableValidationLayers) {
+            extensions.emplace_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        }
+
+        // Retrieve the list of supported extensions
+        uint32_t extensionCount;
+        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+
+        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
+        
+        // Check for the availability of the "VK_KHR_get_physical_device_properties2"
+        // extension (needed by the "VK_KHR_portability_subset" device extension, see
+        // checkDeviceExtensionSupport())
+        for (const auto& extension : availableExtensions)
+        {
+            if (strcmp(extension.extensionName, "VK_KHR_get_physical_device_properties2") == 0)
+            {
+                extensions.emplace_back("VK_KHR_get_physical_device_properties2");
+                break;
+            }
+        }
+
+        // In headless mode, the "VK_KHR_surface" extension (on which "VK_KHR_swapchain"
+        // depends) is only enabled if available
+        if (config.headless)
+        {
+            for (const auto& extension : availableExtensions)
+            {
+                if (strcmp(extension.extensionName, VK_KHR_SURFACE_EXTENSION_NAME) == 0)
+                {
+                    extensions.emplace_back(VK_KHR_SURFACE_EXTENSION_NAME);
+                    break;
+                }
+            }
+        }
+
+        return extensions;
+    }
+
+
+    /******************************** PHYSICAL DEVICES **********************************/
+
+    void Application::pickPhysicalDevice()
+    {
+        // Retrieve the number of physical devices
+        uint32_t deviceCount = 0;
+        vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+
+        if (deviceCount == 0)
+            throw std::runtime_error("Failed to find GPUs with Vulkan support!");
+
+        // Retrieve a list of all physical devices
+        std::vector<VkPhysicalDevice> devices(deviceCount);
+        vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+
+        // A device can be forced by the environment (for benchmarking) or by the
+        // configuration
+        std::string selector = config.physicalDevice;
+
+        const char* forcedDevice = getenv("KNM_VK_DEVICE");
+        if ((forcedDevice != nullptr) && (forcedDevice[0] != 0))
+            selector = forcedDevice;
+
+        if (!selector.empty())
+        {
+            for (uint32_t i = 0; i < deviceCount; ++i)
+            {
+                if (matchDeviceSelector(*getDeviceCapabilities(devices[i]), i, selector))
+                {
+                    if (!isDeviceSuitable(devices[i]))
+                        throw std::runtime_error("The requested GPU isn't suitable!");
+
+                    physicalDevice = devices[i];
+                    break;
+                }
+            }
+
+            if (physicalDevice == VK_NULL_HANDLE)
+                throw std::runtime_error("Failed to find the requested GPU!");
+        }
+        else
+        {
+            // Find the suitable device with the highest score
+            uint64_t bestScore = 0;
+            for (const auto& device : devices)
+            {
+                if (!isDeviceSuitable(device))
+                    continue;
+
+                uint64_t score = rateDevice(device);
+                if ((physicalDevice == VK_NULL_HANDLE) || (score > bestScore))
+                {
+                    physicalDevice = device;
+                    bestScore = score;
+                }
+            }
+
+            if (physicalDevice == VK_NULL_HANDLE)
+                throw std::runtime_error("Failed to find a suitable GPU!");
+        }
+
+        deviceCapabilities = getDeviceCapabilities(physicalDevice);
+        msaaNbMaxSamples = getMaxUsableSampleCount();
+
+        // Check if the completion of the frames can be tracked with a timeline semaphore
+        timelineSemaphoreSupported = config.useTimelineSemaphore &&
+                                     checkTimelineSemaphoreSupport(physicalDevice);
+
+        // Check if the frames can be paced by waiting for their presentation
+        presentWaitSupported = config.usePresentWait &&
+                               checkPresentWaitSupport(physicalDevice);
+
+        // Check if the regions that changed can be passed to the presentation engine
+        incrementalPresentSupported = config.useDamageTracking &&
+                                      checkIncrementalPresentSupport(physicalDevice);
+
+        selectSurfaceImageFormat();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::selectSurfaceImageFormat()
+    {
+        // In headless mode, the format of the offscreen images is imposed
+        if (config.headless)
+        {
+            surfaceImageFormat = config.headlessImageFormat;
+            return;
+        }
+
+        // Retrieve and store the best surface format supported by the physical device for later use
+        swapChainSupportDetails_t swapChainSupport = querySwapChainSupport(physicalDevice);
+
+        VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(
+            swapChainSupport.formats
+        );
+
+        surfaceImageFormat = surfaceFormat.format;
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::isDeviceSuitable(VkPhysicalDevice device) const
+    {
+        // Retrieve the indices of the queue families we need from the physical
+        // device
+        queueFamilyIndices_t indices = findQueueFamilies(device);
+
+        // Check that the device extensions we need are supported
+        bool extensionsSupported = checkDeviceExtensionSupport(device);
+
+        // Check that the swap chain support is adequate on the device (we need
+        // at least one surface format and one presentation mode, except in headless
+        // mode)
+        bool swapChainAdequate = config.headless;
+        if (extensionsSupported && !config.headless)
+        {
+            swapChainSupportDetails_t swapChainSupport = querySwapChainSupport(device);
+            swapChainAdequate = !swapChainSupport.formats.empty() &&
+                                !swapChainSupport.presentationModes.empty();
+
+            // The images must be writable by compute shaders if needed
+            if (config.useComputePresentation &&
+                !(swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT))
+            {
+                swapChainAdequate = false;
+            }
+        }
+
+        // First check to dismiss inadequate devices
+        if (!indices.isComplete() || !extensionsSupported || !swapChainAdequate)
+            return false;
+
+        // Check that enough views can be rendered by the multiview render passes
+        if ((config.nbViews > 1) && !checkMultiviewSupport(device))
+            return false;
+
+        // Check that the required (api-specific) features are supported
+        auto capabilities = getDeviceCapabilities(device);
+
+        if (!compareFeatures(
+                (void*) &config.features10, (void*) &capabilities->features10,
+                sizeof(VkPhysicalDeviceFeatures), 0, true
+        ))
+        {
+            return false;
+        }
+
+        if (config.vulkanVersion == VK_API_VERSION_1_0)
+            return true;
+
+#ifdef VK_API_VERSION_1_1
+        // Check if all the required 1.1 features are there
+        if (!compareFeatures(
+                (void*) &config.features11,
+                (void*) &capabilities->features11,
+                sizeof(VkPhysicalDeviceVulkan11Features),
+                offsetof(VkPhysicalDeviceVulkan11Features, storageBuffer16BitAccess),
+                capabilities->properties.apiVersion >= VK_API_VERSION_1_1
+        ))
+        {
+            return false;
+        }
+#endif
+
+#ifdef VK_API_VERSION_1_2
+        // Check if all the required 1.2 features are there
+        if (!compareFeatures(
+                (void*) &config.features12,
+                (void*) &capabilities->features12,
+                sizeof(VkPhysicalDeviceVulkan12Features),
+                offsetof(VkPhysicalDeviceVulkan12Features, samplerMirrorClampToEdge),
+                capabilities->properties.apiVersion >= VK_API_VERSION_1_2
+        ))
+        {
+            return false;
+        }
+#endif
+
+#ifdef VK_API_VERSION_1_3
+        // Check if all the required 1.3 features are there
+        if (!compareFeatures(
+                (void*) &config.features13,
+                (void*) &capabilities->features13,
+                sizeof(VkPhysicalDeviceVulkan13Features),
+                offsetof(VkPhysicalDeviceVulkan13Features, robustImageAccess),
+                capabilities->properties.apiVersion >= VK_API_VERSION_1_3
+        ))
+        {
+            return false;
+        }
+#endif
+
+        return true;
+    }
+
+    //-----------------------------------------------------------------------
+
+    uint64_t Application::rateDevice(VkPhysicalDevice device) const
+    {
+        auto capabilities = getDeviceCapabilities(device);
+
+        // Type of the device (most significant)
+        uint64_t typeRank = 0;
+        switch (capabilities->properties.deviceType)
+        {
+            case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: typeRank = 4; break;
+            case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: typeRank = 3; break;
+            case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: typeRank = 2; break;
+            case VK_PHYSICAL_DEVICE_TYPE_CPU: typeRank = 0; break;
+            default: typeRank = 1; break;
+        }
+
+        // Size of the largest device-local heap (in MB)
+        VkDeviceSize heapSize = 0;
+        const auto& memoryProperties = capabilities->memoryProperties;
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i)
+        {
+            if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                heapSize = std::max(heapSize, memoryProperties.memoryHeaps[i].size);
+        }
+
+        uint64_t heapRank = std::min<uint64_t>(heapSize >> 20, 0xFFFFFFFF);
+
+        // Queue topology: graphics and presentation in the same family (no sharing of
+        // the swap chain images), dedicated compute and transfer families
+        queueFamilyIndices_t indices = findQueueFamilies(device);
+
+        uint64_t queueRank = 0;
+        if (indices.families[GRAPHICS_QUEUE_FAMILY] == indices.families[PRESENTATION_QUEUE_FAMILY])
+            queueRank += 2;
+
+        bool computeFamilyFound = false;
+        bool transferFamilyFound = false;
+        for (const auto& queueFamily : capabilities->queueFamilies)
+        {
+            if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+                continue;
+
+            if (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT)
+                computeFamilyFound = true;
+            else if (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT)
+                transferFamilyFound = true;
+        }
+
+        queueRank += (computeFamilyFound ? 1 : 0) + (transferFamilyFound ? 1 : 0);
+
+        // Optional features requested by the configuration (least significant)
+        uint64_t featureRank = 0;
+
+        if (config.useTimelineSemaphore && checkTimelineSemaphoreSupport(device))
+            ++featureRank;
+
+        if (config.usePresentWait && checkPresentWaitSupport(device))
+            ++featureRank;
+
+        if (config.useDamageTracking && checkIncrementalPresentSupport(device))
+            ++featureRank;
+
+        return (typeRank << 56) | (heapRank << 16) | (queueRank << 8) | featureRank;
+    }
+
+    //-----------------------------------------------------------------------
+
+    queueFamilyIndices_t Application::findQueueFamilies(VkPhysicalDevice device) const
+    {
+        queueFamilyIndices_t indices;
+        indices.nbRequiredFamilies = 2;
+
+        // Retrieve the available queue families
+        auto capabilities = getDeviceCapabilities(device);
+
+        // Iterate through all the queue families
+        int i = 0;
+        for (const auto& queueFamily : capabilities->queueFamilies)
+        {
+            // Are graphics commands supported? (and compute ones, if the swap chain
+            // images are written by compute shaders)
+            if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) &&
+                (!config.useComputePresentation || (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT)))
+            {
+                indices.families[GRAPHICS_QUEUE_FAMILY] = i;
+            }
+
+            // Is presentation supported? (in headless mode, there is nothing to present:
+            // the graphics queue is used)
+            VkBool32 presentationSupport = false;
+            if (config.headless)
+                presentationSupport = (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+            else
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentationSupport);
+
+            if (presentationSupport)
+                indices.families[PRESENTATION_QUEUE_FAMILY] = i;
+
+            // Do we have everything we need?
+            if (indices.isComplete())
+                break;
+
+            ++i;
+        }
+
+        return indices;
+    }
+
+    //-----------------------------------------------------------------------
+
+    std::vector<const char*> Application::getRequiredDeviceExtensions(VkPhysicalDevice device) const
+    {
+        std::vector<const char*> extensions(config.deviceExtensions.begin(), config.deviceExtensions.end());
+
+        // Retrieve the list of supported device extensions
+        auto capabilities = getDeviceCapabilities(device);
+
+        // The Vulkan spec states: If the VK_KHR_portability_subset extension is
+        // supported, it must be included
+        if (capabilities->hasExtension("VK_KHR_portability_subset"))
+            extensions.emplace_back("VK_KHR_portability_subset");
+
+        // In headless mode, the "VK_KHR_swapchain" extension is only enabled if available
+        if (config.headless)
+        {
+            if (!capabilities->hasExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME))
+            {
+                extensions.erase(
+                    std::remove_if(extensions.begin(), extensions.end(), [](const char* name) {
+                        return strcmp(name, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0;
+                    }),
+                    extensions.end()
+                );
+            }
+        }
+
+#if defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+        // Needed to pace the frames by waiting for their presentation
+        if (config.usePresentWait && checkPresentWaitSupport(device))
+        {
+            extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        }
+#endif
+
+#ifdef VK_KHR_incremental_present
+        // Needed to pass the regions that changed to the presentation engine
+        if (config.useDamageTracking && checkIncrementalPresentSupport(device))
+            extensions.push_back(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+#endif
+
+        return extensions;
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::checkDeviceExtensionSupport(VkPhysicalDevice device) const
+    {
+        // Retrieve the list of supported device extensions
+        auto capabilities = getDeviceCapabilities(device);
+
+        // Check if all the ones we require are present
+        std::vector<const char*> requiredExtensions = getRequiredDeviceExtensions(device);
+        std::set<std::string> deviceExtensions(requiredExtensions.begin(), requiredExtensions.end());
+        for (const auto& extension : capabilities->extensions)
+            deviceExtensions.erase(extension.extensionName);
+
+        return deviceExtensions.empty();
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::checkTimelineSemaphoreSupport(VkPhysicalDevice device) const
+    {
+#ifdef VK_API_VERSION_1_2
+        if (config.vulkanVersion < VK_API_VERSION_1_2)
+            return false;
+
+        auto capabilities = getDeviceCapabilities(device);
+
+        if (capabilities->properties.apiVersion < VK_API_VERSION_1_2)
+            return false;
+
+        return capabilities->features12.timelineSemaphore == VK_TRUE;
+#else
+        return false;
+#endif
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::checkPresentWaitSupport(VkPhysicalDevice device) const
+    {
+#if defined(VK_KHR_present_id) && defined(VK_KHR_present_wait) && defined(VK_API_VERSION_1_1)
+        if ((config.vulkanVersion < VK_API_VERSION_1_1) || config.headless)
+            return false;
+
+        // Both extensions must be present and their features supported (the features
+        // are only retrieved when the extensions are there)
+        auto capabilities = getDeviceCapabilities(device);
+
+        return capabilities->presentIdSupported && capabilities->presentWaitSupported;
+#else
+        return false;
+#endif
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::checkIncrementalPresentSupport(VkPhysicalDevice device) const
+    {
+#ifdef VK_KHR_incremental_present
+        if (config.headless)
+            return false;
+
+        return getDeviceCapabilities(device)->hasExtension(
+            VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME
+        );
+#else
+        return false;
+#endif
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool Application::checkMultiviewSupport(VkPhysicalDevice device) const
+    {
+        return getDeviceCapabilities(device)->maxMultiviewViewCount >= config.nbViews;
+    }
+
+    //-----------------------------------------------------------------------
+
+    VkSampleCountFlagBits Application::getMaxUsableSampleCount() const
+    {
+        const VkPhysicalDeviceProperties& physicalDeviceProperties = deviceCapabilities->properties;
+
+        VkSampleCountFlags counts =
+            physicalDeviceProperties.limits.framebufferColorSampleCounts &
+            physicalDeviceProperties.limits.framebufferDepthSampleCounts;
+
+        for (int flag = VK_SAMPLE_COUNT_64_BIT; flag > VK_SAMPLE_COUNT_1_BIT; flag >>= 1)
+        {
+            if (counts & flag)
+                return static_cast<VkSampleCountFlagBits>(flag);
+        }
+
+        return VK_SAMPLE_COUNT_1_BIT;
+    }
+
+    //-----------------------------------------------------------------------
+
+    std::shared_ptr<const deviceCapabilities_t> Application::getDeviceCapabilities(
+        VkPhysicalDevice device
+    ) const
+    {
+        std::lock_guard<std::mutex> lock(capabilitiesMutex);
+
+        auto iter = capabilitiesCache.find(device);
+        if (iter != capabilitiesCache.end())
+            return iter->second;
+
+        auto capabilities = std::make_shared<deviceCapabilities_t>();
+
+        // The properties are always retrieved, they identify the device and its driver
+        vkGetPhysicalDeviceProperties(device, &capabilities->properties);
+
+        memcpy(
+            capabilities->deviceUUID, capabilities->properties.pipelineCacheUUID,
+            VK_UUID_SIZE
+        );
+
+#ifdef VK_API_VERSION_1_1
+        if ((config.vulkanVersion >= VK_API_VERSION_1_1) &&
+            (capabilities->properties.apiVersion >= VK_API_VERSION_1_1))
+        {
+            VkPhysicalDeviceIDProperties idProperties{};
+            idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+            VkPhysicalDeviceMultiviewProperties multiviewProperties{};
+            multiviewProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_PROPERTIES;
+            multiviewProperties.pNext = &idProperties;
+
+            VkPhysicalDeviceProperties2 properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties2.pNext = &multiviewProperties;
+
+            vkGetPhysicalDeviceProperties2(device, &properties2);
+
+            memcpy(capabilities->deviceUUID, idProperties.deviceUUID, VK_UUID_SIZE);
+            capabilities->maxMultiviewViewCount = multiviewProperties.maxMultiviewViewCount;
+        }
+#endif
+
+        // The rest is loaded from the file saved by a previous run if possible (one per
+        // device and driver version)
+        std::string path;
+        if (!config.capabilitiesCacheDir.empty())
+        {
+            char filename[64];
+            char* ptr = filename;
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Create image views to access the images of the swap chain
-        ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
-        //--------------------------------------------------------------------------------
-        virtual void createImageViews();
+            for (uint32_t i = 0; i < VK_UUID_SIZE; ++i)
+                ptr += snprintf(ptr, 3, "%02x", capabilities->deviceUUID[i]);
 
-        //------------------------------------------------------------------------------------
-        /// @brief  Creates the semaphores and fences that will be used to synchronise the
-        ///         rendering (one set for each frame-in-flight)
-        //------------------------------------------------------------------------------------
-        virtual void createSyncObjects();
+            snprintf(ptr, sizeof(filename) - (ptr - filename), "-%08x.bin", capabilities->properties.driverVersion);
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Retrieve the details about the swap chain support by a physical device
-        ///
-        /// @param  device  The physical device
-        ///
-        /// @returns        The details about the swap chain support
-        //--------------------------------------------------------------------------------
-        swapChainSupportDetails_t querySwapChainSupport(VkPhysicalDevice device) const;
+            path = config.capabilitiesCacheDir + "/" + filename;
+        }
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Select the best surface format from the provided list
-        ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
-        ///
-        /// @param  availableFormats    List of available formats
-        ///
-        /// @returns                    The best surface format
-        //--------------------------------------------------------------------------------
-        virtual VkSurfaceFormatKHR chooseSwapSurfaceFormat(
-            const std::vector<VkSurfaceFormatKHR>& availableFormats
-        ) const;
+        if (path.empty() || !loadDeviceCapabilities(path, *capabilities))
+        {
+            queryDeviceCapabilities(device, *capabilities);
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Select the best presentation mode from the provided list
-        ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
-        ///
-        /// @param  availablePresentModes    List of available modes
-        ///
-        /// @returns                        The best presentation mode
-        //--------------------------------------------------------------------------------
-        virtual VkPresentModeKHR chooseSwapPresentationMode(
-            const std::vector<VkPresentModeKHR>& availablePresentModes
-        ) const;
-        
-        //--------------------------------------------------------------------------------
-        /// @brief  Select the swap extent (the resolution of the swap chain images)
-        ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
-        ///
-        /// @param  capabilities    The capabilities of the surface
-        ///
-        /// @returns                The selected swap extent
-        //--------------------------------------------------------------------------------
-        virtual VkExtent2D chooseSwapExtent(
-            const VkSurfaceCapabilitiesKHR& capabilities
-        ) const;
-    /// @}
+            if (!path.empty())
+                saveDeviceCapabilities(path, *capabilities);
+        }
 
+        capabilitiesCache[device] = capabilities;
+        return capabilities;
+    }
 
-        //_____ Validation layers __________
-    protected:
-    /// @name Validation layers
-    /// @{
-        //--------------------------------------------------------------------------------
-        /// @brief  Checks if all of the requested validation layers are available
-        //--------------------------------------------------------------------------------
-        bool checkValidationLayerSupport() const;
+    //-----------------------------------------------------------------------
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Populate the provided messenger creation info
-        ///
-        /// Can be overriden by the user if the default implementation doesn't fulfill its
-        /// needs.
-        ///
-        /// @param[out] createInfo  The structure to populate
-        //--------------------------------------------------------------------------------
-        virtual void populateDebugMessengerCreateInfo(
-            VkDebugUtilsMessengerCreateInfoEXT& createInfo
-        ) const;
+    void Application::queryDeviceCapabilities(
+        VkPhysicalDevice device, deviceCapabilities_t& capabilities
+    ) const
+    {
+        // Retrieve the supported device extensions
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
 
-        //--------------------------------------------------------------------------------
-        /// @brief  Tell Vulkan about the callback function to call from validation layers
-        //--------------------------------------------------------------------------------
-        void setupDebugMessenger();
-    /// @}
+        capabilities.extensions.resize(extensionCount);
+        vkEnumerateDeviceExtensionProperties(
+            device, nullptr, &extensionCount, capabilities.extensions.data()
+        );
 
+        // Retrieve the queue families
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
 
-        //_____ Attributes __________
-    protected:
-        // The configuration of the application
-        config_t config;
+        capabilities.queueFamilies.resize(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(
+            device, &queueFamilyCount, capabilities.queueFamilies.data()
+        );
 
-        // Window, instance and surface
-        GLFWwindow* window = nullptr;
-        VkInstance instance = VK_NULL_HANDLE;
-        VkSurfaceKHR surface = VK_NULL_HANDLE;
-        VkFormat surfaceImageFormat = VK_FORMAT_UNDEFINED;
-        bool framebufferResized = false;
+        // Retrieve the memory properties
+        vkGetPhysicalDeviceMemoryProperties(device, &capabilities.memoryProperties);
 
-        // Devices
-        VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
-        VkDevice device = VK_NULL_HANDLE;
-        VkSampleCountFlagBits msaaNbMaxSamples = VK_SAMPLE_COUNT_1_BIT;
+        // Retrieve the properties of the core formats (VK_FORMAT_UNDEFINED excepted)
+        capabilities.formats.resize(VK_FORMAT_ASTC_12x12_SRGB_BLOCK + 1);
+        for (uint32_t format = 1; format < capabilities.formats.size(); ++format)
+        {
+            vkGetPhysicalDeviceFormatProperties(
+                device, (VkFormat) format, &capabilities.formats[format]
+            );
+        }
 
-        // Queues
-        VkQueue graphicsQueue = VK_NULL_HANDLE;
-        VkQueue presentationQueue = VK_NULL_HANDLE;
+        // Retrieve the supported features
+        if (config.vulkanVersion == VK_API_VERSION_1_0)
+        {
+            vkGetPhysicalDeviceFeatures(device, &capabilities.features10);
+            return;
+        }
 
-        // Swap chain
-        VkSwapchainKHR swapChain = VK_NULL_HANDLE;
-        std::vector<VkImage> swapChainImages;
-        std::vector<VkImageView> swapChainImageViews;
-        VkExtent2D swapChainExtent;
+#ifdef VK_API_VERSION_1_1
+        VkPhysicalDeviceFeatures2 supportedFeatures{};
+        supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
 
-        // Rendering-related synchronisation objects
-        std::vector<VkSemaphore> imageAvailableSemaphores;
-        std::vector<VkSemaphore> renderFinishedSemaphores;
-        std::vector<VkFence> inFlightFences;
-        uint32_t currentFrame = 0;
-        std::vector<VkCommandBuffer> commandBufferList;
+        capabilities.features11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+        supportedFeatures.pNext = &capabilities.features11;
 
-        // Debug messenger (when validation layers are used)
-        VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
+#ifdef VK_API_VERSION_1_2
+        capabilities.features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        capabilities.features11.pNext = &capabilities.features12;
+#endif
 
+#ifdef VK_API_VERSION_1_3
+        capabilities.features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        capabilities.features12.pNext = &capabilities.features13;
+#endif
 
-        //_____ Constants __________
-    protected:
-        const int MAX_NB_FRAMES_IN_FLIGHT = 2;
+#if defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+        // The presentation features can only be retrieved if their extensions are there
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+        presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
 
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+        presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        presentIdFeatures.pNext = &presentWaitFeatures;
 
-        //_____ Friend functions __________
-        friend void onFramebufferWindowResized(GLFWwindow* window, int width, int height);
-    };
+        if (capabilities.hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+            capabilities.hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+        {
+            presentWaitFeatures.pNext = supportedFeatures.pNext;
+            supportedFeatures.pNext = &presentIdFeatures;
+        }
+#endif
 
+        vkGetPhysicalDeviceFeatures2(device, &supportedFeatures);
 
-#ifdef KNM_VULKAN_TOOLS_IMPLEMENTATION
+        capabilities.features10 = supportedFeatures.features;
 
-    /***************************** DEBUG CALLBACK FUNCTION ******************************/
+#if defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+        capabilities.presentIdSupported = (presentIdFeatures.presentId == VK_TRUE);
+        capabilities.presentWaitSupported = (presentWaitFeatures.presentWait == VK_TRUE);
+#endif
 
-    //------------------------------------------------------------------------------------
-    // The default callback function to call from validation layers
-    //------------------------------------------------------------------------------------
-    static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
-        VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
-        VkDebugUtilsMessageTypeFlagsEXT messageType,
-        const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
-        void* pUserData
-    )
-    {
-        std::cerr << "Validation layer: " << pCallbackData->pMessage << std::endl;
-        return VK_FALSE;
-    }
+        // The chain doesn't outlive this method
+        capabilities.features11.pNext = nullptr;
 
+#ifdef VK_API_VERSION_1_2
+        capabilities.features12.pNext = nullptr;
+#endif
+#endif
+    }
 
-    /********************************* HELPER FUNCTIONS **********************************/
+    //-----------------------------------------------------------------------
 
-    std::vector<char> readFile(const std::string& filename)
+    bool Application::loadDeviceCapabilities(
+        const std::string& path, deviceCapabilities_t& capabilities
+    ) const
     {
-        std::ifstream file(filename, std::ios::ate | std::ios::binary);
-
+        std::ifstream file(path, std::ios::binary);
         if (!file.is_open())
-            throw std::runtime_error("Failed to open file!");
+            return false;
 
-        size_t fileSize = (size_t) file.tellg();
-        std::vector<char> buffer(fileSize);
+        // The file must have the expected format, and describe the same device and
+        // driver
+        std::vector<uint32_t> signature;
+        if (!readArray(file, signature) ||
+            (signature != getCapabilitiesSignature(config.vulkanVersion, capabilities)))
+        {
+            return false;
+        }
 
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
+        deviceCapabilities_t loaded = capabilities;
 
-        file.close();
+        file.read(reinterpret_cast<char*>(&loaded.memoryProperties), sizeof(loaded.memoryProperties));
+        file.read(reinterpret_cast<char*>(&loaded.features10), sizeof(loaded.features10));
 
-        return buffer;
+#ifdef VK_API_VERSION_1_1
+        file.read(reinterpret_cast<char*>(&loaded.features11), sizeof(loaded.features11));
+        loaded.features11.pNext = nullptr;
+#endif
+
+#ifdef VK_API_VERSION_1_2
+        file.read(reinterpret_cast<char*>(&loaded.features12), sizeof(loaded.features12));
+        loaded.features12.pNext = nullptr;
+#endif
+
+#ifdef VK_API_VERSION_1_3
+        file.read(reinterpret_cast<char*>(&loaded.features13), sizeof(loaded.features13));
+        loaded.features13.pNext = nullptr;
+#endif
+
+        uint8_t presentSupport[2] = { 0, 0 };
+        file.read(reinterpret_cast<char*>(presentSupport), sizeof(presentSupport));
+        loaded.presentIdSupported = (presentSupport[0] != 0);
+        loaded.presentWaitSupported = (presentSupport[1] != 0);
+
+        if (!file || !readArray(file, loaded.extensions) ||
+            !readArray(file, loaded.queueFamilies) || !readArray(file, loaded.formats))
+        {
+            return false;
+        }
+
+        capabilities = std::move(loaded);
+        return true;
     }
 
     //-----------------------------------------------------------------------
 
-    void onFramebufferWindowResized(GLFWwindow* window, int width, int height)
+    void Application::saveDeviceCapabilities(
+        const std::string& path, const deviceCapabilities_t& capabilities
+    ) const
     {
-        auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
-        app->framebufferResized = true;
+        // Written in a temporary file first, so other applications never read a partial
+        // one (failures are ignored, the capabilities will be enumerated again next time)
+        const std::string tempPath = path + ".tmp";
+
+        {
+            std::ofstream file(tempPath, std::ios::binary);
+            if (!file.is_open())
+                return;
+
+            writeArray(file, getCapabilitiesSignature(config.vulkanVersion, capabilities));
+
+            file.write(reinterpret_cast<const char*>(&capabilities.memoryProperties), sizeof(capabilities.memoryProperties));
+            file.write(reinterpret_cast<const char*>(&capabilities.features10), sizeof(capabilities.features10));
+
+#ifdef VK_API_VERSION_1_1
+            file.write(reinterpret_cast<const char*>(&capabilities.features11), sizeof(capabilities.features11));
+#endif
+
+#ifdef VK_API_VERSION_1_2
+            file.write(reinterpret_cast<const char*>(&capabilities.features12), sizeof(capabilities.features12));
+#endif
+
+#ifdef VK_API_VERSION_1_3
+            file.write(reinterpret_cast<const char*>(&capabilities.features13), sizeof(capabilities.features13));
+#endif
+
+            const uint8_t presentSupport[2] = {
+                capabilities.presentIdSupported, capabilities.presentWaitSupported
+            };
+            file.write(reinterpret_cast<const char*>(presentSupport), sizeof(presentSupport));
+
+            writeArray(file, capabilities.extensions);
+            writeArray(file, capabilities.queueFamilies);
+            writeArray(file, capabilities.formats);
+
+            if (!file)
+            {
+                file.close();
+                std::remove(tempPath.c_str());
+                return;
+            }
+        }
+
+        std::remove(path.c_str());
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+            std::remove(tempPath.c_str());
     }
 
-    //-----------------------------------------------------------------------
 
-    bool compareFeatures(
-        void* required, void* supported, size_t size, size_t offset, bool apiVersionSupported
-    )
+    /********************************* LOGICAL DEVICES **********************************/
+
+    void Application::createLogicalDevice()
     {
-        VkBool32* required_bool = (VkBool32*) (static_cast<uint8_t*>(required) + offset);
-        VkBool32* supported_bool = (VkBool32*) (static_cast<uint8_t*>(supported) + offset);
-        size_t nb = (size - offset) / sizeof(VkBool32);
+        // Retrieve the indices of the queue families we need from the physical device
+        queueFamilyIndices_t indices = findQueueFamilies(physicalDevice);
 
-        for (size_t i = 0; i < nb; ++i)
+        // Retrieve the required device extensions
+        auto requiredExtensions = getRequiredDeviceExtensions(physicalDevice);
+
+        // Fill structs to request the creation of the queues we need
+        std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+        std::set<uint32_t> uniqueQueueFamilies = {
+            indices.families[GRAPHICS_QUEUE_FAMILY],
+            indices.families[PRESENTATION_QUEUE_FAMILY]
+        };
+
+        float queuePriority = 1.0f;
+        for (uint32_t queueFamily : uniqueQueueFamilies)
         {
-            if (required_bool[i] && (!supported_bool[i] || !apiVersionSupported))
-                return false;
+            VkDeviceQueueCreateInfo queueCreateInfo{};
+            queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueCreateInfo.queueFamilyIndex = queueFamily;
+            queueCreateInfo.queueCount = 1;
+            queueCreateInfo.pQueuePriorities = &queuePriority;
+            queueCreateInfos.push_back(queueCreateInfo);
         }
 
-        return true;
-    }
+        // Fill a struct to create the logical device, using the above structs
+        VkDeviceCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+
+        createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+        createInfo.pQueueCreateInfos = queueCreateInfos.data();
+
+#ifdef VK_API_VERSION_1_2
+        // Needed to track the completion of the frames with a timeline semaphore
+        if (timelineSemaphoreSupported)
+            config.features12.timelineSemaphore = VK_TRUE;
+#endif
+
+#ifdef VK_API_VERSION_1_1
+        VkPhysicalDeviceFeatures2 enabledFeatures{};
+        enabledFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        enabledFeatures.pNext = &config.features11;
+        memcpy(&enabledFeatures.features, &config.features10, sizeof(VkPhysicalDeviceFeatures));
 
+        createInfo.pNext = &enabledFeatures;
 
-    /*************************** CONSTRUCTION / DESTRUCTION *****************************/
+#if defined(VK_KHR_present_id) && defined(VK_KHR_present_wait)
+        // Needed to pace the frames by waiting for their presentation
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+        presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        presentWaitFeatures.presentWait = VK_TRUE;
+        presentWaitFeatures.pNext = &config.features11;
 
-    Application::Application()
-    {
-        config.debugCallback = debugCallback;
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+        presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        presentIdFeatures.presentId = VK_TRUE;
+        presentIdFeatures.pNext = &presentWaitFeatures;
 
-#ifdef VK_API_VERSION_1_3
-        config.features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
-        config.features12.pNext = &config.features13;
+        if (presentWaitSupported)
+            enabledFeatures.pNext = &presentIdFeatures;
 #endif
-
-#ifdef VK_API_VERSION_1_2
-        config.features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
-        config.features11.pNext = &config.features12;
+#else
+        createInfo.pEnabledFeatures = &config.features10;
 #endif
 
-#ifdef VK_API_VERSION_1_1
-        config.features11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
-#endif
+        createInfo.enabledExtensionCount = static_cast<uint32_t>(requiredExtensions.size());
+        createInfo.ppEnabledExtensionNames = requiredExtensions.data();
 
-        config.features10.samplerAnisotropy = VK_TRUE;
-    }
+        if (enableValidationLayers) {
+            // Not necessarya anymore on current implementations of Vulkan, only
+            // here for backward compatibility
+            createInfo.enabledLayerCount = static_cast<uint32_t>(config.validationLayers.size());
+            createInfo.ppEnabledLayerNames = config.validationLayers.data();
+        } else {
+            createInfo.enabledLayerCount = 0;
+        }
 
-    //-----------------------------------------------------------------------
+        // Create the logical device
+        if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create logical device!");
 
-    void Application::run()
-    {
-        initWindow();
-        initVulkan();
-        mainLoop();
-        cleanup();
-    }
+        // Creates the queue for graphics command
+        vkGetDeviceQueue(device, indices.families[GRAPHICS_QUEUE_FAMILY], 0, &graphicsQueue);
 
-    //-----------------------------------------------------------------------
+        // Creates the queue for presentation
+        vkGetDeviceQueue(device, indices.families[PRESENTATION_QUEUE_FAMILY], 0, &presentationQueue);
 
-    void Application::initWindow()
-    {
-        glfwInit();
+#ifdef VK_KHR_present_wait
+        // Retrieve the function used to wait for the presentation of the frames
+        if (presentWaitSupported)
+        {
+            waitForPresent = (PFN_vkWaitForPresentKHR) vkGetDeviceProcAddr(
+                device, "vkWaitForPresentKHR"
+            );
 
-        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-        glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+            presentWaitSupported = (waitForPresent != nullptr);
+        }
+#else
+        presentWaitSupported = false;
+#endif
+    }
 
-        window = glfwCreateWindow(
-            config.windowWidth, config.windowHeight, config.windowTitle.data(),
-            nullptr, nullptr
-        );
 
-        glfwSetWindowUserPointer(window, this);
-        glfwSetFramebufferSizeCallback(window, onFramebufferWindowResized);
+    void Application::createDeviceContext()
+    {
+        deviceContext = std::make_shared<DeviceContext>();
+
+        deviceContext->instance = instance;
+        deviceContext->debugMessenger = debugMessenger;
+        deviceContext->physicalDevice = physicalDevice;
+        deviceContext->device = device;
+        deviceContext->queueFamilies = findQueueFamilies(physicalDevice);
+        deviceContext->graphicsQueue = graphicsQueue;
+        deviceContext->presentationQueue = presentationQueue;
+        deviceContext->msaaNbMaxSamples = msaaNbMaxSamples;
+        deviceContext->timelineSemaphoreSupported = timelineSemaphoreSupported;
+        deviceContext->presentWaitSupported = presentWaitSupported;
+        deviceContext->incrementalPresentSupported = incrementalPresentSupported;
+        deviceContext->capabilities = deviceCapabilities;
+        deviceContext->properties = deviceCapabilities->properties;
+        deviceContext->memoryProperties = deviceCapabilities->memoryProperties;
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::initVulkan()
+    void Application::attachDeviceContext()
     {
-        createInstance();
-        setupDebugMessenger();
-        createSurface();
-
-        pickPhysicalDevice();
-        createLogicalDevice();
-        createSyncObjects();
+        instance = deviceContext->instance;
+        physicalDevice = deviceContext->physicalDevice;
+        device = deviceContext->device;
+        graphicsQueue = deviceContext->graphicsQueue;
+        presentationQueue = deviceContext->presentationQueue;
+        msaaNbMaxSamples = deviceContext->msaaNbMaxSamples;
+        deviceCapabilities = deviceContext->capabilities;
 
-        createVulkanObjects();
+        {
+            std::lock_guard<std::mutex> lock(capabilitiesMutex);
+            capabilitiesCache[physicalDevice] = deviceCapabilities;
+        }
 
-        createSwapChain();
-        createImageViews();
-        onSwapChainReady();
-    }
+        // The features can only be used if they were enabled on the device
+        timelineSemaphoreSupported = config.useTimelineSemaphore &&
+                                     deviceContext->timelineSemaphoreSupported;
 
-    //-----------------------------------------------------------------------
+        presentWaitSupported = config.usePresentWait && deviceContext->presentWaitSupported;
 
-    void Application::mainLoop()
-    {
-        auto startTime = std::chrono::high_resolution_clock::now();
-        auto previousTime = startTime;
+        incrementalPresentSupported = config.useDamageTracking &&
+                                      deviceContext->incrementalPresentSupported;
 
-        while (!glfwWindowShouldClose(window)) {
-            auto currentTime = std::chrono::high_resolution_clock::now();
-            float elapsed = std::chrono::duration<float, std::chrono::seconds::period>(
-                currentTime - previousTime
-            ).count();
+#ifdef VK_KHR_present_wait
+        if (presentWaitSupported)
+        {
+            waitForPresent = (PFN_vkWaitForPresentKHR) vkGetDeviceProcAddr(
+                device, "vkWaitForPresentKHR"
+            );
 
-            // Retrieve window-related events
-            glfwPollEvents();
+            presentWaitSupported = (waitForPresent != nullptr);
+        }
+#endif
 
-            // Ensure we have allocated enough space for the user-supplied
-            // command buffers
-            uint32_t nbCommandBuffers = getNbCommandBuffers();
-            if (nbCommandBuffers != commandBufferList.size())
-                commandBufferList.resize(nbCommandBuffers);
+        createSurface();
 
-            // Draw the frame (if necessary)
-            if (nbCommandBuffers > 0)
-                drawFrame(elapsed);
+        // The surface must be usable with the shared queues
+        if (!config.headless)
+        {
+            queueFamilyIndices_t indices = findQueueFamilies(physicalDevice);
 
-            previousTime = currentTime;
+            if (!indices.isComplete() ||
+                (indices.families != deviceContext->queueFamilies.families) ||
+                querySwapChainSupport(physicalDevice).formats.empty())
+            {
+                throw std::runtime_error("The window surface isn't supported by the shared device!");
+            }
         }
 
-        vkDeviceWaitIdle(device);
+        selectSurfaceImageFormat();
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::drawFrame(float elapsed)
+    void Application::waitForDeviceIdle()
     {
-        // Wait for the previous frame to finish
-        vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+        std::lock_guard<std::mutex> lock(deviceContext->queueMutex);
+        vkDeviceWaitIdle(device);
+    }
 
-        // Acquire an image from the swap chain
-        uint32_t imageIndex;
-        VkResult result = vkAcquireNextImageKHR(
-            device, swapChain, UINT64_MAX, imageAvailableSemaphores[currentFrame],
-            VK_NULL_HANDLE, &imageIndex
-        );
 
-        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+    /************************************ SWAP CHAIN ************************************/
+
+    void Application::createSwapChain()
+    {
+        if (config.useComputePresentation && config.useDynamicResolution)
+            throw std::runtime_error("Compute presentation not supported with the dynamic resolution!");
+
+        // In headless mode, some offscreen images stand in for the swap chain
+        if (config.headless)
         {
-            recreateSwapChain();
+            createOffscreenImages();
             return;
         }
-        else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
-        {
-            throw std::runtime_error("Failed to acquire swap chain image!");
-        }
 
-        vkResetFences(device, 1, &inFlightFences[currentFrame]);
-
-        // Ask the user code to do some rendering
-        getCommandBuffers(elapsed, imageIndex, commandBufferList);
+        // Choose the parameters of the swap chain (surface format, presentation mode,
+        // extent)
+        swapChainSupportDetails_t swapChainSupport = querySwapChainSupport(physicalDevice);
 
-        // Submit the command buffer
-        VkSemaphore waitSemaphores[] = {
-            imageAvailableSemaphores[currentFrame]
-        };
+        VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(
+            swapChainSupport.formats
+        );
 
-        VkSemaphore signalSemaphores[] = {
-            renderFinishedSemaphores[currentFrame]
-        };
+        VkPresentModeKHR presentationMode = chooseSwapPresentationMode(
+            swapChainSupport.presentationModes
+        );
 
-        VkPipelineStageFlags waitStages[] = {
-            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
-        };
+        VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = waitSemaphores;
-        submitInfo.pWaitDstStageMask = waitStages;
-        submitInfo.commandBufferCount = commandBufferList.size();
-        submitInfo.pCommandBuffers = commandBufferList.data();
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores = signalSemaphores;
+        // Determine the number of images in the swap chain
+        uint32_t imageCount = chooseSwapImageCount(
+            swapChainSupport.capabilities, presentationMode
+        );
 
-        if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS)
-            throw std::runtime_error("Failed to submit draw command buffer!");
+        // The benchmark of the presentation modes overrides the choices
+        if (benchmarkImageCount > 0)
+        {
+            presentationMode = benchmarkPresentationMode;
+            imageCount = benchmarkImageCount;
+        }
 
-        // Presentation
-        VkSwapchainKHR swapChains[] = {swapChain};
+        // Fill a struct with the creation infos of the swap chain
+        VkSwapchainCreateInfoKHR createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+        createInfo.surface = surface;
+        createInfo.minImageCount = imageCount;
+        createInfo.imageFormat = surfaceFormat.format;
+        createInfo.imageColorSpace = surfaceFormat.colorSpace;
+        createInfo.imageExtent = extent;
+        createInfo.imageArrayLayers = 1;
+        createInfo.imageUsage = getSwapChainImageUsage(
+            swapChainSupport.capabilities, surfaceFormat.format
+        );
 
-        VkPresentInfoKHR presentInfo{};
-        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = signalSemaphores;
-        presentInfo.swapchainCount = 1;
-        presentInfo.pSwapchains = swapChains;
-        presentInfo.pImageIndices = &imageIndex;
-        presentInfo.pResults = nullptr; // Optional
+        createInfo.preTransform = swapChainSupport.capabilities.currentTransform;
+        createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+        createInfo.presentMode = presentationMode;
+        createInfo.clipped = VK_TRUE;
+        createInfo.oldSwapchain = swapChain;   // Allows the presentation engine to reuse
+                                               // resources of the previous swap chain
 
-        result = vkQueuePresentKHR(presentationQueue, &presentInfo);
+        //-- How to handle swap chain images that will be used across multiple
+        //   queue families (if necessary)
+        queueFamilyIndices_t indices = deviceContext->queueFamilies;
+        uint32_t queueFamilyIndices[] = {
+            indices.families[GRAPHICS_QUEUE_FAMILY],
+            indices.families[PRESENTATION_QUEUE_FAMILY]
+        };
 
-        // Handle errors from the frame presentation on screen
-        if ((result == VK_ERROR_OUT_OF_DATE_KHR) || (result == VK_SUBOPTIMAL_KHR) ||
-            framebufferResized)
+        if (indices.families[GRAPHICS_QUEUE_FAMILY] != indices.families[PRESENTATION_QUEUE_FAMILY])
         {
-            framebufferResized = false;
-            recreateSwapChain();
+            createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+            createInfo.queueFamilyIndexCount = 2;
+            createInfo.pQueueFamilyIndices = queueFamilyIndices;
         }
-        else if (result != VK_SUCCESS)
+        else
         {
-            throw std::runtime_error("Failed to present swap chain image!");
+            createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            createInfo.queueFamilyIndexCount = 0; // Optional
+            createInfo.pQueueFamilyIndices = nullptr; // Optional
         }
 
-        currentFrame = (currentFrame + 1) % MAX_NB_FRAMES_IN_FLIGHT;
+        // Create the swap chain
+        VkSwapchainKHR newSwapChain = VK_NULL_HANDLE;
+        if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &newSwapChain) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create swap chain!");
+
+        swapChain = newSwapChain;
+
+        // Retrieve the images of the swap chain
+        vkGetSwapchainImagesKHR(device, swapChain, &imageCount, nullptr);
+        swapChainImages.resize(imageCount);
+        vkGetSwapchainImagesKHR(device, swapChain, &imageCount, swapChainImages.data());
+
+        // Store the extent for later use
+        swapChainExtent = extent;
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::cleanup()
+    void Application::recreateSwapChain()
     {
-        cleanupSwapChain();
-
-        destroyVulkanObjects();
-
-        for (size_t i = 0; i < imageAvailableSemaphores.size(); ++i)
+        // If the window is minimzed, wait for it to be visible again
+        int width = 0, height = 0;
+        getFramebufferSize(width, height);
+        while ((width == 0) || (height == 0))
         {
-            vkDestroySemaphore(device, imageAvailableSemaphores[i], nullptr);
-            vkDestroySemaphore(device, renderFinishedSemaphores[i], nullptr);
-            vkDestroyFence(device, inFlightFences[i], nullptr);
-        }
+            if (renderThreadRunning)
+            {
+                // The events are processed by the main thread
+                if (stopRendering)
+                    return;
 
-        vkDestroyDevice(device, nullptr);
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
 
-        if (enableValidationLayers)
-        {
-            // Destroy the debug messenger (we have to look up the address of the function
-            // ourselves)
-            auto func = (PFN_vkDestroyDebugUtilsMessengerEXT) vkGetInstanceProcAddr(
-                instance, "vkDestroyDebugUtilsMessengerEXT"
-            );
+                // In pipelined mode, the events are processed by the simulation stage
+                if (!pipelineRunning)
+                    processWindowEvents();
+            }
+            else
+            {
+                waitEvents(-1.0);
+            }
 
-            if (func != nullptr)
-                func(instance, debugMessenger, nullptr);
+            getFramebufferSize(width, height);
         }
 
-        vkDestroySurfaceKHR(instance, surface, nullptr);
-        vkDestroyInstance(instance, nullptr);
+        // All the resize events received until now are handled by this recreation
+        framebufferResized = false;
 
-        glfwDestroyWindow(window);
-        glfwTerminate();
-    }
+        // The objects depending on the swap chain might still be used by the frames in
+        // flight: their destruction is deferred until the first frame rendered with the
+        // new swap chain is retired
+        retiredSwapChain_t retired;
+        retired.swapChain = swapChain;
+        retired.frameNumber = lastSubmittedFrame.load() + 1;
 
-    //-----------------------------------------------------------------------
+        deferringDestructions = true;
+        cleanupSwapChain();
+        deferringDestructions = false;
 
-    VkShaderModule Application::createShaderModule(const std::vector<char>& code) const
-    {
-        // Fill in a struct with some information about the shader
-        VkShaderModuleCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = code.size();
-        createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+        retired.destructors.swap(deferredDestructors);
 
-        VkShaderModule shaderModule;
-        if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS)
-            throw std::runtime_error("Failed to create shader module!");
+        // The old swap chain is passed to its replacement
+        createSwapChain();
+        createImageViews();
+        createRenderImages();
+        onSwapChainReady();
 
-        return shaderModule;
+        retiredSwapChains.push_back(std::move(retired));
+
+        // The IDs of the presentations done on the previous swap chain can't be waited
+        // for anymore
+        lastPresentId = 0;
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::createBuffer(
-        VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-        VkBuffer& buffer, VkDeviceMemory& bufferMemory
-    ) const
+    void Application::cleanupSwapChain()
     {
-        // Create the buffer
-        VkBufferCreateInfo bufferInfo{};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = size;
-        bufferInfo.usage = usage;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-        if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
-            throw std::runtime_error("Failed to create buffer!");
+        onSwapChainAboutToBeDestroyed();
 
-        // Allocate some memory for it
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+        destroyRenderImages();
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
+        {
+            std::lock_guard<std::mutex> lock(damageMutex);
+            imageDamageRects.clear();
+        }
 
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
-            throw std::runtime_error("Failed to allocate buffer memory!");
+        destroyWhenRetired([this, imageViews = std::move(swapChainImageViews)]() {
+            for (auto imageView : imageViews)
+                vkDestroyImageView(device, imageView, nullptr);
+        });
 
-        vkBindBufferMemory(device, buffer, bufferMemory, 0);
+        swapChainImageViews.clear();
+
+        // Contrary to a swap chain, the offscreen images can't be passed to their
+        // replacement
+        if (config.headless)
+            destroyOffscreenImages();
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::createImage(
-        uint32_t width, uint32_t height, uint32_t mipLevels,
-        VkSampleCountFlagBits nbSamples, VkFormat format, VkImageTiling tiling,
-        VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
-        VkImage& image, VkDeviceMemory& imageMemory
-    ) const
+    void Application::destroyRetiredSwapChains(bool all)
     {
-        // Create the image
-        VkImageCreateInfo imageInfo{};
-        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        imageInfo.imageType = VK_IMAGE_TYPE_2D;
-        imageInfo.extent.width = width;
-        imageInfo.extent.height = height;
-        imageInfo.extent.depth = 1;
-        imageInfo.mipLevels = mipLevels;
-        imageInfo.arrayLayers = 1;
-        imageInfo.format = format;
-        imageInfo.tiling = tiling;
-        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imageInfo.usage = usage;
-        imageInfo.samples = nbSamples;
-        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        while (!retiredSwapChains.empty())
+        {
+            retiredSwapChain_t& retired = retiredSwapChains.front();
 
-        if (vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS)
-            throw std::runtime_error("Failed to create an image!");
+            if (!all)
+            {
+                // The presentations done with the old swap chain must be done too
+                if (presentThread.joinable())
+                {
+                    std::lock_guard<std::mutex> lock(presentMutex);
+                    if (lastPresentedFrame < retired.frameNumber)
+                        break;
+                }
 
-        // Allocate memory on the GPU for the image
-        VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(device, image, &memRequirements);
+                if (!isFrameRetired(retired.frameNumber))
+                    break;
+            }
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
+            for (auto& destructor : retired.destructors)
+                destructor();
 
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
-            throw std::runtime_error("Failed to allocate image memory!");
+            if (retired.swapChain != VK_NULL_HANDLE)
+                vkDestroySwapchainKHR(device, retired.swapChain, nullptr);
 
-        vkBindImageMemory(device, image, imageMemory, 0);
+            retiredSwapChains.erase(retiredSwapChains.begin());
+        }
     }
 
     //-----------------------------------------------------------------------
 
-    VkImageView Application::createImageView(
-        VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels
-    ) const
+    void Application::destroyWhenRetired(std::function<void()> destructor)
     {
-        VkImageViewCreateInfo viewInfo{};
-        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        viewInfo.image = image;
-        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewInfo.format = format;
-        viewInfo.subresourceRange.aspectMask = aspectFlags;
-        viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = mipLevels;
-        viewInfo.subresourceRange.baseArrayLayer = 0;
-        viewInfo.subresourceRange.layerCount = 1;
-
-        VkImageView imageView;
-        if (vkCreateImageView(device, &viewInfo, nullptr, &imageView) != VK_SUCCESS)
-            throw std::runtime_error("Failed to create image view!");
-
-        return imageView;
+        if (deferringDestructions)
+            deferredDestructors.push_back(std::move(destructor));
+        else
+            destructor();
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::copyBuffer(
-        VkCommandPool commandPool, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size
-    ) const
+    void Application::createImageViews()
     {
-        // Create the command buffer
-        VkCommandBuffer commandBuffer = beginSingleTimeCommands(commandPool);
-
-        // Copy command
-        recordCopyBufferCommand(commandBuffer, srcBuffer, dstBuffer, size);
+        swapChainImageViews.resize(swapChainImages.size());
 
-        // Execute and release the command buffer
-        endSingleTimeCommands(commandPool, commandBuffer);
+        for (size_t i = 0; i < swapChainImages.size(); ++i)
+        {
+            swapChainImageViews[i] = createImageView(
+                swapChainImages[i], surfaceImageFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1
+            );
+        }
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::copyBufferToImage(
-        VkCommandPool commandPool, VkBuffer buffer, VkImage image,
-        uint32_t width, uint32_t height
-    ) const
+    void Application::createOffscreenImages()
     {
-        // Create the command buffer
-        VkCommandBuffer commandBuffer = beginSingleTimeCommands(commandPool);
+        // Check that the format can be used to render into the images
+        VkFormatProperties properties = getFormatProperties(surfaceImageFormat);
 
-        // Image copy command
-        recordCopyBufferToImageCommand(commandBuffer, buffer, image, width,  height);
+        if (!(properties.optimalTilingFeatures & VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT))
+            throw std::runtime_error("Format of the offscreen images not supported!");
 
-        // Execute and release the command buffer
-        endSingleTimeCommands(commandPool, commandBuffer);
+        if (config.useComputePresentation &&
+            !(properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+        {
+            throw std::runtime_error("Format of the offscreen images not supported by the compute presentation!");
+        }
+
+        // An image must never be used by two frames in flight
+        uint32_t imageCount = std::max(config.headlessImageCount, config.nbFramesInFlight);
+
+        swapChainExtent = {
+            static_cast<uint32_t>(framebufferWidth.load()),
+            static_cast<uint32_t>(framebufferHeight.load())
+        };
+
+        swapChainImages.resize(imageCount);
+        offscreenImageMemories.resize(imageCount);
+
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                  config.swapChainImageUsage;
+        if (config.useDynamicResolution)
+            usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+        if (config.useComputePresentation)
+            usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+
+        for (uint32_t i = 0; i < imageCount; ++i)
+        {
+            createImage(
+                swapChainExtent.width, swapChainExtent.height, 1, VK_SAMPLE_COUNT_1_BIT,
+                surfaceImageFormat, VK_IMAGE_TILING_OPTIMAL, usage,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                swapChainImages[i], offscreenImageMemories[i]
+            );
+        }
+
+        nextOffscreenImage = 0;
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::transitionImageLayout(
-        VkCommandPool commandPool, VkImage image, VkFormat format,
-        VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels
-    ) const
+    void Application::destroyOffscreenImages()
     {
-        // Create the command buffer
-        VkCommandBuffer commandBuffer = beginSingleTimeCommands(commandPool);
-
-        // Create a barrier to perform layout transition
-        recordTransitionImageLayoutCommand(
-            commandBuffer, image, format, oldLayout, newLayout, mipLevels
+        destroyWhenRetired(
+            [this, images = std::move(swapChainImages), memories = std::move(offscreenImageMemories)]() {
+                for (size_t i = 0; i < memories.size(); ++i)
+                {
+                    vkDestroyImage(device, images[i], nullptr);
+                    vkFreeMemory(device, memories[i], nullptr);
+                }
+            }
         );
 
-        // Execute and release the command buffer
-        endSingleTimeCommands(commandPool, commandBuffer);
+        swapChainImages.clear();
+        offscreenImageMemories.clear();
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::generateMipmaps(
-        VkCommandPool commandPool, VkImage image, VkFormat imageFormat,
-        int32_t texWidth, int32_t texHeight, uint32_t mipLevels
+    swapChainSupportDetails_t Application::querySwapChainSupport(VkPhysicalDevice device) const
+    {
+        return querySwapChainSupport(device, surface);
+    }
+
+    //-----------------------------------------------------------------------
+
+    swapChainSupportDetails_t Application::querySwapChainSupport(
+        VkPhysicalDevice device, VkSurfaceKHR surface
     ) const
     {
-        // Create the command buffer
-        VkCommandBuffer commandBuffer = beginSingleTimeCommands(commandPool);
+        swapChainSupportDetails_t details;
 
-        // Create a barrier to perform layout transition of each mipmap level
-        recordGenerateMipmapsCommand(
-            commandBuffer, image, imageFormat, texWidth, texHeight,  mipLevels
+        // Retrieve the surface capabilities (always, the current extent changes with the
+        // size of the window)
+        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilities);
+
+        // The supported formats and presentation modes are only retrieved once per
+        // surface
+        std::lock_guard<std::mutex> lock(capabilitiesMutex);
+
+        auto iter = surfaceSupportCache.find(std::make_pair(device, surface));
+        if (iter != surfaceSupportCache.end())
+        {
+            details.formats = iter->second.formats;
+            details.presentationModes = iter->second.presentationModes;
+            return details;
+        }
+
+        // Retrieve the supported surface formats
+        uint32_t formatCount;
+        vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, nullptr);
+
+        if (formatCount != 0)
+        {
+            details.formats.resize(formatCount);
+            vkGetPhysicalDeviceSurfaceFormatsKHR(
+                device, surface, &formatCount, details.formats.data()
+            );
+        }
+
+        // Retrieve the supported presentation modes
+        uint32_t presentationModeCount;
+        vkGetPhysicalDeviceSurfacePresentModesKHR(
+            device, surface, &presentationModeCount, nullptr
         );
 
-        // Execute and release the command buffer
-        endSingleTimeCommands(commandPool, commandBuffer);
+        if (presentationModeCount != 0) {
+            details.presentationModes.resize(presentationModeCount);
+            vkGetPhysicalDeviceSurfacePresentModesKHR(
+                device, surface, &presentationModeCount, details.presentationModes.data()
+            );
+        }
+
+        surfaceSupportCache[std::make_pair(device, surface)] = details;
+
+        return details;
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::recordCopyBufferCommand(
-        VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size
-    ) const
+    void Application::clearSurfaceSupport(VkSurfaceKHR surface)
     {
-        // Copy command
-        VkBufferCopy copyRegion{};
-        copyRegion.srcOffset = 0; // Optional
-        copyRegion.dstOffset = 0; // Optional
-        copyRegion.size = size;
-        vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+        std::lock_guard<std::mutex> lock(capabilitiesMutex);
+
+        for (auto iter = surfaceSupportCache.begin(); iter != surfaceSupportCache.end(); )
+        {
+            if (iter->first.second == surface)
+                iter = surfaceSupportCache.erase(iter);
+            else
+                ++iter;
+        }
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::recordCopyBufferToImageCommand(
-        VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image,
-        uint32_t width, uint32_t height
+    VkSurfaceFormatKHR Application::chooseSwapSurfaceFormat(
+        const std::vector<VkSurfaceFormatKHR>& availableFormats
     ) const
     {
-        // Image copy command
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
+        // When the images are written by compute shaders, prefer the first format usable
+        // for storage images (the sRGB ones usually aren't)
+        if (config.useComputePresentation)
+        {
+            for (const auto& availableFormat : availableFormats)
+            {
+                VkFormatProperties properties = getFormatProperties(availableFormat.format);
 
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
+                if ((properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) &&
+                    (availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR))
+                {
+                    return availableFormat;
+                }
+            }
+        }
 
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = {
-            width,
-            height,
-            1
-        };
+        // Prefer VK_FORMAT_B8G8R8A8_SRGB if it is available
+        for (const auto& availableFormat : availableFormats) {
+            if ((availableFormat.format == VK_FORMAT_B8G8R8A8_SRGB) &&
+                (availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR))
+            {
+                return availableFormat;
+            }
+        }
 
-        vkCmdCopyBufferToImage(
-            commandBuffer,
-            buffer,
-            image,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1,
-            &region
-        );
+        // Otherwise use the first one of the list
+        return availableFormats[0];
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::recordTransitionImageLayoutCommand(
-        VkCommandBuffer commandBuffer, VkImage image, VkFormat format,
-        VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels
+    VkPresentModeKHR Application::chooseSwapPresentationMode(
+        const std::vector<VkPresentModeKHR>& availablePresentModes
     ) const
     {
-        // Create a barrier to perform layout transition
-        VkImageMemoryBarrier barrier{};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = oldLayout;
-        barrier.newLayout = newLayout;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = image;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = mipLevels;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-
-        VkPipelineStageFlags sourceStage;
-        VkPipelineStageFlags destinationStage;
+        // Order of preference of the presentation modes, depending on the policy
+        std::vector<VkPresentModeKHR> preferredModes;
 
-        if ((oldLayout == VK_IMAGE_LAYOUT_UNDEFINED) &&
-            (newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL))
+        switch (config.presentationPolicy)
         {
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            case PRESENTATION_POLICY_LOW_LATENCY:
+                preferredModes = {
+                    VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR,
+                    VK_PRESENT_MODE_FIFO_RELAXED_KHR
+                };
+                break;
 
-            sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        }
-        else if ((oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) &&
-                 (newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL))
-        {
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            case PRESENTATION_POLICY_POWER_SAVING:
+                break;
 
-            sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            case PRESENTATION_POLICY_MAX_THROUGHPUT:
+                preferredModes = {
+                    VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR,
+                    VK_PRESENT_MODE_FIFO_RELAXED_KHR
+                };
+                break;
+
+            default:
+                preferredModes = { VK_PRESENT_MODE_MAILBOX_KHR };
+                break;
         }
-        else
+
+        for (auto preferredMode : preferredModes)
         {
-            throw std::invalid_argument("Unsupported layout transition!");
+            for (const auto& availablePresentMode : availablePresentModes) {
+                if (availablePresentMode == preferredMode) {
+                    return availablePresentMode;
+                }
+            }
         }
 
-        vkCmdPipelineBarrier(
-            commandBuffer,
-            sourceStage, destinationStage,
-            0,
-            0, nullptr,
-            0, nullptr,
-            1, &barrier
-        );
+        // Otherwise use VK_PRESENT_MODE_FIFO_KHR (which is guaranteed to be
+        // available)
+        return VK_PRESENT_MODE_FIFO_KHR;
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::recordGenerateMipmapsCommand(
-        VkCommandBuffer commandBuffer, VkImage image, VkFormat imageFormat,
-        int32_t texWidth, int32_t texHeight, uint32_t mipLevels
+    VkImageUsageFlags Application::getSwapChainImageUsage(
+        const VkSurfaceCapabilitiesKHR& capabilities, VkFormat format
     ) const
     {
-        // Check if image format supports linear blitting
-        VkFormatProperties formatProperties;
-        vkGetPhysicalDeviceFormatProperties(physicalDevice, imageFormat, &formatProperties);
-
-        if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
-            throw std::runtime_error("Texture image format does not support linear blitting!");
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
-        // Create a barrier to perform layout transition of each mipmap level
-        VkImageMemoryBarrier barrier{};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.image = image;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.subresourceRange.levelCount = 1;
+        // Additional usages requested by the user
+        if (config.swapChainImageUsage != 0)
+        {
+            if ((capabilities.supportedUsageFlags & config.swapChainImageUsage) != config.swapChainImageUsage)
+                throw std::runtime_error("Usage of the swap chain images not supported by the surface!");
 
-        // Iterate over all mipmap level
-        int32_t mipWidth = texWidth;
-        int32_t mipHeight = texHeight;
+            usage |= config.swapChainImageUsage;
+        }
 
-        for (uint32_t i = 1; i < mipLevels; ++i)
+        // The images are copied into readback buffers to capture the frames
+        if (config.captureInterval > 0)
         {
-            // Transition the layout of level i-1 to VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-            barrier.subresourceRange.baseMipLevel = i - 1;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            if (!(capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+                throw std::runtime_error("Frame capture not supported by the surface!");
 
-            vkCmdPipelineBarrier(
-                commandBuffer,
-                VK_PIPELINE_STAGE_TRANSFER_BIT,
-                VK_PIPELINE_STAGE_TRANSFER_BIT,
-                0,
-                0, nullptr,
-                0, nullptr,
-                1, &barrier
-            );
+            usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        }
 
-            // Copy and resize the image of level i-1 to level i
-            VkImageBlit blit{};
-            blit.srcOffsets[0] = { 0, 0, 0 };
-            blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            blit.srcSubresource.mipLevel = i - 1;
-            blit.srcSubresource.baseArrayLayer = 0;
-            blit.srcSubresource.layerCount = 1;
-            blit.dstOffsets[0] = { 0, 0, 0 };
-            blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
-            blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            blit.dstSubresource.mipLevel = i;
-            blit.dstSubresource.baseArrayLayer = 0;
-            blit.dstSubresource.layerCount = 1;
+        // The render images are scaled into the swap chain images with a blit
+        if (config.useDynamicResolution)
+        {
+            if (!(capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+                throw std::runtime_error("Dynamic resolution not supported by the surface!");
 
-            vkCmdBlitImage(
-                commandBuffer,
-                image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                1, &blit,
-                VK_FILTER_LINEAR
-            );
+            usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
 
-            // Transition the layout of level i-1 to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        // The images are written by compute shaders
+        if (config.useComputePresentation)
+        {
+            if (!(capabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT))
+                throw std::runtime_error("Compute presentation not supported by the surface!");
 
-            vkCmdPipelineBarrier(
-                commandBuffer,
-                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-                0, nullptr,
-                0, nullptr,
-                1, &barrier
-            );
+            VkFormatProperties properties = getFormatProperties(format);
 
-            if (mipWidth > 1) mipWidth /= 2;
-            if (mipHeight > 1) mipHeight /= 2;
-        }
+            if (!(properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+                throw std::runtime_error("Format of the swap chain images not supported by the compute presentation!");
 
-        // Transition the layout of the last level to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-        barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+        }
 
-        vkCmdPipelineBarrier(
-            commandBuffer,
-            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-            0, nullptr,
-            0, nullptr,
-            1, &barrier
-        );
+        return usage;
     }
 
     //-----------------------------------------------------------------------
 
-    VkCommandBuffer Application::beginSingleTimeCommands(VkCommandPool commandPool) const
+    uint32_t Application::chooseSwapImageCount(
+        const VkSurfaceCapabilitiesKHR& capabilities, VkPresentModeKHR presentationMode
+    ) const
     {
-        // Allocate a command buffer
-        VkCommandBufferAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool = commandPool;
-        allocInfo.commandBufferCount = 1;
+        uint32_t imageCount = config.swapChainImageCount;
 
-        VkCommandBuffer commandBuffer;
-        vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
+        if (imageCount == 0)
+        {
+            switch (config.presentationPolicy)
+            {
+                case PRESENTATION_POLICY_LOW_LATENCY:
+                    // MAILBOX needs a third image to be able to replace the queued one
+                    // without blocking
+                    imageCount = capabilities.minImageCount +
+                                 (presentationMode == VK_PRESENT_MODE_MAILBOX_KHR ? 1 : 0);
+                    break;
 
-        // Start recording commands
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+                case PRESENTATION_POLICY_POWER_SAVING:
+                    imageCount = capabilities.minImageCount;
+                    break;
 
-        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+                default:
+                    imageCount = capabilities.minImageCount + 1;
+                    break;
+            }
+        }
 
-        return commandBuffer;
+        imageCount = std::max(imageCount, capabilities.minImageCount);
+
+        if ((capabilities.maxImageCount > 0) && (imageCount > capabilities.maxImageCount))
+            imageCount = capabilities.maxImageCount;
+
+        return imageCount;
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::endSingleTimeCommands(
-        VkCommandPool commandPool, VkCommandBuffer commandBuffer
+    VkExtent2D Application::chooseSwapExtent(
+        const VkSurfaceCapabilitiesKHR& capabilities
     ) const
     {
-        // End recording commands
-        vkEndCommandBuffer(commandBuffer);
+        // Is Vulkan asking for our help here (ie. on a Retina display)?
+        // (see https://vulkan-tutorial.com/en/Drawing_a_triangle/Presentation/Swap_chain#page_Swap-extent)
+        if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max())
+            return capabilities.currentExtent;
 
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
+        // Retrieve the actual window size in pixels (might be different from
+        // the one in screen coordinates)
+        int width, height;
+        getFramebufferSize(width, height);
 
-        // Execute the command buffer
-        vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(graphicsQueue);
+        VkExtent2D actualExtent = {
+            static_cast<uint32_t>(width),
+            static_cast<uint32_t>(height)
+        };
 
-        // Cleanup
-        vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+        // ensure the dimensions are within supported bounds
+        actualExtent.width = std::clamp(
+            actualExtent.width, capabilities.minImageExtent.width,
+            capabilities.maxImageExtent.width
+        );
+
+        actualExtent.height = std::clamp(
+            actualExtent.height, capabilities.minImageExtent.height,
+            capabilities.maxImageExtent.height
+        );
+
+        return actualExtent;
     }
 
     //-----------------------------------------------------------------------
 
-    uint32_t Application::findMemoryType(
-        uint32_t typeFilter, VkMemoryPropertyFlags properties
-    ) const
+    void Application::createSyncObjects()
     {
-        // Query info about the available types of memory
-        VkPhysicalDeviceMemoryProperties memProperties;
-        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+        if ((config.nbFramesInFlight == 0) || (config.nbFramesInFlight > MAX_NB_FRAMES_IN_FLIGHT))
+            throw std::runtime_error("Invalid number of frames in flight!");
 
-        // Find a memory type that is suitable for the buffer
-        for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++i)
+        frames.resize(config.nbFramesInFlight);
+        currentFrame = 0;
+
+#ifdef VK_API_VERSION_1_2
+        // When supported, a single timeline semaphore (signaled with the number of each
+        // frame) replaces the fences
+        if (timelineSemaphoreSupported)
         {
-            if ((typeFilter & (1 << i)) &&
-                ((memProperties.memoryTypes[i].propertyFlags & properties) == properties))
-            {
-                return i;
-            }
+            VkSemaphoreTypeCreateInfo timelineInfo{};
+            timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+            timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+            timelineInfo.initialValue = lastSubmittedFrame.load();
+
+            VkSemaphoreCreateInfo timelineSemaphoreInfo{};
+            timelineSemaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            timelineSemaphoreInfo.pNext = &timelineInfo;
+
+            if (vkCreateSemaphore(device, &timelineSemaphoreInfo, nullptr, &frameTimelineSemaphore) != VK_SUCCESS)
+                throw std::runtime_error("Failed to create timeline semaphore!");
         }
+#endif
 
-        throw std::runtime_error("Failed to find suitable memory type!");
-    }
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    //-----------------------------------------------------------------------
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-    VkFormat Application::findSupportedFormat(
-        const std::vector<VkFormat>& candidates, VkImageTiling tiling,
-        VkFormatFeatureFlags features
-    ) const
-    {
-        for (VkFormat format : candidates)
-        {
-            VkFormatProperties props;
-            vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
+        // The command pools are reset as a whole each time their frame context is reused
+        queueFamilyIndices_t indices = deviceContext->queueFamilies;
 
-            if ((tiling == VK_IMAGE_TILING_LINEAR) &&
-                ((props.linearTilingFeatures & features) == features))
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = indices.families[GRAPHICS_QUEUE_FAMILY];
+
+        for (auto& frame : frames)
+        {
+            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore) != VK_SUCCESS ||
+                vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.renderFinishedSemaphore) != VK_SUCCESS)
             {
-                return format;
+                throw std::runtime_error("Failed to create synchronization objects for a frame!");
             }
-            else if ((tiling == VK_IMAGE_TILING_OPTIMAL) &&
-                     ((props.optimalTilingFeatures & features) == features))
+
+            if ((frameTimelineSemaphore == VK_NULL_HANDLE) &&
+                (vkCreateFence(device, &fenceInfo, nullptr, &frame.inFlightFence) != VK_SUCCESS))
             {
-                return format;
+                throw std::runtime_error("Failed to create synchronization objects for a frame!");
             }
-        }
 
-        throw std::runtime_error("Failed to find supported format!");
-    }
+            frame.frameNumber = lastSubmittedFrame.load();
 
-    //-----------------------------------------------------------------------
+            if (vkCreateCommandPool(device, &poolInfo, nullptr, &frame.commandPool) != VK_SUCCESS)
+                throw std::runtime_error("Failed to create command pool for a frame!");
 
-    void Application::createInstance()
-    {
-        // If necessary, check that all the needed validation layers are available
-        if (enableValidationLayers && !checkValidationLayerSupport()) {
-            throw std::runtime_error("Validation layers requested, but not available!");
+            frame.scratch.resize(config.frameScratchSize);
         }
+    }
 
-        // Fill in a struct with some information about our application
-        VkApplicationInfo appInfo{};
-        appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
-        appInfo.pApplicationName = config.applicationName.data();
-        appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
-        appInfo.pEngineName = "No Engine";
-        appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        appInfo.apiVersion = config.vulkanVersion;
-
-        // Fill in a struct with sufficient information for creating an instance
-        VkInstanceCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
-        createInfo.pApplicationInfo = &appInfo;
-
-        //-- Enable the needed extensions
-        auto requiredExtensions = getRequiredExtensions();
-        createInfo.enabledExtensionCount = (uint32_t) requiredExtensions.size();
-        createInfo.ppEnabledExtensionNames = requiredExtensions.data();
-
-#ifdef __APPLE__
-        //-- MacOS-related flags
-        createInfo.flags |= VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR;
-#endif
-
-        //-- Validation layers
-        VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
-        if (enableValidationLayers) {
-            createInfo.enabledLayerCount = static_cast<uint32_t>(config.validationLayers.size());
-            createInfo.ppEnabledLayerNames = config.validationLayers.data();
 
-            // Needed to have a debug messenger during instance creation/destruction
-            populateDebugMessengerCreateInfo(debugCreateInfo);
-            createInfo.pNext = (VkDebugUtilsMessengerCreateInfoEXT*) &debugCreateInfo;
-        } else {
-            createInfo.enabledLayerCount = 0;
-            createInfo.pNext = nullptr;
+    void Application::createRenderImages()
+    {
+        if (!config.useDynamicResolution)
+        {
+            renderExtent = swapChainExtent;
+            return;
         }
 
-        // Creation of the instance
-        if (vkCreateInstance(&createInfo, nullptr, &instance) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to create instance!");
+        // The render images are scaled into the swap chain images with a linear filter
+        VkFormatProperties properties = getFormatProperties(surfaceImageFormat);
+
+        const VkFormatFeatureFlags requiredFeatures =
+            VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+            VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+        if ((properties.optimalTilingFeatures & requiredFeatures) != requiredFeatures)
+            throw std::runtime_error("Format of the swap chain images not supported by the dynamic resolution!");
+
+        // The images have the maximum resolution, only a part of them being used when the
+        // scale is lower
+        maxRenderExtent = {
+            std::max(1u, static_cast<uint32_t>(swapChainExtent.width * config.dynamicResolutionMaxScale)),
+            std::max(1u, static_cast<uint32_t>(swapChainExtent.height * config.dynamicResolutionMaxScale))
+        };
+
+        renderImages.resize(swapChainImages.size());
+        renderImageMemories.resize(swapChainImages.size());
+        renderImageViews.resize(swapChainImages.size());
+
+        for (size_t i = 0; i < swapChainImages.size(); ++i)
+        {
+            createImage(
+                maxRenderExtent.width, maxRenderExtent.height, 1, VK_SAMPLE_COUNT_1_BIT,
+                surfaceImageFormat, VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                VK_IMAGE_USAGE_SAMPLED_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, renderImages[i], renderImageMemories[i]
+            );
+
+            renderImageViews[i] = createImageView(
+                renderImages[i], surfaceImageFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1
+            );
         }
+
+        resolutionScale = std::clamp(
+            resolutionScale, config.dynamicResolutionMinScale, config.dynamicResolutionMaxScale
+        );
+
+        updateRenderExtent();
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::createSurface()
+    void Application::destroyRenderImages()
     {
-        if (glfwCreateWindowSurface(instance, window, nullptr, &surface) != VK_SUCCESS)
-            throw std::runtime_error("Failed to create window surface!");
+        destroyWhenRetired(
+            [this, images = std::move(renderImages), memories = std::move(renderImageMemories),
+             views = std::move(renderImageViews)]() {
+                for (size_t i = 0; i < images.size(); ++i)
+                {
+                    vkDestroyImageView(device, views[i], nullptr);
+                    vkDestroyImage(device, images[i], nullptr);
+                    vkFreeMemory(device, memories[i], nullptr);
+                }
+            }
+        );
+
+        renderImages.clear();
+        renderImageMemories.clear();
+        renderImageViews.clear();
     }
 
     //-----------------------------------------------------------------------
 
-    std::vector<const char*> Application::getRequiredExtensions() const
+    void Application::createTimestampQueries()
     {
-        std::vector<const char*> extensions;
-
-        // Retrieve GLFW-related extensions
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions;
+        if (!config.useDynamicResolution)
+            return;
 
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        resolutionScale = config.dynamicResolutionMaxScale;
 
-        for(uint32_t i = 0; i < glfwExtensionCount; ++i)
-            extensions.emplace_back(glfwExtensions[i]);
+        {
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+            statistics.resolutionScale = resolutionScale;
+        }
 
-#ifdef __APPLE__
-        // MacOS-related extensions
-        extensions.emplace_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
-#endif
+        // Without timestamps on the graphics queue, the resolution stays at the maximum
+        // scale
+        uint32_t graphicsFamily = deviceContext->queueFamilies.families[GRAPHICS_QUEUE_FAMILY];
+        uint32_t validBits = deviceCapabilities->queueFamilies[graphicsFamily].timestampValidBits;
 
-        // Validation layers-related extensions
-        if (enableValidationLayers) {
-            extensions.emplace_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
-        }
+        if (validBits == 0)
+            return;
 
-        // Retrieve the list of supported extensions
-        uint32_t extensionCount;
-        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+        timestampMask = (validBits >= 64 ? UINT64_MAX : (uint64_t(1) << validBits) - 1);
 
-        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
-        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
-        
-        // Check for the availability of the "VK_KHR_get_physical_device_properties2"
-        // extension (needed by the "VK_KHR_portability_subset" device extension, see
-        // checkDeviceExtensionSupport())
-        for (const auto& extension : availableExtensions)
-        {
-            if (strcmp(extension.extensionName, "VK_KHR_get_physical_device_properties2") == 0)
-            {
-                extensions.emplace_back("VK_KHR_get_physical_device_properties2");
-                break;
-            }
-        }
+        // Two timestamps per frame-in-flight: at the start and at the end of the frame
+        VkQueryPoolCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        createInfo.queryCount = config.nbFramesInFlight * 2;
 
-        return extensions;
+        if (vkCreateQueryPool(device, &createInfo, nullptr, &timestampQueryPool) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create timestamp query pool!");
     }
 
+    //-----------------------------------------------------------------------
 
-    /******************************** PHYSICAL DEVICES **********************************/
+    void Application::updateRenderExtent()
+    {
+        renderExtent = {
+            std::clamp(
+                static_cast<uint32_t>(swapChainExtent.width * resolutionScale),
+                1u, maxRenderExtent.width
+            ),
+            std::clamp(
+                static_cast<uint32_t>(swapChainExtent.height * resolutionScale),
+                1u, maxRenderExtent.height
+            )
+        };
 
-    void Application::pickPhysicalDevice()
+        std::lock_guard<std::mutex> lock(statisticsMutex);
+        statistics.resolutionScale = resolutionScale;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Application::updateResolutionScale(uint32_t frameIndex)
     {
-        // Retrieve the number of physical devices
-        uint32_t deviceCount = 0;
-        vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+        frameContext_t& frame = frames[frameIndex];
 
-        if (deviceCount == 0)
-            throw std::runtime_error("Failed to find GPUs with Vulkan support!");
+        // The frame context might be waited for several times before being reused (when
+        // the acquisition of the swap chain image fails): each frame is only sampled once
+        if ((timestampQueryPool == VK_NULL_HANDLE) || (frame.frameNumber == 0) ||
+            (frame.sampledFrameNumber == frame.frameNumber))
+        {
+            return;
+        }
 
-        // Retrieve a list of all physical devices
-        std::vector<VkPhysicalDevice> devices(deviceCount);
-        vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+        uint64_t timestamps[2];
+        if (vkGetQueryPoolResults(
+                device, timestampQueryPool, frameIndex * 2, 2, sizeof(timestamps),
+                timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT
+            ) != VK_SUCCESS)
+        {
+            return;
+        }
+
+        frame.sampledFrameNumber = frame.frameNumber;
+
+        // Only the valid bits of the timestamps are meaningful (the difference is
+        // masked too, in case the counter wrapped around)
+        uint64_t ticks = ((timestamps[1] & timestampMask) - (timestamps[0] & timestampMask)) &
+                         timestampMask;
+
+        float gpuTime = float(ticks) * deviceContext->properties.limits.timestampPeriod * 1e-9f;
 
-        // Find the first suitable device
-        for (const auto& device : devices)
         {
-            if (isDeviceSuitable(device))
-            {
-                physicalDevice = device;
-                msaaNbMaxSamples = getMaxUsableSampleCount();
-                break;
-            }
+            std::lock_guard<std::mutex> lock(statisticsMutex);
+            statistics.gpuTime = gpuTime;
         }
 
-        if (physicalDevice == VK_NULL_HANDLE)
-            throw std::runtime_error("Failed to find a suitable GPU!");
+        gpuTimeSum += gpuTime;
+        ++nbGpuTimeSamples;
 
-        // Retrieve and store the best surface format supported by the physical device for later use
-        swapChainSupportDetails_t swapChainSupport = querySwapChainSupport(physicalDevice);
+        if (nbGpuTimeSamples < std::max(config.dynamicResolutionInterval, 1u))
+            return;
 
-        VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(
-            swapChainSupport.formats
+        float averageGpuTime = gpuTimeSum / nbGpuTimeSamples;
+
+        gpuTimeSum = 0.0f;
+        nbGpuTimeSamples = 0;
+
+        if (averageGpuTime <= 0.0f)
+            return;
+
+        // The GPU time is roughly proportional to the number of pixels (so to the square
+        // of the scale). Only go halfway to the estimated scale, to avoid oscillations.
+        float targetScale = resolutionScale * std::sqrt(config.dynamicResolutionBudget / averageGpuTime);
+
+        resolutionScale = std::clamp(
+            resolutionScale + (targetScale - resolutionScale) * 0.5f,
+            config.dynamicResolutionMinScale, config.dynamicResolutionMaxScale
         );
 
-        surfaceImageFormat = surfaceFormat.format;
+        updateRenderExtent();
     }
 
     //-----------------------------------------------------------------------
 
-    bool Application::isDeviceSuitable(VkPhysicalDevice device) const
+    void Application::recordDynamicResolutionCommands(
+        frameContext_t& frame, uint32_t frameIndex, uint32_t imageIndex,
+        VkCommandBuffer& beginCommandBuffer, VkCommandBuffer& endCommandBuffer
+    )
     {
-        // Retrieve the indices of the queue families we need from the physical
-        // device
-        queueFamilyIndices_t indices = findQueueFamilies(device);
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = frame.commandPool;
+        allocInfo.commandBufferCount = 2;
 
-        // Check that the device extensions we need are supported
-        bool extensionsSupported = checkDeviceExtensionSupport(device);
+        VkCommandBuffer commandBuffers[2];
+        if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate dynamic resolution command buffers!");
 
-        // Check that the swap chain support is adequate on the device (we need
-        // at least one surface format and one presentation mode)
-        bool swapChainAdequate = false;
-        if (extensionsSupported)
-        {
-            swapChainSupportDetails_t swapChainSupport = querySwapChainSupport(device);
-            swapChainAdequate = !swapChainSupport.formats.empty() &&
-                                !swapChainSupport.presentationModes.empty();
-        }
+        beginCommandBuffer = commandBuffers[0];
+        endCommandBuffer = commandBuffers[1];
 
-        // First check to dismiss inadequate devices
-        if (!indices.isComplete() || !extensionsSupported || !swapChainAdequate)
-            return false;
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-        // Check that the required (api-specific) features are supported
-        if (config.vulkanVersion == VK_API_VERSION_1_0)
-        {
-            // Retrieve the features supported by the device
-            VkPhysicalDeviceFeatures supportedFeatures;
-            vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
+        // Start of the frame
+        vkBeginCommandBuffer(beginCommandBuffer, &beginInfo);
 
-            // Check if all the required features are there
-            return compareFeatures(
-                (void*) &config.features10, (void*) &supportedFeatures,
-                sizeof(VkPhysicalDeviceFeatures), 0, true
+        if (timestampQueryPool != VK_NULL_HANDLE)
+        {
+            // Written at the stage waiting for the availability of the swap chain image,
+            // so the time spent waiting for the presentation engine isn't measured
+            vkCmdResetQueryPool(beginCommandBuffer, timestampQueryPool, frameIndex * 2, 2);
+            vkCmdWriteTimestamp(
+                beginCommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                timestampQueryPool, frameIndex * 2
             );
         }
-        else
-        {
-            // Retrieve the properties of the device
-            VkPhysicalDeviceProperties physicalDeviceProperties;
-            vkGetPhysicalDeviceProperties(device, &physicalDeviceProperties);
 
-            // Retrieve the features supported by the device
-            VkPhysicalDeviceFeatures2 supportedFeatures{};
-            supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        vkEndCommandBuffer(beginCommandBuffer);
 
-#ifdef VK_API_VERSION_1_1
-            VkPhysicalDeviceVulkan11Features features11{};
-            features11.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
-            supportedFeatures.pNext = &features11;
-#endif
+        // End of the frame: scale the render image into the swap chain image
+        vkBeginCommandBuffer(endCommandBuffer, &beginInfo);
 
-#ifdef VK_API_VERSION_1_2
-            VkPhysicalDeviceVulkan12Features features12{};
-            features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
-            features11.pNext = &features12;
-#endif
+        VkImageMemoryBarrier barriers[2]{};
+        for (auto& barrier : barriers)
+        {
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = 1;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = 1;
+        }
 
-#ifdef VK_API_VERSION_1_3
-            VkPhysicalDeviceVulkan13Features features13{};
-            features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
-            features12.pNext = &features13;
-#endif
+        // Wait for the rendering of the frame
+        barriers[0].image = renderImages[imageIndex];
+        barriers[0].oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        // The previous content of the swap chain image is discarded (the stage matches
+        // the one waiting for its availability)
+        barriers[1].image = swapChainImages[imageIndex];
+        barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[1].srcAccessMask = 0;
+        barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 
-            vkGetPhysicalDeviceFeatures2(device, &supportedFeatures);
+        vkCmdPipelineBarrier(
+            endCommandBuffer,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            2, barriers
+        );
 
-            // Check if all the required 1.0 features are there
-            if (!compareFeatures(
-                    (void*) &config.features10,
-                    (void*) &supportedFeatures.features,
-                    sizeof(VkPhysicalDeviceFeatures), 0, true
-            ))
-            {
-                return false;
-            }
+        VkImageBlit blit{};
+        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel = 0;
+        blit.srcSubresource.baseArrayLayer = 0;
+        blit.srcSubresource.layerCount = 1;
+        blit.srcOffsets[0] = { 0, 0, 0 };
+        blit.srcOffsets[1] = {
+            static_cast<int32_t>(frame.renderExtent.width),
+            static_cast<int32_t>(frame.renderExtent.height),
+            1
+        };
+        blit.dstSubresource = blit.srcSubresource;
+        blit.dstOffsets[0] = { 0, 0, 0 };
+        blit.dstOffsets[1] = {
+            static_cast<int32_t>(swapChainExtent.width),
+            static_cast<int32_t>(swapChainExtent.height),
+            1
+        };
 
-#ifdef VK_API_VERSION_1_1
-            // Check if all the required 1.1 features are there
-            if (!compareFeatures(
-                    (void*) &config.features11,
-                    (void*) &features11,
-                    sizeof(VkPhysicalDeviceVulkan11Features),
-                    offsetof(VkPhysicalDeviceVulkan11Features, storageBuffer16BitAccess),
-                    physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_1
-            ))
-            {
-                return false;
-            }
-#endif
+        vkCmdBlitImage(
+            endCommandBuffer,
+            renderImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            swapChainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &blit, VK_FILTER_LINEAR
+        );
 
-#ifdef VK_API_VERSION_1_2
-            // Check if all the required 1.2 features are there
-            if (!compareFeatures(
-                    (void*) &config.features12,
-                    (void*) &features12,
-                    sizeof(VkPhysicalDeviceVulkan12Features),
-                    offsetof(VkPhysicalDeviceVulkan12Features, samplerMirrorClampToEdge),
-                    physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_2
-            ))
-            {
-                return false;
-            }
-#endif
+        // The swap chain image can then be presented (or captured)
+        barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[1].newLayout = config.captureImageLayout;
+        barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[1].dstAccessMask = 0;
 
-#ifdef VK_API_VERSION_1_3
-            // Check if all the required 1.3 features are there
-            if (!compareFeatures(
-                    (void*) &config.features13,
-                    (void*) &features13,
-                    sizeof(VkPhysicalDeviceVulkan13Features),
-                    offsetof(VkPhysicalDeviceVulkan13Features, robustImageAccess),
-                    physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_3
-            ))
-            {
-                return false;
-            }
-#endif
+        vkCmdPipelineBarrier(
+            endCommandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &barriers[1]
+        );
+
+        if (timestampQueryPool != VK_NULL_HANDLE)
+        {
+            vkCmdWriteTimestamp(
+                endCommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPool,
+                frameIndex * 2 + 1
+            );
         }
 
-        return true;
+        if (vkEndCommandBuffer(endCommandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record dynamic resolution command buffer!");
     }
 
     //-----------------------------------------------------------------------
 
-    queueFamilyIndices_t Application::findQueueFamilies(VkPhysicalDevice device) const
+    void Application::recordComputePresentationCommands(
+        frameContext_t& frame, uint32_t imageIndex,
+        VkCommandBuffer& beginCommandBuffer, VkCommandBuffer& endCommandBuffer
+    )
     {
-        queueFamilyIndices_t indices;
-        indices.nbRequiredFamilies = 2;
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = frame.commandPool;
+        allocInfo.commandBufferCount = 2;
 
-        // Retrieve the available queue families
-        uint32_t queueFamilyCount = 0;
-        vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+        VkCommandBuffer commandBuffers[2];
+        if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate compute presentation command buffers!");
 
-        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
-        vkGetPhysicalDeviceQueueFamilyProperties(
-            device, &queueFamilyCount, queueFamilies.data()
+        beginCommandBuffer = commandBuffers[0];
+        endCommandBuffer = commandBuffers[1];
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = swapChainImages[imageIndex];
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+
+        // Start of the frame: the previous content of the image is discarded, and it can
+        // be read and written by the compute shaders (the stage matches the one waiting
+        // for its availability)
+        vkBeginCommandBuffer(beginCommandBuffer, &beginInfo);
+
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(
+            beginCommandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier
         );
 
-        // Iterate through all the queue families
-        int i = 0;
-        for (const auto& queueFamily : queueFamilies)
-        {
-            // Are graphics commands supported?
-            if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
-                indices.families[GRAPHICS_QUEUE_FAMILY] = i;
+        if (vkEndCommandBuffer(beginCommandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record compute presentation command buffer!");
 
-            // Is presentation supported?
-            VkBool32 presentationSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentationSupport);
-            if (presentationSupport)
-                indices.families[PRESENTATION_QUEUE_FAMILY] = i;
+        // End of the frame: the image can then be presented (or captured)
+        vkBeginCommandBuffer(endCommandBuffer, &beginInfo);
 
-            // Do we have everything we need?
-            if (indices.isComplete())
-                break;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.newLayout = config.captureImageLayout;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
 
-            ++i;
-        }
+        vkCmdPipelineBarrier(
+            endCommandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier
+        );
 
-        return indices;
+        if (vkEndCommandBuffer(endCommandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record compute presentation command buffer!");
     }
 
     //-----------------------------------------------------------------------
 
-    std::vector<const char*> Application::getRequiredDeviceExtensions(VkPhysicalDevice device) const
+    void Application::createAdditionalWindows()
     {
-        std::vector<const char*> extensions(config.deviceExtensions.begin(), config.deviceExtensions.end());
+        if (config.additionalWindows.empty())
+            return;
 
-        // Retrieve the list of supported device extensions
-        uint32_t extensionCount;
-        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+        if (config.additionalWindows.size() >= MAX_NB_WINDOWS)
+            throw std::runtime_error("Too many additional windows!");
 
-        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
-        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+        if (config.usePipelinedStages)
+            throw std::runtime_error("Additional windows aren't supported with the pipelined stages!");
 
-        // The Vulkan spec states: If the VK_KHR_portability_subset extension is
-        // supported, it must be included
-        for (const auto& extension : availableExtensions)
-        {
-            if (strcmp(extension.extensionName, "VK_KHR_portability_subset") == 0)
-            {
-                extensions.emplace_back("VK_KHR_portability_subset");
-                break;
-            }
-        }
+        int nbMonitors = 0;
+        GLFWmonitor** monitors = glfwGetMonitors(&nbMonitors);
 
-        return extensions;
-    }
+        for (const auto& description : config.additionalWindows)
+        {
+            windowTarget_t& target = windowTargets.emplace_back();
 
-    //-----------------------------------------------------------------------
+            GLFWmonitor* monitor = nullptr;
+            if ((description.monitor >= 0) && (description.monitor < nbMonitors))
+                monitor = monitors[description.monitor];
 
-    bool Application::checkDeviceExtensionSupport(VkPhysicalDevice device) const
-    {
-        // Retrieve the list of supported device extensions
-        uint32_t extensionCount;
-        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+            target.window = glfwCreateWindow(
+                description.width, description.height, description.title.data(),
+                monitor, nullptr
+            );
 
-        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
-        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+            if (target.window == nullptr)
+                throw std::runtime_error("Failed to create additional window!");
 
-        // Check if all the ones we require are present
-        std::vector<const char*> requiredExtensions = getRequiredDeviceExtensions(device);
-        std::set<std::string> deviceExtensions(requiredExtensions.begin(), requiredExtensions.end());
-        for (const auto& extension : availableExtensions)
-            deviceExtensions.erase(extension.extensionName);
+            glfwSetWindowUserPointer(target.window, this);
+            glfwSetFramebufferSizeCallback(target.window, onAdditionalWindowResized);
+            glfwSetWindowRefreshCallback(target.window, onWindowRefresh);
 
-        return deviceExtensions.empty();
+            int width, height;
+            glfwGetFramebufferSize(target.window, &width, &height);
+            target.framebufferWidth = width;
+            target.framebufferHeight = height;
+        }
     }
 
     //-----------------------------------------------------------------------
 
-    VkSampleCountFlagBits Application::getMaxUsableSampleCount() const
+    void Application::createWindowTargets()
     {
-        VkPhysicalDeviceProperties physicalDeviceProperties;
-        vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-        VkSampleCountFlags counts =
-            physicalDeviceProperties.limits.framebufferColorSampleCounts &
-            physicalDeviceProperties.limits.framebufferDepthSampleCounts;
+        uint32_t presentationFamily =
+            deviceContext->queueFamilies.families[PRESENTATION_QUEUE_FAMILY];
 
-        for (int flag = VK_SAMPLE_COUNT_64_BIT; flag > VK_SAMPLE_COUNT_1_BIT; flag >>= 1)
+        for (uint32_t i = 0; i < windowTargets.size(); ++i)
         {
-            if (counts & flag)
-                return static_cast<VkSampleCountFlagBits>(flag);
-        }
+            windowTarget_t& target = windowTargets[i];
 
-        return VK_SAMPLE_COUNT_1_BIT;
-    }
+            if (glfwCreateWindowSurface(instance, target.window, nullptr, &target.surface) != VK_SUCCESS)
+                throw std::runtime_error("Failed to create window surface!");
 
+            // The images are presented with the same queue as the main window
+            VkBool32 supported = VK_FALSE;
+            vkGetPhysicalDeviceSurfaceSupportKHR(
+                physicalDevice, presentationFamily, target.surface, &supported
+            );
 
-    /********************************* LOGICAL DEVICES **********************************/
+            if (!supported)
+                throw std::runtime_error("Additional window not supported by the presentation queue!");
 
-    void Application::createLogicalDevice()
-    {
-        // Retrieve the indices of the queue families we need from the physical device
-        queueFamilyIndices_t indices = findQueueFamilies(physicalDevice);
+            for (uint32_t j = 0; j < config.nbFramesInFlight; ++j)
+            {
+                if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &target.imageAvailableSemaphores[j]) != VK_SUCCESS)
+                    throw std::runtime_error("Failed to create synchronization objects for an additional window!");
+            }
 
-        // Retrieve the required device extensions
-        auto requiredExtensions = getRequiredDeviceExtensions(physicalDevice);
+            createWindowSwapChain(i);
+        }
+    }
 
-        // Fill structs to request the creation of the queues we need
-        std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-        std::set<uint32_t> uniqueQueueFamilies = {
-            indices.families[GRAPHICS_QUEUE_FAMILY],
-            indices.families[PRESENTATION_QUEUE_FAMILY]
-        };
+    //-----------------------------------------------------------------------
 
-        float queuePriority = 1.0f;
-        for (uint32_t queueFamily : uniqueQueueFamilies)
+    void Application::destroyWindowTargets()
+    {
+        for (uint32_t i = 0; i < windowTargets.size(); ++i)
         {
-            VkDeviceQueueCreateInfo queueCreateInfo{};
-            queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-            queueCreateInfo.queueFamilyIndex = queueFamily;
-            queueCreateInfo.queueCount = 1;
-            queueCreateInfo.pQueuePriorities = &queuePriority;
-            queueCreateInfos.push_back(queueCreateInfo);
-        }
+            windowTarget_t& target = windowTargets[i];
 
-        // Fill a struct to create the logical device, using the above structs
-        VkDeviceCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+            if (target.swapChain != VK_NULL_HANDLE)
+            {
+                onWindowSwapChainAboutToBeDestroyed(i);
 
-        createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
-        createInfo.pQueueCreateInfos = queueCreateInfos.data();
+                for (auto imageView : target.imageViews)
+                    vkDestroyImageView(device, imageView, nullptr);
 
-#ifdef VK_API_VERSION_1_1
-        VkPhysicalDeviceFeatures2 enabledFeatures{};
-        enabledFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
-        enabledFeatures.pNext = &config.features11;
-        memcpy(&enabledFeatures.features, &config.features10, sizeof(VkPhysicalDeviceFeatures));
+                vkDestroySwapchainKHR(device, target.swapChain, nullptr);
+            }
 
-        createInfo.pNext = &enabledFeatures;
-#else
-        createInfo.pEnabledFeatures = &config.features10;
-#endif
+            for (auto semaphore : target.imageAvailableSemaphores)
+            {
+                if (semaphore != VK_NULL_HANDLE)
+                    vkDestroySemaphore(device, semaphore, nullptr);
+            }
 
-        createInfo.enabledExtensionCount = static_cast<uint32_t>(requiredExtensions.size());
-        createInfo.ppEnabledExtensionNames = requiredExtensions.data();
+            if (target.surface != VK_NULL_HANDLE)
+            {
+                clearSurfaceSupport(target.surface);
+                vkDestroySurfaceKHR(instance, target.surface, nullptr);
+            }
 
-        if (enableValidationLayers) {
-            // Not necessarya anymore on current implementations of Vulkan, only
-            // here for backward compatibility
-            createInfo.enabledLayerCount = static_cast<uint32_t>(config.validationLayers.size());
-            createInfo.ppEnabledLayerNames = config.validationLayers.data();
-        } else {
-            createInfo.enabledLayerCount = 0;
+            glfwDestroyWindow(target.window);
         }
 
-        // Create the logical device
-        if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device) != VK_SUCCESS)
-            throw std::runtime_error("Failed to create logical device!");
-
-        // Creates the queue for graphics command
-        vkGetDeviceQueue(device, indices.families[GRAPHICS_QUEUE_FAMILY], 0, &graphicsQueue);
-
-        // Creates the queue for presentation
-        vkGetDeviceQueue(device, indices.families[PRESENTATION_QUEUE_FAMILY], 0, &presentationQueue);
+        windowTargets.clear();
     }
 
+    //-----------------------------------------------------------------------
 
-    /************************************ SWAP CHAIN ************************************/
-
-    void Application::createSwapChain()
+    void Application::createWindowSwapChain(uint32_t windowIndex)
     {
-        // Choose the parameters of the swap chain (surface format, presentation mode,
-        // extent)
-        swapChainSupportDetails_t swapChainSupport = querySwapChainSupport(physicalDevice);
+        windowTarget_t& target = windowTargets[windowIndex];
+
+        // Choose the parameters of the swap chain like for the main window
+        swapChainSupportDetails_t swapChainSupport = querySwapChainSupport(
+            physicalDevice, target.surface
+        );
 
         VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(
             swapChainSupport.formats
@@ -2244,41 +9854,48 @@ namespace vk {
             swapChainSupport.presentationModes
         );
 
-        VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
+        uint32_t imageCount = chooseSwapImageCount(
+            swapChainSupport.capabilities, presentationMode
+        );
 
-        // Determine the number of images in the swap chain
-        uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
-        if ((swapChainSupport.capabilities.maxImageCount > 0) &&
-            (imageCount > swapChainSupport.capabilities.maxImageCount))
+        const VkSurfaceCapabilitiesKHR& capabilities = swapChainSupport.capabilities;
+
+        VkExtent2D extent = capabilities.currentExtent;
+        if (extent.width == std::numeric_limits<uint32_t>::max())
         {
-            imageCount = swapChainSupport.capabilities.maxImageCount;
+            extent.width = std::clamp(
+                static_cast<uint32_t>(target.framebufferWidth.load()),
+                capabilities.minImageExtent.width, capabilities.maxImageExtent.width
+            );
+
+            extent.height = std::clamp(
+                static_cast<uint32_t>(target.framebufferHeight.load()),
+                capabilities.minImageExtent.height, capabilities.maxImageExtent.height
+            );
         }
 
-        // Fill a struct with the creation infos of the swap chain
         VkSwapchainCreateInfoKHR createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-        createInfo.surface = surface;
+        createInfo.surface = target.surface;
         createInfo.minImageCount = imageCount;
         createInfo.imageFormat = surfaceFormat.format;
         createInfo.imageColorSpace = surfaceFormat.colorSpace;
         createInfo.imageExtent = extent;
         createInfo.imageArrayLayers = 1;
-        createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-        createInfo.preTransform = swapChainSupport.capabilities.currentTransform;
+        createInfo.imageUsage = getSwapChainImageUsage(capabilities, surfaceFormat.format);
+        createInfo.preTransform = capabilities.currentTransform;
         createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         createInfo.presentMode = presentationMode;
         createInfo.clipped = VK_TRUE;
-        createInfo.oldSwapchain = VK_NULL_HANDLE;
+        createInfo.oldSwapchain = target.swapChain;
 
-        //-- How to handle swap chain images that will be used across multiple
-        //   queue families (if necessary)
-        queueFamilyIndices_t indices = findQueueFamilies(physicalDevice);
+        auto& families = deviceContext->queueFamilies.families;
         uint32_t queueFamilyIndices[] = {
-            indices.families[GRAPHICS_QUEUE_FAMILY],
-            indices.families[PRESENTATION_QUEUE_FAMILY]
+            families[GRAPHICS_QUEUE_FAMILY],
+            families[PRESENTATION_QUEUE_FAMILY]
         };
 
-        if (indices.families[GRAPHICS_QUEUE_FAMILY] != indices.families[PRESENTATION_QUEUE_FAMILY])
+        if (families[GRAPHICS_QUEUE_FAMILY] != families[PRESENTATION_QUEUE_FAMILY])
         {
             createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
             createInfo.queueFamilyIndexCount = 2;
@@ -2287,203 +9904,102 @@ namespace vk {
         else
         {
             createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-            createInfo.queueFamilyIndexCount = 0; // Optional
-            createInfo.pQueueFamilyIndices = nullptr; // Optional
         }
 
-        // Create the swap chain
-        if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &swapChain) != VK_SUCCESS)
+        if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &target.swapChain) != VK_SUCCESS)
             throw std::runtime_error("Failed to create swap chain!");
 
-        // Retrieve the images of the swap chain
-        vkGetSwapchainImagesKHR(device, swapChain, &imageCount, nullptr);
-        swapChainImages.resize(imageCount);
-        vkGetSwapchainImagesKHR(device, swapChain, &imageCount, swapChainImages.data());
-
-        // Store the extent for later use
-        swapChainExtent = extent;
-    }
-
-    //-----------------------------------------------------------------------
+        // Retrieve the images of the swap chain, and create their views
+        vkGetSwapchainImagesKHR(device, target.swapChain, &imageCount, nullptr);
+        target.images.resize(imageCount);
+        vkGetSwapchainImagesKHR(device, target.swapChain, &imageCount, target.images.data());
 
-    void Application::recreateSwapChain()
-    {
-        // If the window is minimzed, wait for it to be visible again
-        int width = 0, height = 0;
-        glfwGetFramebufferSize(window, &width, &height);
-        while ((width == 0) || (height == 0))
+        target.imageViews.resize(imageCount);
+        for (size_t i = 0; i < imageCount; ++i)
         {
-            glfwGetFramebufferSize(window, &width, &height);
-            glfwWaitEvents();
+            target.imageViews[i] = createImageView(
+                target.images[i], surfaceFormat.format, VK_IMAGE_ASPECT_COLOR_BIT, 1
+            );
         }
 
-        // Wait for the completion of outstanding queue operations for all queues on the device
-        vkDeviceWaitIdle(device);
-
-        cleanupSwapChain();
-
-        createSwapChain();
-        createImageViews();
-        onSwapChainReady();
-    }
-
-    //-----------------------------------------------------------------------
-
-    void Application::cleanupSwapChain()
-    {
-        onSwapChainAboutToBeDestroyed();
-
-        for (auto imageView : swapChainImageViews)
-            vkDestroyImageView(device, imageView, nullptr);
+        target.imageFormat = surfaceFormat.format;
+        target.extent = extent;
 
-        vkDestroySwapchainKHR(device, swapChain, nullptr);
+        onWindowSwapChainReady(windowIndex);
     }
 
     //-----------------------------------------------------------------------
 
-    void Application::createImageViews()
+    void Application::recreateWindowSwapChain(uint32_t windowIndex)
     {
-        swapChainImageViews.resize(swapChainImages.size());
+        windowTarget_t& target = windowTargets[windowIndex];
 
-        for (size_t i = 0; i < swapChainImages.size(); ++i)
+        // Nothing is rendered in a minimized window, try again later
+        if ((target.framebufferWidth == 0) || (target.framebufferHeight == 0))
         {
-            swapChainImageViews[i] = createImageView(
-                swapChainImages[i], surfaceImageFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1
-            );
+            target.outOfDate = true;
+            return;
         }
-    }
 
-    //-----------------------------------------------------------------------
+        // The objects depending on the swap chain might still be used by the frames in
+        // flight: their destruction is deferred, like for the main window
+        retiredSwapChain_t retired;
+        retired.swapChain = target.swapChain;
+        retired.frameNumber = lastSubmittedFrame.load() + 1;
 
-    swapChainSupportDetails_t Application::querySwapChainSupport(VkPhysicalDevice device) const
-    {
-        swapChainSupportDetails_t details;
+        deferringDestructions = true;
 
-        // Retrieve the surface capabilities
-        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilities);
+        onWindowSwapChainAboutToBeDestroyed(windowIndex);
 
-        // Retrieve the supported surface formats
-        uint32_t formatCount;
-        vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, nullptr);
+        destroyWhenRetired([this, imageViews = std::move(target.imageViews)]() {
+            for (auto imageView : imageViews)
+                vkDestroyImageView(device, imageView, nullptr);
+        });
 
-        if (formatCount != 0)
-        {
-            details.formats.resize(formatCount);
-            vkGetPhysicalDeviceSurfaceFormatsKHR(
-                device, surface, &formatCount, details.formats.data()
-            );
-        }
+        deferringDestructions = false;
 
-        // Retrieve the supported presentation modes
-        uint32_t presentationModeCount;
-        vkGetPhysicalDeviceSurfacePresentModesKHR(
-            device, surface, &presentationModeCount, nullptr
-        );
+        target.imageViews.clear();
+        retired.destructors.swap(deferredDestructors);
 
-        if (presentationModeCount != 0) {
-            details.presentationModes.resize(presentationModeCount);
-            vkGetPhysicalDeviceSurfacePresentModesKHR(
-                device, surface, &presentationModeCount, details.presentationModes.data()
-            );
-        }
+        // The old swap chain is passed to its replacement
+        createWindowSwapChain(windowIndex);
 
-        return details;
+        retiredSwapChains.push_back(std::move(retired));
     }
 
     //-----------------------------------------------------------------------
 
-    VkSurfaceFormatKHR Application::chooseSwapSurfaceFormat(
-        const std::vector<VkSurfaceFormatKHR>& availableFormats
-    ) const
+    void Application::acquireWindowImages(uint32_t frameIndex, uint64_t timeout)
     {
-        // Prefer VK_FORMAT_B8G8R8A8_SRGB if it is available
-        for (const auto& availableFormat : availableFormats) {
-            if ((availableFormat.format == VK_FORMAT_B8G8R8A8_SRGB) &&
-                (availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR))
+        for (uint32_t i = 0; i < windowTargets.size(); ++i)
+        {
+            windowTarget_t& target = windowTargets[i];
+            target.imageIndex = UINT32_MAX;
+
+            if (target.outOfDate.exchange(false))
             {
-                return availableFormat;
+                recreateWindowSwapChain(i);
+                if (target.outOfDate)
+                    continue;
             }
-        }
-
-        // Otherwise use the first one of the list
-        return availableFormats[0];
-    }
 
-    //-----------------------------------------------------------------------
+            VkResult result = acquireSwapChainImage(
+                target.swapChain, timeout, target.imageAvailableSemaphores[frameIndex],
+                target.imageIndex
+            );
 
-    VkPresentModeKHR Application::chooseSwapPresentationMode(
-        const std::vector<VkPresentModeKHR>& availablePresentModes
-    ) const
-    {
-        // Prefer VK_PRESENT_MODE_MAILBOX_KHR if it is available
-        for (const auto& availablePresentMode : availablePresentModes) {
-            if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-                return availablePresentMode;
+            if (result == VK_ERROR_OUT_OF_DATE_KHR)
+            {
+                target.outOfDate = true;
+                target.imageIndex = UINT32_MAX;
             }
-        }
-
-        // Otherwise use VK_PRESENT_MODE_FIFO_KHR (which is guaranteed to be
-        // available)
-        return VK_PRESENT_MODE_FIFO_KHR;
-    }
-
-    //-----------------------------------------------------------------------
-
-    VkExtent2D Application::chooseSwapExtent(
-        const VkSurfaceCapabilitiesKHR& capabilities
-    ) const
-    {
-        // Is Vulkan asking for our help here (ie. on a Retina display)?
-        // (see https://vulkan-tutorial.com/en/Drawing_a_triangle/Presentation/Swap_chain#page_Swap-extent)
-        if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max())
-            return capabilities.currentExtent;
-
-        // Retrieve the actual window size in pixels (might be different from
-        // the one in screen coordinates)
-        int width, height;
-        glfwGetFramebufferSize(window, &width, &height);
-
-        VkExtent2D actualExtent = {
-            static_cast<uint32_t>(width),
-            static_cast<uint32_t>(height)
-        };
-
-        // ensure the dimensions are within supported bounds
-        actualExtent.width = std::clamp(
-            actualExtent.width, capabilities.minImageExtent.width,
-            capabilities.maxImageExtent.width
-        );
-
-        actualExtent.height = std::clamp(
-            actualExtent.height, capabilities.minImageExtent.height,
-            capabilities.maxImageExtent.height
-        );
-
-        return actualExtent;
-    }
-
-    //-----------------------------------------------------------------------
-
-    void Application::createSyncObjects()
-    {
-        imageAvailableSemaphores.resize(MAX_NB_FRAMES_IN_FLIGHT);
-        renderFinishedSemaphores.resize(MAX_NB_FRAMES_IN_FLIGHT);
-        inFlightFences.resize(MAX_NB_FRAMES_IN_FLIGHT);
-
-        VkSemaphoreCreateInfo semaphoreInfo{};
-        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-
-        VkFenceCreateInfo fenceInfo{};
-        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-        for (size_t i = 0; i < MAX_NB_FRAMES_IN_FLIGHT; ++i)
-        {
-            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
-                vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS ||
-                vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS)
+            else if ((result == VK_TIMEOUT) || (result == VK_NOT_READY))
             {
-                throw std::runtime_error("Failed to create synchronization objects for a frame!");
+                target.imageIndex = UINT32_MAX;
+            }
+            else if ((result != VK_SUCCESS) && (result != VK_SUBOPTIMAL_KHR))
+            {
+                throw std::runtime_error("Failed to acquire swap chain image!");
             }
         }
     }